@@ -913,7 +913,23 @@ private:
     std::atomic_flag state_updater_running = ATOMIC_FLAG_INIT;
     std::thread state_updater;
 
-    std::map<std::string, int64_t> mExecuteCount_;
+    // smart caches file near database: only blocks after its point are replayed on start
+    struct CachesFile {
+        cs::Sequence sequence = 0;
+        csdb::PoolHash hash;
+        cs::Bytes payload;
+    };
+
+    std::string cachesPath_;
+    // read on construction and restored by run
+    std::optional<CachesFile> cachesFile_;
+    // blocks read from database are not handled if caches file is read,
+    // state updater replays blocks after caches point then
+    bool skipReadBlocks_ = false;
+    // point of the last saved or restored caches
+    cs::Sequence cachesSequence_ = 0;
+
+    cs::SpinLockable<std::map<std::string, int64_t>> mExecuteCount_;
 
     api::SmartContract fetch_smart_body(const csdb::Transaction&);
 
@@ -924,6 +940,9 @@ private:
 
     api::SealedTransaction convertTransaction(const csdb::Transaction& transaction);
 
+    // transaction without user fields is converted from pool binary without creating csdb::Transaction
+    api::SealedTransaction convertTransfer(const csdb::TransactionView& view, const csdb::Pool& pool, size_t index);
+
     std::vector<api::SealedTransaction> convertTransactions(const std::vector<csdb::Transaction>& transactions);
 
     api::Pool convertPool(const csdb::Pool& pool);
@@ -938,6 +957,11 @@ private:
     bool update_smart_caches_once(const csdb::PoolHash&, bool = false);
     void run();
 
+    bool readCaches(CachesFile& file) const;
+    bool restoreCaches(const cs::Bytes& payload);
+    // caches are saved only when all pulled smart transactions are handled, not forced save waits for save interval
+    void saveCaches(bool force);
+
     ::csdb::Transaction make_transaction(const ::api::Transaction&);
     void dumb_transaction_flow(api::TransactionFlowResult& _return, const ::api::Transaction&);
     void smart_transaction_flow(api::TransactionFlowResult& _return, const ::api::Transaction&);
@@ -33,6 +33,8 @@ struct Config {
     int executor_port = 9080;
     int apiexec_port = 9070;
     std::string executor_ip{ "localhost" };
+    // directory of smart caches file, caches are rebuilt from the whole chain on every start if it is empty
+    std::string caches_dir{};
 };
 
 class connector {
@@ -12,6 +12,7 @@
 
 #include <boost/functional/hash.hpp>
 #include <csdb/address.hpp>
+#include <lib/system/common.hpp>
 
 #include <ContractExecutor.h>
 
@@ -87,6 +88,10 @@ public:
 
     static TokenStandart getTokenStandart(const std::vector<::general::MethodDescription>&);
 
+    // tokens are saved only when token thread has no tasks, otherwise false is returned
+    bool saveState(cs::Bytes& data);
+    bool loadState(const cs::Bytes& data);
+
 private:
     void refreshTokenState(const csdb::Address& token, const std::string& newState);
 
@@ -116,6 +121,9 @@ private:
     };
     std::map<csdb::Address, TokenInvocationData> newExecutes_;
 
+    // token thread handles tasks, guarded by cvMut_
+    bool busy_ = false;
+
     std::mutex dataMut_;
     TokensMap tokens_;
     HoldersMap holders_;
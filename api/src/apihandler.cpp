@@ -7,11 +7,26 @@
 #include <src/priv_crypto.hpp>
 #include "csconnector/csconnector.hpp"
 #include "stdafx.h"
+#include <csnode/datastream.hpp>
 #include <csnode/fee.hpp>
+#include <csnode/signaturecache.hpp>
 
 #include <base58.h>
 
+#include <fstream>
+
+#include <boost/filesystem.hpp>
+
 constexpr csdb::user_field_id_t kSmartStateIndex = ~1;
+
+namespace {
+const char* kCachesFileName = "api_caches.dat";
+constexpr uint32_t kCachesMagic = 0x43495041;  // "APIC"
+constexpr uint32_t kCachesVersion = 1;
+
+// caches are saved when updater has handled this count of blocks after the last save
+constexpr cs::Sequence kCachesSaveInterval = 10000;
+}  // namespace
 using namespace api;
 using namespace ::apache;
 
@@ -22,7 +37,7 @@ apiexec::APIEXECHandler::APIEXECHandler(BlockChain& blockchain, cs::SolverCore&
     csunused(config);
 }
 
-APIHandler::APIHandler(BlockChain& blockchain, cs::SolverCore& _solver, executor::Executor& executor, const csconnector::Config&)
+APIHandler::APIHandler(BlockChain& blockchain, cs::SolverCore& _solver, executor::Executor& executor, const csconnector::Config& config)
 : executor_(executor)
 , s_blockchain(blockchain)
 , solver(_solver)
@@ -44,6 +59,16 @@ APIHandler::APIHandler(BlockChain& blockchain, cs::SolverCore& _solver, executor
         firstTime = false;
     }
 #endif
+
+    if (!config.caches_dir.empty()) {
+        cachesPath_ = config.caches_dir + "/" + kCachesFileName;
+
+        CachesFile file;
+        if (readCaches(file)) {
+            cachesFile_ = std::move(file);
+            skipReadBlocks_ = true;
+        }
+    }
 }
 
 void APIHandler::run() {
@@ -51,6 +76,26 @@ void APIHandler::run() {
         return;
     }
 
+    if (cachesFile_.has_value()) {
+        // blocks of database were not handled, so they are replayed from the caches point or from the start
+        if (s_blockchain.getHashBySequence(cachesFile_->sequence) != cachesFile_->hash) {
+            cswarning() << "API: caches file " << cachesPath_ << " doesn't match the chain, all blocks are replayed";
+        }
+        else if (!restoreCaches(cachesFile_->payload)) {
+            cswarning() << "API: caches file " << cachesPath_ << " is not parsed, all blocks are replayed";
+        }
+        else {
+            auto locked_pending_smart_transactions = lockedReference(this->pending_smart_transactions);
+            locked_pending_smart_transactions->last_pull_hash = cachesFile_->hash;
+            locked_pending_smart_transactions->last_pull_sequence = cachesFile_->sequence;
+
+            cachesSequence_ = cachesFile_->sequence;
+            cslog() << "API: smart caches are restored up to block #" << cachesSequence_;
+        }
+
+        cachesFile_.reset();
+    }
+
 #ifdef MONITOR_NODE
     stats.run(stats_);
 #endif
@@ -66,6 +111,8 @@ APIHandler::~APIHandler() {
     if (state_updater.joinable()) {
         state_updater.join();
     }
+
+    saveCaches(true);
 }
 
 template <typename ResultType>
@@ -83,6 +130,8 @@ void APIHandler::state_updater_work_function() {
         auto lasthash = s_blockchain.getLastHash();
         while (state_updater_running.test_and_set(std::memory_order_acquire)) {
             if (!update_smart_caches_once(lasthash)) {
+                saveCaches(false);
+
                 {
                     std::unique_lock lk(dbLock_);
                     newBlockCv_.wait(lk);
@@ -445,6 +494,33 @@ api::SealedTransaction APIHandler::convertTransaction(const csdb::Transaction& t
     return result;
 }
 
+api::SealedTransaction APIHandler::convertTransfer(const csdb::TransactionView& view, const csdb::Pool& pool, size_t index) {
+    auto toPublicKey = [this](const csdb::AddressView& address) {
+        if (!address.is_wallet_id()) {
+            return address.public_key();
+        }
+        BlockChain::WalletData data_to_fetch_pulic_key;
+        s_blockchain.findWalletData(address.wallet_id(), data_to_fetch_pulic_key);
+        return data_to_fetch_pulic_key.address_;
+    };
+
+    api::SealedTransaction result;
+    result.id = convert_transaction_id(csdb::TransactionID(pool.hash(), index));
+    result.__isset.id = true;
+    result.__isset.trxn = true;
+    result.trxn.id = view.innerID();
+    result.trxn.amount = convertAmount(view.amount());
+    result.trxn.currency = DEFAULT_CURRENCY;
+    result.trxn.source = fromByteArray(toPublicKey(view.source()));
+    result.trxn.target = fromByteArray(toPublicKey(view.target()));
+    result.trxn.fee.commission = csdb::AmountCommission(view.counted_fee()).get_raw();
+    result.trxn.timeCreation = pool.get_time();
+    result.trxn.poolNumber = pool.sequence();
+    result.trxn.type = api::TransactionType::TT_Normal;
+
+    return result;
+}
+
 std::vector<api::SealedTransaction> APIHandler::convertTransactions(const std::vector<csdb::Transaction>& transactions) {
     std::vector<api::SealedTransaction> result;
     result.resize(transactions.size());
@@ -483,9 +559,8 @@ api::Pool APIHandler::convertPool(const csdb::Pool& pool) {
         result.writer = fromByteArray(cs::Bytes(wpk.begin(), wpk.end()));
 
         double totalFee = 0;
-        const auto& transs = const_cast<csdb::Pool&>(pool).transactions();
-        for (auto& t : transs)
-            totalFee += t.counted_fee().to_double();
+        for (const auto& view : pool.transaction_views())
+            totalFee += view.counted_fee().to_double();
 
         const auto tf = csdb::Amount(totalFee);
         result.totalFee.integral = tf.integral();
@@ -507,8 +582,18 @@ std::vector<api::SealedTransaction> APIHandler::extractTransactions(const csdb::
     transactionsCount -= offset;  // мы можем отдать все транзакции в пуле за вычетом смещения
     if (limit > transactionsCount)
         limit = transactionsCount;  // лимит уменьшается до реального количества // транзакций которые можно отдать
+    const auto views = pool.transaction_views();
     for (int64_t index = offset; index < (offset + limit); ++index) {
-        result.push_back(convertTransaction(pool.transaction(index)));
+        const auto i = static_cast<size_t>(index);
+        if (i < views.size() && views[i].user_fields_count() == 0) {
+            result.push_back(convertTransfer(views[i], pool, i));
+        }
+        else if (i < views.size()) {
+            result.push_back(convertTransaction(pool.transaction(views[i], i)));
+        }
+        else {
+            result.push_back(convertTransaction(pool.transaction(index)));
+        }
     }
     return result;
 }
@@ -667,8 +752,7 @@ void APIHandler::dumb_transaction_flow(api::TransactionFlowResult& _return, cons
 
     // check signature
     const auto byteStream = tr.to_byte_stream_for_sig();
-    if (!cscrypto::verifySignature(tr.signature(), s_blockchain.getAddressByType(tr.source(), BlockChain::AddressType::PublicKey).public_key(), byteStream.data(),
-                                   byteStream.size())) {
+    if (!cs::SignatureCache::instance().verify(tr.signature(), s_blockchain.getAddressByType(tr.source(), BlockChain::AddressType::PublicKey).public_key(), byteStream)) {
         cslog() << "API: reject transaction with wrong signature";
         _return.status.code = ERROR_CODE;
         _return.status.message = "wrong signature! ByteStream: " + cs::Utils::byteStreamToHex(fromByteArray(byteStream));
@@ -740,8 +824,8 @@ void APIHandler::smart_transaction_flow(api::TransactionFlowResult& _return, con
 
         // check signature
         const auto byteStream = send_transaction.to_byte_stream_for_sig();
-        if (!cscrypto::verifySignature(send_transaction.signature(), s_blockchain.getAddressByType(send_transaction.source(), BlockChain::AddressType::PublicKey).public_key(),
-                                       byteStream.data(), byteStream.size())) {
+        if (!cs::SignatureCache::instance().verify(send_transaction.signature(),
+                                                   s_blockchain.getAddressByType(send_transaction.source(), BlockChain::AddressType::PublicKey).public_key(), byteStream)) {
             _return.status.code = ERROR_CODE;
             cslog() << "API: reject transaction with wrong signature";
             _return.status.message = "wrong signature! ByteStream: " + cs::Utils::byteStreamToHex(fromByteArray(byteStream));
@@ -1070,7 +1154,7 @@ void APIHandler::collect_all_stats_slot(const csdb::Pool& pool) {
 //
 
 void APIHandler::update_smart_caches_slot(const csdb::Pool& pool) {
-    if (!pool.is_valid()) {
+    if (!pool.is_valid() || skipReadBlocks_) {
         return;
     }
     auto locked_pending_smart_transactions = lockedReference(this->pending_smart_transactions);
@@ -1111,7 +1195,7 @@ void APIHandler::update_smart_caches_slot(const csdb::Pool& pool) {
             if (execTrans.is_valid() && is_smart(execTrans)) {
                 const auto smart = fetch_smart(execTrans);
                 if(!smart.method.empty()) {
-                    mExecuteCount_[smart.method]++;
+                    (*lockedReference(this->mExecuteCount_))[smart.method]++;
                 }
 
                 {
@@ -1318,7 +1402,7 @@ bool APIHandler::update_smart_caches_once(const csdb::PoolHash& start, bool init
                 const auto smart = fetch_smart(execTrans);
 
                 if (!smart.method.empty()) {
-                    mExecuteCount_[smart.method]++;
+                    (*lockedReference(this->mExecuteCount_))[smart.method]++;
                 }
 
                 {
@@ -1388,9 +1472,10 @@ bool APIHandler::update_smart_caches_once(const csdb::PoolHash& start, bool init
                     (*locked_deployed_by_creator)[source_pk].push_back(tr.id().clone());
                 }
             }
-
-            return true;
         }
+
+        // the next queued transaction is handled without waiting for a new block
+        return true;
     }
     else {
         auto sp = lockedReference(this->smarts_pending);
@@ -1412,6 +1497,292 @@ bool APIHandler::update_smart_caches_once(const csdb::PoolHash& start, bool init
     return false;
 }
 
+bool APIHandler::readCaches(CachesFile& file) const {
+    std::ifstream input(cachesPath_, std::ios::binary);
+
+    if (!input) {
+        return false;
+    }
+
+    const cs::Bytes data{std::istreambuf_iterator<char>(input), std::istreambuf_iterator<char>()};
+    cs::DataStream stream(data.data(), data.size());
+
+    uint32_t magic = 0;
+    uint32_t version = 0;
+    cs::Hash payloadHash{};
+    size_t payloadSize = 0;
+
+    stream >> magic >> version >> file.sequence >> file.hash >> payloadHash >> payloadSize;
+
+    if (!stream.isValid() || magic != kCachesMagic || version != kCachesVersion) {
+        cswarning() << "API: caches file " << cachesPath_ << " is not compatible";
+        return false;
+    }
+
+    if (stream.size() != payloadSize) {
+        cswarning() << "API: caches file " << cachesPath_ << " is truncated";
+        return false;
+    }
+
+    const auto payloadPtr = reinterpret_cast<const uint8_t*>(stream.data());
+    file.payload.assign(payloadPtr, payloadPtr + payloadSize);
+
+    if (cscrypto::calculateHash(file.payload.data(), file.payload.size()) != payloadHash) {
+        cswarning() << "API: caches file " << cachesPath_ << " is corrupted";
+        return false;
+    }
+
+    return true;
+}
+
+bool APIHandler::restoreCaches(const cs::Bytes& payload) {
+    // everything is parsed to temporary caches first not to spoil real ones by broken file
+    cs::DataStream stream(payload.data(), payload.size());
+
+    std::map<csdb::Address, csdb::TransactionID> smartOrigin;
+    std::map<csdb::Address, smart_state_entry> smartState;
+    std::map<csdb::Address, smart_trxns_queue> smartLastTrxn;
+    std::map<csdb::Address, std::vector<csdb::TransactionID>> deployedByCreator;
+    std::map<csdb::TransactionID, SmartOperation> smartOperations;
+    std::map<cs::Sequence, std::vector<csdb::TransactionID>> smartsPending;
+    std::map<std::string, int64_t> executeCount;
+    cs::Bytes tokens;
+
+    size_t size = 0;
+    stream >> size;
+
+    for (size_t i = 0; i < size && stream.isValid(); ++i) {
+        csdb::Address address;
+        csdb::TransactionID id;
+        stream >> address >> id;
+
+        smartOrigin.emplace(address, id);
+    }
+
+    stream >> size;
+
+    for (size_t i = 0; i < size && stream.isValid(); ++i) {
+        csdb::Address address;
+        SmartState state;
+        uint8_t lastEmpty = 0;
+        stream >> address >> state.state >> lastEmpty >> state.transaction >> state.initer;
+
+        state.lastEmpty = lastEmpty;
+        smartState[address].updateState([&](const SmartState&) { return state; });
+    }
+
+    stream >> size;
+
+    for (size_t i = 0; i < size && stream.isValid(); ++i) {
+        csdb::Address address;
+        std::vector<csdb::TransactionID> ids;
+        stream >> address >> ids;
+
+        auto& queue = smartLastTrxn[address].trid_queue;
+        queue.assign(ids.begin(), ids.end());
+    }
+
+    stream >> size;
+
+    for (size_t i = 0; i < size && stream.isValid(); ++i) {
+        csdb::Address address;
+        std::vector<csdb::TransactionID> ids;
+        stream >> address >> ids;
+
+        deployedByCreator.emplace(address, std::move(ids));
+    }
+
+    stream >> size;
+
+    for (size_t i = 0; i < size && stream.isValid(); ++i) {
+        csdb::TransactionID id;
+        uint8_t state = 0;
+        uint8_t flags = 0;
+        SmartOperation operation;
+        stream >> id >> state >> operation.stateTransaction >> flags;
+
+        operation.state = static_cast<SmartOperation::State>(state);
+        operation.hasRetval = flags & 1;
+        operation.returnsBool = flags & 2;
+        operation.boolResult = flags & 4;
+
+        smartOperations.emplace(id, operation);
+    }
+
+    stream >> size;
+
+    for (size_t i = 0; i < size && stream.isValid(); ++i) {
+        cs::Sequence sequence = 0;
+        std::vector<csdb::TransactionID> ids;
+        stream >> sequence >> ids;
+
+        smartsPending.emplace(sequence, std::move(ids));
+    }
+
+    stream >> size;
+
+    for (size_t i = 0; i < size && stream.isValid(); ++i) {
+        std::string method;
+        int64_t count = 0;
+        stream >> method >> count;
+
+        executeCount.emplace(std::move(method), count);
+    }
+
+    stream >> tokens;
+
+    if (!stream.isValid() || stream.size() != 0 || !tm.loadState(tokens)) {
+        return false;
+    }
+
+    for (const auto& [address, id] : smartOrigin) {
+        executor_.updateDeployTrxns(address, id);
+    }
+
+    lockedReference(this->smart_origin)->swap(smartOrigin);
+    lockedReference(this->smart_state)->swap(smartState);
+    lockedReference(this->smart_last_trxn)->swap(smartLastTrxn);
+    lockedReference(this->deployed_by_creator)->swap(deployedByCreator);
+    lockedReference(this->smart_operations)->swap(smartOperations);
+    lockedReference(this->smarts_pending)->swap(smartsPending);
+    lockedReference(this->mExecuteCount_)->swap(executeCount);
+
+    return true;
+}
+
+void APIHandler::saveCaches(bool force) {
+    if (cachesPath_.empty()) {
+        return;
+    }
+
+    // caches match the last pulled block only when all its smart transactions are handled;
+    // the lock is kept until caches are serialized not to let the next block in, it is taken first as in update slot
+    auto locked_pending_smart_transactions = lockedReference(this->pending_smart_transactions);
+    if (!locked_pending_smart_transactions->queue.empty()) {
+        return;
+    }
+
+    const cs::Sequence sequence = locked_pending_smart_transactions->last_pull_sequence;
+    const csdb::PoolHash hash = locked_pending_smart_transactions->last_pull_hash;
+
+    if (hash.is_empty() || sequence <= cachesSequence_ || (!force && sequence < cachesSequence_ + kCachesSaveInterval)) {
+        return;
+    }
+
+    cs::Bytes tokens;
+
+    if (!tm.saveState(tokens)) {
+        csdebug() << "API: tokens are being updated, caches are saved later";
+        return;
+    }
+
+    cs::Bytes payload;
+    cs::DataStream stream(payload);
+
+    {
+        auto locked_smart_origin = lockedReference(this->smart_origin);
+        stream << locked_smart_origin->size();
+
+        for (const auto& [address, id] : *locked_smart_origin) {
+            stream << address << id;
+        }
+    }
+
+    {
+        auto locked_smart_state = lockedReference(this->smart_state);
+        stream << locked_smart_state->size();
+
+        for (const auto& [address, entry] : *locked_smart_state) {
+            const SmartState state = entry.getState();
+            stream << address << state.state << static_cast<uint8_t>(state.lastEmpty) << state.transaction << state.initer;
+        }
+    }
+
+    {
+        auto locked_smart_last_trxn = lockedReference(this->smart_last_trxn);
+        stream << locked_smart_last_trxn->size();
+
+        for (auto& [address, entry] : *locked_smart_last_trxn) {
+            std::unique_lock lock(entry.lock);
+            stream << address << std::vector<csdb::TransactionID>(entry.trid_queue.begin(), entry.trid_queue.end());
+        }
+    }
+
+    {
+        auto locked_deployed_by_creator = lockedReference(this->deployed_by_creator);
+        stream << locked_deployed_by_creator->size();
+
+        for (const auto& [address, ids] : *locked_deployed_by_creator) {
+            stream << address << ids;
+        }
+    }
+
+    {
+        auto locked_smart_operations = lockedReference(this->smart_operations);
+        stream << locked_smart_operations->size();
+
+        for (const auto& [id, operation] : *locked_smart_operations) {
+            const uint8_t flags = uint8_t(operation.hasRetval) | uint8_t(operation.returnsBool << 1) | uint8_t(operation.boolResult << 2);
+            stream << id << static_cast<uint8_t>(operation.state) << operation.stateTransaction << flags;
+        }
+    }
+
+    {
+        auto locked_smarts_pending = lockedReference(this->smarts_pending);
+        stream << locked_smarts_pending->size();
+
+        for (const auto& [pendingSequence, ids] : *locked_smarts_pending) {
+            stream << pendingSequence << ids;
+        }
+    }
+
+    {
+        auto locked_execute_count = lockedReference(this->mExecuteCount_);
+        stream << locked_execute_count->size();
+
+        for (const auto& [method, count] : *locked_execute_count) {
+            stream << method << count;
+        }
+    }
+
+    stream << tokens;
+
+    {
+        // caches are serialized, so the next block may be handled while the file is written
+        auto released = std::move(locked_pending_smart_transactions);
+    }
+
+    cs::Bytes header;
+    cs::DataStream headerStream(header);
+
+    headerStream << kCachesMagic << kCachesVersion << sequence << hash;
+    headerStream << cscrypto::calculateHash(payload.data(), payload.size()) << payload.size();
+
+    const std::string tmpPath = cachesPath_ + ".tmp";
+
+    {
+        std::ofstream file(tmpPath, std::ios::binary | std::ios::trunc);
+        file.write(reinterpret_cast<const char*>(header.data()), static_cast<std::streamsize>(header.size()));
+        file.write(reinterpret_cast<const char*>(payload.data()), static_cast<std::streamsize>(payload.size()));
+
+        if (!file) {
+            cserror() << "API: couldn't write caches file " << tmpPath;
+            return;
+        }
+    }
+
+    boost::system::error_code code;
+    boost::filesystem::rename(tmpPath, cachesPath_, code);
+
+    if (code) {
+        cserror() << "API: couldn't save caches file " << cachesPath_ << ": " << code.message();
+        return;
+    }
+
+    cachesSequence_ = sequence;
+    csdebug() << "API: smart caches of block #" << sequence << " are saved";
+}
+
 template <typename Mapper>
 size_t APIHandler::getMappedDeployerSmart(const csdb::Address& deployer, Mapper mapper, std::vector<decltype(mapper(api::SmartContract()))>& out) {
     auto locked_deployed_by_creator = lockedReference(this->deployed_by_creator);
@@ -1567,16 +1938,13 @@ void APIHandler::TransactionsStateGet(TransactionsStateGetResult& _return, const
         else {
             cs::Conveyer& conveyer = cs::Conveyer::instance();
             auto lock = conveyer.lock();
-            for (decltype(auto) it : conveyer.packetQueue()) {
-                const auto& transactions = it.transactions();
-                for (decltype(auto) transaction : transactions) {
-                    if (transaction.innerID() == inner_id) {
-                        _return.states[inner_id] = INPROGRESS;
-                        finish_for_idx = true;
-                        break;
-                    }
+            conveyer.packetQueue().forEachTransaction([&](const csdb::Transaction& transaction) {
+                if (transaction.innerID() == inner_id) {
+                    _return.states[inner_id] = INPROGRESS;
+                    finish_for_idx = true;
                 }
-            }
+                return !finish_for_idx;
+            });
             if (!finish_for_idx) {
                 decltype(auto) m_hash_tb = conveyer.transactionsPacketTable();  // find in hash table
                 for (decltype(auto) it : m_hash_tb) {
@@ -1883,7 +2251,9 @@ void APIHandler::SmartContractDataGet(api::SmartContractDataResult& _return, con
 }
 
 void APIHandler::ExecuteCountGet(ExecuteCountGetResult& _return, const std::string& executeMethod) {
-    if (auto itCount = mExecuteCount_.find(executeMethod); itCount != mExecuteCount_.end()) {
+    auto locked_execute_count = lockedReference(this->mExecuteCount_);
+
+    if (auto itCount = locked_execute_count->find(executeMethod); itCount != locked_execute_count->end()) {
         _return.executeCount = itCount->second;
         SetResponseStatus(_return.status, APIRequestStatusType::SUCCESS);
     }
@@ -2220,41 +2590,6 @@ void APIHandler::TokensListGet(api::TokensListResult& _return, int64_t offset, i
 }
 
 //////////Wallets
-typedef std::list<std::pair<const cs::WalletsCache::WalletData::Address*, const cs::WalletsCache::WalletData*>> WCSortedList;
-template <typename T>
-void walletStep(const cs::WalletsCache::WalletData::Address* addr, const cs::WalletsCache::WalletData* wd, const uint64_t num,
-                std::function<const T&(const cs::WalletsCache::WalletData&)> getter, std::function<bool(const T&, const T&)> comparator, WCSortedList& lst) {
-    assert(num > 0);
-
-    const T& val = getter(*wd);
-    if (lst.size() < num || comparator(val, getter(*(lst.back().second)))) {
-        // Guess why I can't use std::upper_bound in here
-        // C++ is not as expressive as I've imagined it to be...
-        auto it = lst.begin();
-        while (it != lst.end() && !comparator(val, getter(*(it->second)))) {/* <-- this looks more like Lisp, doesn't it... */
-            ++it;
-        }
-
-        lst.insert(it, std::make_pair(addr, wd));
-        if (lst.size() > num) {
-            lst.pop_back();
-        }
-    }
-}
-
-template <typename T>
-void iterateOverWallets(std::function<const T&(const cs::WalletsCache::WalletData&)> getter, const uint64_t num, const bool desc, WCSortedList& lst, BlockChain& bc) {
-    using Comparer = std::function<bool(const T&, const T&)>;
-    Comparer comparator = desc ? Comparer(std::greater<T>()) : Comparer(std::less<T>());
-
-    bc.iterateOverWallets([&lst, num, getter, comparator](const cs::WalletsCache::WalletData::Address& addr, const cs::WalletsCache::WalletData& wd) {
-        if (!addr.empty() && wd.balance_ >= csdb::Amount(0)) {
-            walletStep(&addr, &wd, num, getter, comparator, lst);
-        }
-        return true;
-    });
-}
-
 void APIHandler::WalletsGet(WalletsGetResult& _return, int64_t _offset, int64_t _limit, int8_t _ordCol, bool _desc) {
     if (!validatePagination(_return, *this, _offset, _limit)) {
         return;
@@ -2262,37 +2597,28 @@ void APIHandler::WalletsGet(WalletsGetResult& _return, int64_t _offset, int64_t
 
     SetResponseStatus(_return.status, APIRequestStatusType::SUCCESS);
 
-    WCSortedList lst;
-    const uint64_t num = _offset + _limit;
+    // pages are taken from ranking maintained by wallets cache, so no wallets scan is required
+    auto order = cs::WalletsRanking::Order::Balance;
 
-    if (_ordCol == 0) {  // Balance
-        iterateOverWallets<csdb::Amount>([](const cs::WalletsCache::WalletData& wd) -> const csdb::Amount& { return wd.balance_; }, num, _desc, lst, s_blockchain);
+    if (_ordCol == 1) {  // TimeReg
+        order = cs::WalletsRanking::Order::CreateTime;
     }
-#ifdef MONITOR_NODE
-    else if (_ordCol == 1) {  // TimeReg
-        iterateOverWallets<uint64_t>([](const cs::WalletsCache::WalletData& wd) -> const uint64_t& { return wd.createTime_; }, num, _desc, lst, s_blockchain);
-    }
-    else {  // Tx count
-        iterateOverWallets<uint64_t>([](const cs::WalletsCache::WalletData& wd) -> const uint64_t& { return wd.transNum_; }, num, _desc, lst, s_blockchain);
-    }
-#endif
-
-    if (lst.size() < (uint64_t)_offset) {
-        return;
+    else if (_ordCol != 0) {  // Tx count
+        order = cs::WalletsRanking::Order::TransactionsCount;
     }
 
-    auto ptr = lst.begin();
-    std::advance(ptr, _offset);
+    std::vector<cs::WalletsCache::WalletData> wallets;
+    s_blockchain.getRankedWallets(order, _desc, static_cast<uint64_t>(_offset), static_cast<uint64_t>(_limit), wallets);
 
-    for (; ptr != lst.end(); ++ptr) {
+    for (const auto& wallet : wallets) {
         api::WalletInfo wi;
-        const cs::Bytes addr_b((*(ptr->first)).begin(), (*(ptr->first)).end());
+        const cs::Bytes addr_b(wallet.address_.begin(), wallet.address_.end());
         wi.address = fromByteArray(addr_b);
-        wi.balance.integral = ptr->second->balance_.integral();
-        wi.balance.fraction = ptr->second->balance_.fraction();
+        wi.balance.integral = wallet.balance_.integral();
+        wi.balance.fraction = wallet.balance_.fraction();
 #ifdef MONITOR_NODE
-        wi.transactionsNumber = ptr->second->transNum_;
-        wi.firstTransactionTime = ptr->second->createTime_;
+        wi.transactionsNumber = wallet.transNum_;
+        wi.firstTransactionTime = wallet.createTime_;
 #endif
 
         _return.wallets.push_back(wi);
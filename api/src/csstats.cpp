@@ -45,8 +45,22 @@ StatsPerPeriod csstats::collectStats(const Periods& periods) {
             std::size_t transactionsCount = pool.transactions_count();
             periodStats.transactionsCount += static_cast<uint32_t>(transactionsCount);
 
+            auto addAmount = [this, &periodStats](const csdb::Currency& currencyId, const csdb::Amount& amount) {
+                Currency currency = currencies_indexed[currencyId.to_string()];
+                periodStats.balancePerCurrency[currency].integral += amount.integral();
+                periodStats.balancePerCurrency[currency].fraction += amount.fraction();
+            };
+
+            const auto views = pool.transaction_views();
+
             for (std::size_t i = 0; i < transactionsCount; ++i) {
-                const auto& transaction = pool.transaction(csdb::TransactionID(pool.hash(), i));
+                // plain transfers are neither smart nor deploy, so they are not decoded at all
+                if (i < views.size() && views[i].user_fields_count() == 0) {
+                    addAmount(csdb::Currency(views[i].currency_id()), views[i].amount());
+                    continue;
+                }
+
+                const auto transaction = i < views.size() ? pool.transaction(views[i], i) : pool.transaction(csdb::TransactionID(pool.hash(), i));
 #ifdef MONITOR_NODE
                 if (is_smart(transaction) || is_smart_state(transaction))
                     ++periodStats.transactionsSmartCount;
@@ -54,10 +68,7 @@ StatsPerPeriod csstats::collectStats(const Periods& periods) {
                 if (is_deploy_transaction(transaction))
                     ++periodStats.smartContractsCount;
 
-                Currency currency = currencies_indexed[transaction.currency().to_string()];
-                const auto& amount = transaction.amount();
-                periodStats.balancePerCurrency[currency].integral += amount.integral();
-                periodStats.balancePerCurrency[currency].fraction += amount.fraction();
+                addAmount(transaction.currency(), transaction.amount());
             }
             blockHash = pool.previous_hash();
         }
@@ -1,4 +1,5 @@
 #include <client/params.hpp>
+#include <csnode/datastream.hpp>
 
 #include <base58.h>
 
@@ -331,6 +332,8 @@ void TokensMaster::run() {
     tokThread_ = std::thread([this]() {
         while (running_.load()) {
             std::unique_lock<std::mutex> l(cvMut_);
+            busy_ = true;
+
             while (!deployQueue_.empty()) {
                 DeployTask dt = std::move(deployQueue_.front());
                 deployQueue_.pop();
@@ -396,6 +399,7 @@ void TokensMaster::run() {
             }
 
             l.lock();
+            busy_ = false;
             tokCv_.wait(l);
         }
     });
@@ -443,6 +447,74 @@ void TokensMaster::applyToInternal(const std::function<void(const TokensMap&, co
     func(tokens_, holders_);
 }
 
+bool TokensMaster::saveState(cs::Bytes& data) {
+    {
+        std::lock_guard<decltype(cvMut_)> l(cvMut_);
+        if (busy_ || !deployQueue_.empty() || !newExecutes_.empty()) {
+            return false;
+        }
+    }
+
+    std::lock_guard<decltype(dataMut_)> l(dataMut_);
+    cs::DataStream stream(data);
+    stream << tokens_.size();
+
+    for (const auto& [address, token] : tokens_) {
+        stream << address << static_cast<uint8_t>(token.standart) << token.owner << token.name << token.symbol << token.totalSupply;
+        stream << token.transactionsCount << token.transfersCount << token.realHoldersCount << token.holders.size();
+
+        for (const auto& [holder, info] : token.holders) {
+            stream << holder << info.balance << info.transfersCount;
+        }
+    }
+
+    return true;
+}
+
+bool TokensMaster::loadState(const cs::Bytes& data) {
+    cs::DataStream stream(data.data(), data.size());
+
+    TokensMap tokens;
+    HoldersMap holders;
+
+    size_t size = 0;
+    stream >> size;
+
+    for (size_t i = 0; i < size && stream.isValid(); ++i) {
+        TokenId address;
+        Token token;
+        uint8_t standart = 0;
+        size_t holdersCount = 0;
+
+        stream >> address >> standart >> token.owner >> token.name >> token.symbol >> token.totalSupply;
+        stream >> token.transactionsCount >> token.transfersCount >> token.realHoldersCount >> holdersCount;
+
+        token.standart = static_cast<TokenStandart>(standart);
+
+        for (size_t j = 0; j < holdersCount && stream.isValid(); ++j) {
+            HolderKey holder;
+            Token::HolderInfo info;
+            stream >> holder >> info.balance >> info.transfersCount;
+
+            // holders map is the reverse index of token holders, see initiateHolder
+            holders[holder].insert(address);
+            token.holders.emplace(holder, std::move(info));
+        }
+
+        tokens.emplace(address, std::move(token));
+    }
+
+    if (!stream.isValid() || stream.size() != 0) {
+        return false;
+    }
+
+    std::lock_guard<decltype(dataMut_)> l(dataMut_);
+    tokens_ = std::move(tokens);
+    holders_ = std::move(holders);
+
+    return true;
+}
+
 bool TokensMaster::isTransfer(const std::string& method, const std::vector<general::Variant>& params) {
     return isNormalTransfer(method, params) || isTransferFrom(method, params);
 }
@@ -487,6 +559,12 @@ void TokensMaster::checkNewState(const csdb::Address&, const csdb::Address&, con
 }
 void TokensMaster::applyToInternal(const std::function<void(const TokensMap&, const HoldersMap&)>) {
 }
+bool TokensMaster::saveState(cs::Bytes&) {
+    return true;
+}
+bool TokensMaster::loadState(const cs::Bytes&) {
+    return true;
+}
 bool TokensMaster::isTransfer(const std::string&, const std::vector<general::Variant>&) {
     return false;
 }
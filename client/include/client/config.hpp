@@ -151,6 +151,44 @@ public:
         return alwaysExecuteContracts_;
     }
 
+    // api smart caches are saved to file near database and restored from it instead of backward chain walk
+    bool persistApiCaches() const {
+        return persistApiCaches_;
+    }
+
+    // blocks are written to db by groups in background, 0 means each block is written immediately
+    size_t getGroupCommitBlocks() const {
+        return groupCommitBlocks_;
+    }
+
+    size_t getGroupCommitBytes() const {
+        return groupCommitBytes_;
+    }
+
+    // datagrams read by one recvmmsg call on linux, 1 means one receive call per datagram
+    size_t getReceiveBatchSize() const {
+        return receiveBatchSize_;
+    }
+
+    static constexpr size_t MaxReceiveBatchSize = 256;
+
+    // network fragment size this node accepts and sends to neighbours which accept it too
+    uint32_t getPacketSize() const {
+        return packetSize_;
+    }
+
+    // UDP_SEGMENT / UDP_GRO kernel segmentation on linux
+    bool useUdpOffload() const {
+        return udpOffload_;
+    }
+
+    // reader threads with own sockets bound to input port by SO_REUSEPORT on linux
+    size_t getReceiveShards() const {
+        return receiveShards_;
+    }
+
+    static constexpr size_t MaxReceiveShards = 16;
+
 private:
     static Config readFromFile(const std::string& fileName);
     void setLoggerSettings(const boost::property_tree::ptree& config);
@@ -198,6 +236,13 @@ private:
     ApiData apiData_;
 
     bool alwaysExecuteContracts_ = false;
+    bool persistApiCaches_ = false;
+    size_t groupCommitBlocks_ = 0;
+    size_t groupCommitBytes_ = 0;
+    size_t receiveBatchSize_ = 32;
+    uint32_t packetSize_ = 1024;
+    bool udpOffload_ = false;
+    size_t receiveShards_ = 1;
 };
 
 #endif  // CONFIG_HPP
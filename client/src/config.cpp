@@ -66,6 +66,13 @@ const std::string ARG_NAME_PRIVATE_KEY_FILE = "private-key-file";
 const std::string ARG_NAME_ENCRYPT_KEY_FILE = "encryptkey";
 
 const std::string PARAM_NAME_ALWAYS_EXECUTE_CONTRACTS = "always_execute_contracts";
+const std::string PARAM_NAME_API_CACHES = "api_caches";
+const std::string PARAM_NAME_GROUP_COMMIT_BLOCKS = "group_commit_blocks";
+const std::string PARAM_NAME_GROUP_COMMIT_BYTES = "group_commit_bytes";
+const std::string PARAM_NAME_RECEIVE_BATCH_SIZE = "receive_batch_size";
+const std::string PARAM_NAME_PACKET_SIZE = "packet_size";
+const std::string PARAM_NAME_UDP_OFFLOAD = "udp_offload";
+const std::string PARAM_NAME_RECEIVE_SHARDS = "receive_shards";
 
 const uint32_t MIN_PASSWORD_LENGTH = 3;
 const uint32_t MAX_PASSWORD_LENGTH = 128;
@@ -708,6 +715,34 @@ Config Config::readFromFile(const std::string& fileName) {
             result.alwaysExecuteContracts_ = params.get<bool>(PARAM_NAME_ALWAYS_EXECUTE_CONTRACTS);
         }
 
+        if (params.count(PARAM_NAME_API_CACHES) > 0) {
+            result.persistApiCaches_ = params.get<bool>(PARAM_NAME_API_CACHES);
+        }
+
+        if (params.count(PARAM_NAME_GROUP_COMMIT_BLOCKS) > 0) {
+            result.groupCommitBlocks_ = params.get<size_t>(PARAM_NAME_GROUP_COMMIT_BLOCKS);
+        }
+
+        if (params.count(PARAM_NAME_GROUP_COMMIT_BYTES) > 0) {
+            result.groupCommitBytes_ = params.get<size_t>(PARAM_NAME_GROUP_COMMIT_BYTES);
+        }
+
+        if (params.count(PARAM_NAME_RECEIVE_BATCH_SIZE) > 0) {
+            result.receiveBatchSize_ = params.get<size_t>(PARAM_NAME_RECEIVE_BATCH_SIZE);
+        }
+
+        if (params.count(PARAM_NAME_PACKET_SIZE) > 0) {
+            result.packetSize_ = params.get<uint32_t>(PARAM_NAME_PACKET_SIZE);
+        }
+
+        if (params.count(PARAM_NAME_UDP_OFFLOAD) > 0) {
+            result.udpOffload_ = params.get<bool>(PARAM_NAME_UDP_OFFLOAD);
+        }
+
+        if (params.count(PARAM_NAME_RECEIVE_SHARDS) > 0) {
+            result.receiveShards_ = params.get<size_t>(PARAM_NAME_RECEIVE_SHARDS);
+        }
+
         result.setLoggerSettings(config);
         result.readPoolSynchronizerData(config);
         result.readApiData(config);
@@ -44,9 +44,23 @@ public:
     using ItemList = std::vector<Item>;
     virtual bool write_batch(const ItemList& items) = 0;
 
+    // Запись группы пулов с номерами в одной транзакции
+    struct SeqItem {
+        cs::Bytes key;
+        uint32_t seq_no;
+        cs::Bytes value;
+    };
+    using SeqItemList = std::vector<SeqItem>;
+    virtual bool write_batch(const SeqItemList& items) = 0;
+
 #ifdef TRANSACTIONS_INDEX
     virtual bool putToTransIndex(const cs::Bytes& key, const cs::Bytes& value) = 0;
     virtual bool getFromTransIndex(const cs::Bytes& key, cs::Bytes* value) = 0;
+
+    // Индекс транзакций по адресам (отдельный файл базы)
+    virtual bool putToAddressIndex(const cs::Bytes& key, const cs::Bytes& value) = 0;
+    virtual bool getFromAddressIndex(const cs::Bytes& key, cs::Bytes* value) = 0;
+    virtual bool removeFromAddressIndex(const cs::Bytes& key) = 0;
 #endif
 
     class Iterator {
@@ -34,11 +34,16 @@ private:
     bool get(const uint32_t seq_no, cs::Bytes* value) final;
     bool remove(const cs::Bytes&) final;
     bool write_batch(const ItemList&) final;
+    bool write_batch(const SeqItemList& items) final;
     IteratorPtr new_iterator() final;
 
 #ifdef TRANSACTIONS_INDEX
     bool putToTransIndex(const cs::Bytes& key, const cs::Bytes& value) override final;
     bool getFromTransIndex(const cs::Bytes& key, cs::Bytes* value) override final;
+
+    bool putToAddressIndex(const cs::Bytes& key, const cs::Bytes& value) override final;
+    bool getFromAddressIndex(const cs::Bytes& key, cs::Bytes* value) override final;
+    bool removeFromAddressIndex(const cs::Bytes& key) override final;
 #endif
 
 private:
@@ -53,6 +58,7 @@ private:
     std::unique_ptr<Db> db_seq_no_;
 #ifdef TRANSACTIONS_INDEX
     std::unique_ptr<Db> db_trans_idx_;
+    std::unique_ptr<Db> db_address_idx_;
 #endif
 };
 
@@ -19,6 +19,7 @@
 #include "csdb/internal/types.hpp"
 #include "csdb/storage.hpp"
 #include "csdb/transaction.hpp"
+#include "csdb/transaction_view.hpp"
 #include "csdb/user_field.hpp"
 
 #include <cscrypto/cscrypto.hpp>
@@ -66,6 +67,14 @@ public:
 
     static PoolHash calc_from_data(const cs::Bytes& data);
 
+    /**
+     * @brief Быстрый (некриптографический) хэш для использования в хэш-таблицах
+     *
+     * Значение хэша пула уже равномерно распределено, поэтому в качестве результата
+     * берутся его первые sizeof(size_t) байт.
+     */
+    size_t calcHash() const noexcept;
+
 private:
     void put(::csdb::priv::obstream&) const;
     bool get(::csdb::priv::ibstream&);
@@ -175,9 +184,32 @@ public:
     void setRoundCost(const csdb::Amount& roundCost) noexcept;
     void add_round_confirmations(const std::vector<cs::Signature>& confirmations) noexcept;
 
+    /**
+     * @brief Транзакции пула.
+     *
+     * У пула, полученного через \ref from_binary, транзакции разбираются при первом обращении
+     * к ним. Для просмотра транзакций без их разбора используйте \ref transaction_views.
+     */
     Transactions& transactions();
     const Transactions& transactions() const;
 
+    /**
+     * @brief Плоские представления транзакций пула, разобранные из его бинарного представления.
+     * @return  Представления транзакций или пустой список, если пул не в режиме Read-Only.
+     *
+     * Представления ссылаются на бинарное представление пула и валидны, пока жив этот объект
+     * пула (или его копия) и он не изменяется.
+     */
+    std::vector<TransactionView> transaction_views() const;
+
+    /**
+     * @brief Создаёт транзакцию из представления, полученного через \ref transaction_views.
+     * @param[in] view  Представление транзакции этого пула
+     * @param[in] index Номер транзакции в пуле
+     * @return Транзакция с идентификатором в пуле. Остальные транзакции пула при этом не разбираются.
+     */
+    Transaction transaction(const TransactionView& view, size_t index) const;
+
     NewWallets* newWallets() noexcept;
     const NewWallets& newWallets() const noexcept;
     bool getWalletAddress(const NewWalletInfo& info, csdb::Address& wallAddress) const;
@@ -317,4 +349,14 @@ inline bool PoolHash::operator !=(const PoolHash &other) const noexcept
 }
 }  // namespace csdb
 
+namespace std {
+template <>
+class hash<csdb::PoolHash> {
+public:
+    size_t operator()(const csdb::PoolHash &obj) const {
+        return obj.calcHash();
+    }
+};
+}  // namespace std
+
 #endif // _CREDITS_CSDB_POOL_H_INCLUDED_
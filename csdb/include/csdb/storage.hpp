@@ -7,8 +7,10 @@
 #define _CREDITS_CSDB_STORAGE_H_INCLUDED_
 
 #include <functional>
+#include <limits>
 #include <memory>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "csdb/database.hpp"
@@ -29,6 +31,9 @@ class TransactionID;
 /** @brief The read block signal, caller may assign test_failed to true if block is logically corrupted */
 using ReadBlockSignal = cs::Signal<void(const csdb::Pool& block, bool* test_failed)>;
 
+/** @brief The write failed signal, emitted by write thread when queued pools starting from sequence can't be written */
+using WriteFailedSignal = cs::Signal<void(cs::Sequence sequence, size_t count)>;
+
 /**
  * @brief Объект хранилища.
  *
@@ -184,6 +189,37 @@ public:
      */
     bool pool_save(Pool pool);
 
+    /**
+     * @brief Счётчики фоновой записи пулов
+     */
+    struct WriteStats {
+        size_t queue_depth;        ///< Текущее количество пулов в очереди записи
+        size_t max_queue_depth;    ///< Максимальное количество пулов в очереди записи
+        uint64_t batches;          ///< Количество записанных групп
+        uint64_t pools_written;    ///< Количество записанных пулов
+        uint64_t last_commit_us;   ///< Время записи последней группы, мкс
+        uint64_t max_commit_us;    ///< Максимальное время записи группы, мкс
+        uint64_t total_commit_us;  ///< Суммарное время записи групп, мкс
+        uint64_t failed_batches;   ///< Количество неудачных попыток записи группы
+    };
+
+    /**
+     * @brief Включает групповую запись пулов.
+     * @param max_pools Максимальное количество пулов в одной транзакции базы. 0 - групповая запись
+     *                  выключена, пулы записываются сразу в \ref pool_save.
+     * @param max_bytes Ограничение суммарного размера пулов в одной транзакции (0 - без ограничения).
+     *
+     * В режиме групповой записи \ref pool_save ставит пул в очередь, а фоновый поток записывает
+     * накопившиеся пулы одной транзакцией. Пулы из очереди доступны через \ref pool_load до окончания
+     * записи. При закрытии хранилища очередь записывается полностью.
+     *
+     * Неудачная запись группы повторяется несколько раз, после чего запись останавливается,
+     * \ref pool_save перестаёт принимать пулы, а хранилище посылает \ref writeFailedEvent.
+     */
+    void set_group_commit(size_t max_pools, size_t max_bytes = 0);
+
+    WriteStats write_stats() const;
+
     /**
      * @brief Загружает пул из хранилища
      * @param[in] hash Хэш пула, который надо загрузить.
@@ -195,6 +231,13 @@ public:
      */
     Pool pool_load(const PoolHash& hash) const;
     Pool pool_load(const cs::Sequence sequence) const;
+
+    /**
+     * @brief Загружает сериализованный пул без разбора
+     * @param[in] sequence Номер записи пула (как в \ref pool_load(const cs::Sequence))
+     * @return Байты пула в том виде, в котором он хранится в базе. Пустой массив, если пул не найден.
+     */
+    cs::Bytes pool_load_raw(const cs::Sequence sequence) const;
     Pool pool_load_meta(const PoolHash& hash, size_t& cnt) const;
 
     Pool pool_remove_last();
@@ -227,6 +270,52 @@ public:
     PoolHash get_previous_transaction_block(const Address&, const PoolHash&);
     void set_previous_transaction_block(const Address&, const PoolHash& currTransBlock, const PoolHash& prevTransBlock);
 
+    /// Положение транзакции в блокчейне: номер блока и номер транзакции в блоке
+    using TransactionPosition = std::pair<cs::Sequence, uint32_t>;
+
+    /**
+     * @brief Добавляет транзакции блока в индекс транзакций адреса.
+     * @param addr      Адрес кошелька
+     * @param sequence  Номер блока
+     * @param indexes   Номера транзакций адреса в блоке по возрастанию
+     * @return true, если транзакции добавлены.
+     *
+     * Индекс адреса пополняется только в конец: транзакции блоков с номером не меньше sequence,
+     * если они уже есть в индексе, заменяются.
+     */
+    bool add_address_transactions(const Address& addr, cs::Sequence sequence, const std::vector<uint32_t>& indexes);
+
+    /**
+     * @brief Удаляет из индекса адреса транзакции блоков с номером не меньше sequence.
+     */
+    bool remove_address_transactions(const Address& addr, cs::Sequence sequence);
+
+    /**
+     * @brief Количество транзакций адреса в индексе.
+     */
+    uint64_t address_transactions_count(const Address& addr) const;
+
+    /**
+     * @brief Положения транзакций адреса, начиная с последней.
+     * @param addr    Адрес кошелька
+     * @param offset  Количество пропускаемых последних транзакций
+     * @param limit   Максимальное количество транзакций в списке
+     * @param before  Транзакции блоков с номером не меньше before пропускаются и не учитываются в offset и limit
+     * @return список положений транзакций от новых к старым
+     *
+     * Время работы зависит только от limit и количества пропускаемых транзакций последних блоков,
+     * блоки при этом не читаются.
+     */
+    std::vector<TransactionPosition> address_transactions(const Address& addr, uint64_t offset, uint64_t limit,
+                                                          cs::Sequence before = std::numeric_limits<cs::Sequence>::max()) const;
+
+    /**
+     * @brief Номер последнего блока, учтённого в индексе транзакций по адресам.
+     * @return false, если индекс ещё не создавался.
+     */
+    bool get_address_index_sequence(cs::Sequence& sequence) const;
+    bool set_address_index_sequence(cs::Sequence sequence);
+
     /**
      * @brief size возвращает количество пулов в хранилище
      * @return количество блоков в хранилище
@@ -269,9 +358,13 @@ public:
 
 public signals:
     const ReadBlockSignal& readBlockEvent() const;
+    const WriteFailedSignal& writeFailedEvent() const;
 
 private:
   static cs::Bytes get_trans_index_key(const Address&, const PoolHash&);
+  static cs::Bytes get_address_index_key(const Address&);
+  static cs::Bytes get_address_index_key(const Address&, uint64_t position);
+  bool get_address_transaction(const Address&, uint64_t position, TransactionPosition&) const;
   Pool pool_load_internal(const PoolHash& hash, const bool metaOnly, size_t& trxCnt) const;
 
   ::std::shared_ptr<priv> d;
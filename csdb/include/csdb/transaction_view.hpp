@@ -0,0 +1,178 @@
+/**
+ * @file transaction_view.hpp
+ */
+
+#ifndef _CREDITS_CSDB_TRANSACTION_VIEW_H_INCLUDED_
+#define _CREDITS_CSDB_TRANSACTION_VIEW_H_INCLUDED_
+
+#include <cinttypes>
+#include <vector>
+
+#include "csdb/amount.hpp"
+#include "csdb/amount_commission.hpp"
+#include "csdb/internal/types.hpp"
+#include "csdb/user_field.hpp"
+
+#include "lib/system/common.hpp"
+
+namespace csdb {
+
+namespace priv {
+class ibstream;
+}  // namespace priv
+
+class Address;
+class Transaction;
+
+/**
+ * @brief Адрес транзакции без выделения памяти: открытый ключ или идентификатор кошелька.
+ */
+class AddressView {
+public:
+    bool is_wallet_id() const noexcept {
+        return is_wallet_id_;
+    }
+
+    bool is_public_key() const noexcept {
+        return !is_wallet_id_;
+    }
+
+    internal::WalletId wallet_id() const noexcept {
+        return wallet_id_;
+    }
+
+    const cs::PublicKey& public_key() const noexcept {
+        return public_key_;
+    }
+
+    Address to_address() const;
+
+    /**
+     * @brief Сравнивает с адресом без создания объекта \ref Address.
+     *
+     * Как и \ref Address::operator==, адреса разного вида (ключ и идентификатор) не равны.
+     */
+    bool operator==(const Address& other) const noexcept;
+
+    bool operator!=(const Address& other) const noexcept {
+        return !operator==(other);
+    }
+
+private:
+    cs::PublicKey public_key_{};
+    internal::WalletId wallet_id_ = 0;
+    bool is_wallet_id_ = false;
+
+    friend class TransactionView;
+};
+
+/**
+ * @brief Плоское представление транзакции для "горячих" участков кода.
+ *
+ * В отличие от \ref Transaction, объект не использует разделяемые данные и разбирается из
+ * бинарного представления транзакции без выделения памяти: адреса хранятся по значению,
+ * дополнительные поля не разбираются, а остаются ссылкой на исходные данные.
+ *
+ * Поэтому объект валиден, только пока живы данные, из которых он был получен (например,
+ * бинарное представление пула для \ref Pool::transaction_views).
+ *
+ * Для полной обработки транзакции объект преобразуется в \ref Transaction (\ref to_transaction).
+ */
+class TransactionView {
+public:
+    bool is_valid() const noexcept {
+        return is_valid_;
+    }
+
+    int64_t innerID() const noexcept {
+        return innerID_;
+    }
+
+    const AddressView& source() const noexcept {
+        return source_;
+    }
+
+    const AddressView& target() const noexcept {
+        return target_;
+    }
+
+    uint8_t currency_id() const noexcept {
+        return currency_;
+    }
+
+    const Amount& amount() const noexcept {
+        return amount_;
+    }
+
+    const AmountCommission& max_fee() const noexcept {
+        return max_fee_;
+    }
+
+    const AmountCommission& counted_fee() const noexcept {
+        return counted_fee_;
+    }
+
+    const cs::Signature& signature() const noexcept {
+        return signature_;
+    }
+
+    /**
+     * @brief Количество дополнительных полей транзакции.
+     */
+    size_t user_fields_count() const noexcept {
+        return user_fields_count_;
+    }
+
+    /**
+     * @brief Дополнительные поля в бинарном виде (без счётчика полей).
+     */
+    cs::BytesView user_fields_binary() const noexcept {
+        return cs::BytesView(user_fields_, user_fields_size_);
+    }
+
+    /**
+     * @brief Разбирает и возвращает одно дополнительное поле.
+     * @return  Значение дополнительного поля или невалидный объект, если поля нет.
+     */
+    UserField user_field(user_field_id_t id) const;
+
+    std::vector<uint8_t> to_byte_stream_for_sig() const;
+
+    /**
+     * @brief Создаёт полноценный объект транзакции.
+     */
+    Transaction to_transaction() const;
+
+    /**
+     * @brief Разбирает транзакцию из данных в формате \ref Transaction::to_binary.
+     * @param[in]  data  Начало бинарного представления транзакции
+     * @param[in]  size  Размер доступных данных
+     * @return  Количество прочитанных байт или 0, если данные некорректны.
+     */
+    size_t read(const cs::Byte* data, size_t size);
+
+private:
+    bool get(::csdb::priv::ibstream&);
+
+    AddressView source_;
+    AddressView target_;
+    int64_t innerID_ = 0;
+    Amount amount_;
+    AmountCommission max_fee_;
+    AmountCommission counted_fee_;
+    cs::Signature signature_{};
+    const cs::Byte* binary_ = nullptr;
+    size_t binary_size_ = 0;
+    const cs::Byte* user_fields_ = nullptr;
+    uint32_t user_fields_size_ = 0;
+    uint8_t user_fields_count_ = 0;
+    uint8_t currency_ = 0;
+    bool is_valid_ = false;
+
+    friend class ::csdb::priv::ibstream;
+    friend class Pool;
+};
+
+}  // namespace csdb
+
+#endif  // _CREDITS_CSDB_TRANSACTION_VIEW_H_INCLUDED_
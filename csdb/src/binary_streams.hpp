@@ -91,6 +91,20 @@ public:
         return (0 == size_);
     }
 
+    inline const void* data() const noexcept {
+        return data_;
+    }
+
+    inline bool skip(size_t size) {
+        if (size > size_) {
+            return false;
+        }
+
+        data_ = static_cast<const uint8_t*>(data_) + size;
+        size_ -= size;
+        return true;
+    }
+
 private:
     const void* data_;
     size_t size_;
@@ -80,6 +80,7 @@ DatabaseBerkeleyDB::~DatabaseBerkeleyDB() {
     std::cout << "DB db_seq_no_ was closed.\n" << std::flush;
 #ifdef TRANSACTIONS_INDEX
     db_trans_idx_->close(0);
+    db_address_idx_->close(0);
 #endif
     env_.close(0);
 }
@@ -167,6 +168,14 @@ bool DatabaseBerkeleyDB::open(const std::string &path) {
         return false;
     }
     db_trans_idx_.reset(db_trans_idx);
+
+    decltype(db_address_idx_) db_address_idx(new Db(&env_, 0));
+    status = db_address_idx->open(NULL, "address_index.db", NULL, DB_BTREE, DB_CREATE, 0);
+    if (status) {
+        set_last_error_from_berkeleydb(status);
+        return false;
+    }
+    db_address_idx_.swap(db_address_idx);
 #endif
 
     set_last_error();
@@ -316,6 +325,48 @@ bool DatabaseBerkeleyDB::write_batch(const ItemList &) {
     return true;
 }
 
+bool DatabaseBerkeleyDB::write_batch(const SeqItemList &items) {
+    if (!db_blocks_) {
+        set_last_error(NotOpen);
+        return false;
+    }
+
+    DbTxn *tid;
+    int status = env_.txn_begin(nullptr, &tid, DB_READ_UNCOMMITTED);
+    int txn_create_status = status;
+    auto g = cs::scopeGuard([&]() {
+        if (txn_create_status) {
+            return;
+        }
+        if (status) {
+            tid->abort();
+        }
+        else {
+            tid->commit(0);
+        }
+    });
+
+    for (auto it = items.begin(); !status && it != items.end(); ++it) {
+        Dbt_copy<uint32_t> db_seq_no(it->seq_no + 1);
+        Dbt_copy<cs::Bytes> db_value(it->value);
+        status = db_blocks_->put(tid, &db_seq_no, &db_value, 0);
+
+        if (!status) {
+            Dbt_copy<cs::Bytes> db_key(it->key);
+            status = db_seq_no_->put(tid, &db_key, &db_seq_no, 0);
+        }
+    }
+
+    if (!status) {
+        set_last_error();
+        return true;
+    }
+    else {
+        set_last_error_from_berkeleydb(status);
+        return false;
+    }
+}
+
 class DatabaseBerkeleyDB::Iterator final : public Database::Iterator {
 public:
     explicit Iterator(Dbc *it)
@@ -456,6 +507,64 @@ bool DatabaseBerkeleyDB::getFromTransIndex(const cs::Bytes &key, cs::Bytes *valu
     set_last_error();
     return true;
 }
+
+bool DatabaseBerkeleyDB::putToAddressIndex(const cs::Bytes &key, const cs::Bytes &value) {
+    if (!db_address_idx_) {
+        set_last_error(NotOpen);
+        return false;
+    }
+
+    Dbt_copy<cs::Bytes> db_key(key);
+    Dbt_copy<cs::Bytes> db_value(value);
+
+    int status = db_address_idx_->put(nullptr, &db_key, &db_value, 0);
+    if (status) {
+        set_last_error_from_berkeleydb(status);
+        return false;
+    }
+
+    set_last_error();
+    return true;
+}
+
+bool DatabaseBerkeleyDB::getFromAddressIndex(const cs::Bytes &key, cs::Bytes *value) {
+    if (!db_address_idx_) {
+        set_last_error(NotOpen);
+        return false;
+    }
+
+    Dbt_copy<cs::Bytes> db_key(key);
+    Dbt_safe db_value;
+
+    int status = db_address_idx_->get(nullptr, &db_key, &db_value, 0);
+    if (status) {
+        set_last_error_from_berkeleydb(status);
+        return false;
+    }
+
+    auto begin = reinterpret_cast<uint8_t *>(db_value.get_data());
+    value->assign(begin, begin + db_value.get_size());
+    set_last_error();
+    return true;
+}
+
+bool DatabaseBerkeleyDB::removeFromAddressIndex(const cs::Bytes &key) {
+    if (!db_address_idx_) {
+        set_last_error(NotOpen);
+        return false;
+    }
+
+    Dbt_copy<cs::Bytes> db_key(key);
+
+    int status = db_address_idx_->del(nullptr, &db_key, 0);
+    if (status != 0 && status != DB_NOTFOUND) {
+        set_last_error_from_berkeleydb(status);
+        return false;
+    }
+
+    set_last_error();
+    return true;
+}
 #endif
 
 }  // namespace csdb
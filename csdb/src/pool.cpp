@@ -1,8 +1,11 @@
 #include "csdb/pool.hpp"
 
 #include <algorithm>
+#include <atomic>
+#include <cstring>
 #include <iomanip>
 #include <map>
+#include <mutex>
 #include <sstream>
 #include <utility>
 
@@ -26,65 +29,97 @@ namespace csdb {
 
 class PoolHash::priv : public ::csdb::internal::shared_data {
 public:
-    cs::Bytes value;
+    // fixed size hash is stored without a separate allocation
+    cs::Hash value{};
+    uint8_t size = 0;
+    // non-cryptographic hash is calculated once when the value is assigned
+    size_t hash = 0;
+
+    const cs::Byte* begin() const {
+        return value.data();
+    }
+
+    const cs::Byte* end() const {
+        return value.data() + size;
+    }
+
+    void assign(const cs::Byte* data, size_t sz) {
+        if (sz != value.size()) {
+            clear();
+            return;
+        }
+
+        std::copy(data, data + sz, value.begin());
+        size = static_cast<uint8_t>(sz);
+        std::memcpy(&hash, value.data(), sizeof(hash));
+    }
+
+    void clear() {
+        value.fill(0);
+        size = 0;
+        hash = 0;
+    }
+
     DEFAULT_PRIV_CLONE();
 };
 SHARED_DATA_CLASS_IMPLEMENTATION(PoolHash)
 
 bool PoolHash::is_empty() const noexcept {
-    return d->value.empty();
+    return d->size == 0;
 }
 
 size_t PoolHash::size() const noexcept {
-    return d->value.size();
+    return d->size;
 }
 
 std::string PoolHash::to_string() const noexcept {
-    return internal::to_hex(d->value);
+    return internal::to_hex(d->begin(), d->end());
 }
 
 cs::Bytes PoolHash::to_binary() const noexcept {
-    return d->value;
+    return cs::Bytes(d->begin(), d->end());
 }
 
 PoolHash PoolHash::from_binary(cs::Bytes&& data) {
-    const size_t sz = data.size();
     PoolHash res;
-    if ((0 == sz) || (::csdb::priv::crypto::hash_size == sz)) {
-        res.d->value = std::move(data);
+    if (::csdb::priv::crypto::hash_size == data.size()) {
+        res.d->assign(data.data(), data.size());
     }
     return res;
 }
 
 bool PoolHash::operator==(const PoolHash& other) const noexcept {
-    return (d == other.d) || (d->value == other.d->value);
+    return (d == other.d) || (d->hash == other.d->hash && d->size == other.d->size && std::equal(d->begin(), d->end(), other.d->begin()));
 }
 
 bool PoolHash::operator<(const PoolHash& other) const noexcept {
-    return (d != other.d) && (d->value < other.d->value);
+    return (d != other.d) && std::lexicographical_compare(d->begin(), d->end(), other.d->begin(), other.d->end());
 }
 
 PoolHash PoolHash::from_string(const ::std::string& str) {
     const cs::Bytes hash = ::csdb::internal::from_hex(str);
-    const size_t sz = hash.size();
     PoolHash res;
-    if ((0 == sz) || (::csdb::priv::crypto::hash_size == sz)) {
-        res.d->value = hash;
+    if (::csdb::priv::crypto::hash_size == hash.size()) {
+        res.d->assign(hash.data(), hash.size());
     }
     return res;
 }
 
+size_t PoolHash::calcHash() const noexcept {
+    return d->hash;
+}
+
 PoolHash PoolHash::calc_from_data(const cs::Bytes& data) {
     PoolHash res;
-    res.d->value = ::csdb::priv::crypto::calc_hash(data);
+    const cs::Bytes hash = ::csdb::priv::crypto::calc_hash(data);
+    res.d->assign(hash.data(), hash.size());
     return res;
 }
 
 void PoolHash::put(::csdb::priv::obstream& os) const {
-    size_t size = d->value.size();
-    os.put(static_cast<uint8_t>(size));
-    if (!d->value.empty()) {
-        os.put((const void*)d->value.data(), size);
+    os.put(d->size);
+    if (d->size != 0) {
+        os.put(static_cast<const void*>(d->value.data()), d->size);
     }
 }
 
@@ -94,16 +129,18 @@ bool PoolHash::get(::csdb::priv::ibstream& is) {
         return false;
     }
     if (size == 0) {
-        d->value.clear();
+        d->clear();
         return true;
     }
     if (size != cscrypto::kHashSize || is.size() < cscrypto::kHashSize) {
         return false;
     }
-    if (d->value.size() != cscrypto::kHashSize) {
-        d->value.resize(cscrypto::kHashSize);
+    cs::Hash value;
+    if (!is.get(value.data(), cscrypto::kHashSize)) {
+        return false;
     }
-    return is.get(d->value.data(), cscrypto::kHashSize);
+    d->assign(value.data(), value.size());
+    return true;
 }
 
 class Pool::priv : public ::csdb::internal::shared_data {
@@ -126,6 +163,9 @@ class Pool::priv : public ::csdb::internal::shared_data {
         os.put(user_fields_);
         os.put(roundCost_);
 
+        load_transactions();
+
+        const_cast<size_t&>(transactionsOffset_) = os.buffer().size();
         os.put(static_cast<uint32_t>(transactions_.size()));
         for (const auto& it : transactions_) {
             os.put(it);
@@ -181,6 +221,8 @@ class Pool::priv : public ::csdb::internal::shared_data {
         os.put(user_fields_);
         os.put(roundCost_);
 
+        load_transactions();
+
         os.put(static_cast<uint32_t>(transactions_.size()));
         for (const auto& it : transactions_) {
             os.put(it);
@@ -200,6 +242,8 @@ class Pool::priv : public ::csdb::internal::shared_data {
     }
 
     bool get_meta(::csdb::priv::ibstream& is, size_t& cnt) {
+        const auto begin = static_cast<const uint8_t*>(is.data());
+
         if (!is.get(version_)) {
             csmeta(cswarning) << "get version is failed";
             return false;
@@ -225,6 +269,8 @@ class Pool::priv : public ::csdb::internal::shared_data {
             return false;
         }
 
+        transactionsOffset_ = static_cast<size_t>(static_cast<const uint8_t*>(is.data()) - begin);
+
         if (!is.get(transactionsCount_)) {
             csmeta(cswarning) << "get cnt is failed";
             return false;
@@ -258,6 +304,47 @@ class Pool::priv : public ::csdb::internal::shared_data {
         return true;
     }
 
+    // checks transactions bounds only, they are decoded by load_transactions() on first access
+    bool skipTransactions(::csdb::priv::ibstream& is, size_t cnt) {
+        TransactionView view;
+        for (size_t i = 0; i < cnt; ++i) {
+            const size_t size = view.read(static_cast<const cs::Byte*>(is.data()), is.size());
+            if (size == 0 || !is.skip(size)) {
+                return false;
+            }
+        }
+
+        transactions_.clear();
+        lazy_.pending.store(true, std::memory_order_release);
+        return true;
+    }
+
+    void load_transactions() const {
+        if (!lazy_.pending.load(std::memory_order_acquire)) {
+            return;
+        }
+
+        std::lock_guard<std::mutex> lock(lazy_.mutex);
+        if (!lazy_.pending.load(std::memory_order_relaxed)) {
+            return;
+        }
+
+        auto self = const_cast<priv*>(this);
+        const auto& binary = binary_representation_;
+        ::csdb::priv::ibstream is(binary.data() + transactionsOffset_, binary.size() - transactionsOffset_);
+
+        uint32_t cnt = 0;
+        if (!is.get(cnt) || !self->getTransactions(is, cnt)) {
+            cserror() << "Pool::load_transactions(): inconsistent binary pool";
+            self->transactions_.clear();
+        }
+        else if (read_only_) {
+            self->update_transactions_ids();
+        }
+
+        lazy_.pending.store(false, std::memory_order_release);
+    }
+
     bool getConfidants(::csdb::priv::ibstream& is) {
         confidants_.clear();
         confidants_.reserve(numberTrusted_);
@@ -390,7 +477,7 @@ class Pool::priv : public ::csdb::internal::shared_data {
             return false;
         }
 
-        if (!getTransactions(is, cnt)) {
+        if (!skipTransactions(is, cnt)) {
             csmeta(cswarning) << "get transactions is failed";
             return false;
         }
@@ -466,12 +553,25 @@ class Pool::priv : public ::csdb::internal::shared_data {
         read_only_ = true;
 
         updateHash();
+        update_transactions_ids();
+    }
 
+    void update_transactions_ids() {
         for (size_t idx = 0; idx < transactions_.size(); ++idx) {
             transactions_[idx].d->_update_id(hash_, idx);
         }
     }
 
+    Transaction to_transaction(const TransactionView& view, size_t index) const {
+        Transaction result = view.to_transaction();
+
+        if (read_only_ && result.is_valid()) {
+            result.d->_update_id(hash_, index);
+        }
+
+        return result;
+    }
+
     Storage get_storage(Storage candidate) {
         if (candidate.isOpen()) {
             return candidate;
@@ -496,11 +596,18 @@ class Pool::priv : public ::csdb::internal::shared_data {
         result.sequence_ = sequence_;
         result.confidants_ = confidants_;
         result.hashingLength_ = hashingLength_;
+        result.transactionsOffset_ = transactionsOffset_;
         result.roundCost_ = roundCost_;
 
-        result.transactions_.reserve(transactions_.size());
-        for (auto& t : transactions_) {
-            result.transactions_.push_back(t.clone());
+        {
+            std::lock_guard<std::mutex> lock(lazy_.mutex);
+
+            result.transactions_.reserve(transactions_.size());
+            for (auto& t : transactions_) {
+                result.transactions_.push_back(t.clone());
+            }
+
+            result.lazy_ = lazy_;
         }
 
         result.transactionsCount_ = transactionsCount_;
@@ -540,6 +647,8 @@ class Pool::priv : public ::csdb::internal::shared_data {
     uint8_t numberConfirmations_ = 0;
     uint64_t roundConfirmationMask_ = 0;
     size_t hashingLength_ = 0;
+    // position of transactions count in binary representation
+    size_t transactionsOffset_ = 0;
     csdb::Amount roundCost_;
     std::vector<cs::Signature> signatures_;
     std::vector<cs::Signature> roundConfirmations_;
@@ -547,6 +656,25 @@ class Pool::priv : public ::csdb::internal::shared_data {
     cs::Bytes binary_representation_;
     ::csdb::Storage::WeakPtr storage_;
 
+    // transactions are not decoded until they are requested
+    struct LazyTransactions {
+        LazyTransactions() = default;
+
+        LazyTransactions(const LazyTransactions& other)
+        : pending(other.pending.load(std::memory_order_acquire)) {
+        }
+
+        LazyTransactions& operator=(const LazyTransactions& other) {
+            pending.store(other.pending.load(std::memory_order_acquire), std::memory_order_release);
+            return *this;
+        }
+
+        std::atomic<bool> pending{false};
+        std::mutex mutex;
+    };
+
+    mutable LazyTransactions lazy_;
+
     static cs::PublicKey zero_writer_public_key_;
     friend class Pool;
 };
@@ -592,9 +720,14 @@ Storage Pool::storage() const noexcept {
 }
 
 Transaction Pool::transaction(size_t index) const {
+    d->load_transactions();
     return (d->transactions_.size() > index) ? d->transactions_[index] : Transaction{};
 }
 
+Transaction Pool::transaction(const TransactionView& view, size_t index) const {
+    return d->to_transaction(view, index);
+}
+
 uint8_t Pool::numberTrusted() const noexcept {
     return d->numberTrusted_;
 }
@@ -616,6 +749,7 @@ const std::vector<cs::Signature>& Pool::roundConfirmations() const noexcept {
 }
 
 Transaction Pool::transaction(TransactionID id) const {
+    d->load_transactions();
     if ((!d->is_valid_) || (!d->read_only_) || (!id.is_valid()) || (id.pool_hash() != d->hash_) || (d->transactions_.size() <= id.d->index_)) {
         return Transaction{};
     }
@@ -629,6 +763,20 @@ Transaction Pool::get_last_by_source(const Address& source) const noexcept {
         return Transaction{};
     }
 
+    if (data->read_only_ && data->lazy_.pending.load(std::memory_order_acquire)) {
+        const auto views = transaction_views();
+
+        for (size_t i = views.size(); i > 0; --i) {
+            if (views[i - 1].source() == source) {
+                return data->to_transaction(views[i - 1], i - 1);
+            }
+        }
+
+        return Transaction{};
+    }
+
+    data->load_transactions();
+
     auto it_rend = data->transactions_.rend();
     for (auto it = data->transactions_.rbegin(); it != it_rend; ++it) {
         const auto& t = *it;
@@ -648,6 +796,20 @@ Transaction Pool::get_last_by_target(const Address& target) const noexcept {
         return Transaction{};
     }
 
+    if (data->read_only_ && data->lazy_.pending.load(std::memory_order_acquire)) {
+        const auto views = transaction_views();
+
+        for (size_t i = views.size(); i > 0; --i) {
+            if (views[i - 1].target() == target) {
+                return data->to_transaction(views[i - 1], i - 1);
+            }
+        }
+
+        return Transaction{};
+    }
+
+    data->load_transactions();
+
     auto it_rend = data->transactions_.rend();
     for (auto it = data->transactions_.rbegin(); it != it_rend; ++it) {
         const auto t = *it;
@@ -687,12 +849,45 @@ bool Pool::add_transaction(Transaction transaction
     return true;
 }
 
+std::vector<TransactionView> Pool::transaction_views() const {
+    const priv* data = d.constData();
+    std::vector<TransactionView> result;
+
+    if (!data->read_only_ || data->binary_representation_.size() <= data->transactionsOffset_) {
+        return result;
+    }
+
+    const auto& binary = data->binary_representation_;
+    ::csdb::priv::ibstream is(binary.data() + data->transactionsOffset_, binary.size() - data->transactionsOffset_);
+
+    uint32_t count = 0;
+    if (!is.get(count) || count > is.size()) {
+        return result;
+    }
+
+    result.resize(count);
+
+    for (auto& view : result) {
+        if (!view.get(is)) {
+            cserror() << "Pool::transaction_views(): inconsistent binary pool";
+            result.clear();
+            break;
+        }
+    }
+
+    return result;
+}
+
 size_t Pool::transactions_count() const noexcept {
     // return d->transactionsCount_; // bad work
+    if (d->lazy_.pending.load(std::memory_order_acquire)) {
+        return d->transactionsCount_;
+    }
     return d->transactions_.size();
 }
 
 void Pool::recount() noexcept {
+    d->load_transactions();
     d->transactionsCount_ = static_cast<uint32_t>(d->transactions_.size());
 }
 
@@ -843,10 +1038,13 @@ void Pool::set_storage(const Storage& storage) noexcept {
 }
 
 Pool::Transactions& Pool::transactions() {
-    return d->transactions_;
+    priv* data = d.data();
+    data->load_transactions();
+    return data->transactions_;
 }
 
 const Pool::Transactions& Pool::transactions() const {
+    d->load_transactions();
     return d->transactions_;
 }
 
@@ -2,9 +2,12 @@
 
 #include <algorithm>
 #include <cassert>
+#include <chrono>
 #include <condition_variable>
 #include <cstdarg>
 #include <deque>
+#include <map>
+#include <memory>
 #include <mutex>
 #include <sstream>
 #include <stdexcept>
@@ -38,6 +41,11 @@ namespace csdb {
 
 namespace {
 
+// пауза перед повтором неудачной записи группы пулов
+constexpr std::chrono::milliseconds kWriteRetryDelay{500};
+// количество повторов, после которого запись останавливается и хранилище сообщает об ошибке
+constexpr size_t kMaxWriteRetries = 20;
+
 struct head_info_t {
     size_t len_;     // Количество блоков в цепочке
     PoolHash next_;  // хеш следующего пула, или пустая строка для первого пула
@@ -104,6 +112,148 @@ void update_heads_and_tails(heads_t& heads, tails_t& tails, const PoolHash& cur_
     }
 }
 
+/**
+ * Конвейер декодирования пулов при сканировании хранилища.
+ *
+ * Поток чтения выбирает сырые данные из курсора, рабочие потоки выполняют Pool::from_binary
+ * (разбор и вычисление хэша), а вызывающий поток получает пулы строго в порядке чтения.
+ * Количество пулов в обработке ограничено окном, поэтому память не растёт при медленном потребителе.
+ */
+class rescan_pipeline {
+public:
+    rescan_pipeline(Database::Iterator& it, size_t workers)
+    : it_(it)
+    , window_(workers * kWindowPerWorker) {
+        threads_.emplace_back(&rescan_pipeline::read_routine, this);
+
+        for (size_t i = 0; i < workers; ++i) {
+            threads_.emplace_back(&rescan_pipeline::decode_routine, this);
+        }
+    }
+
+    ~rescan_pipeline() {
+        {
+            std::lock_guard<std::mutex> lock(lock_);
+            quit_ = true;
+        }
+
+        read_cond_.notify_all();
+        decode_cond_.notify_all();
+
+        for (auto& thread : threads_) {
+            thread.join();
+        }
+    }
+
+    rescan_pipeline(const rescan_pipeline&) = delete;
+    rescan_pipeline& operator=(const rescan_pipeline&) = delete;
+
+    // Количество рабочих потоков декодирования, 0 - конвейер не нужен
+    static size_t workers_count() {
+        const size_t cores = std::thread::hardware_concurrency();
+
+        if (cores <= 2) {
+            return 0;
+        }
+
+        // один поток занят чтением курсора, ещё один - потребителем пулов
+        return std::min(cores - 2, kMaxWorkers);
+    }
+
+    // Возвращает false, если пулов больше нет
+    bool next(Pool& pool) {
+        std::unique_lock<std::mutex> lock(lock_);
+        ready_cond_.wait(lock, [this]() { return decoded_.count(next_) != 0 || (read_finished_ && next_ == read_count_); });
+
+        auto it = decoded_.find(next_);
+        if (it == decoded_.end()) {
+            return false;
+        }
+
+        pool = std::move(it->second);
+        decoded_.erase(it);
+        ++next_;
+
+        lock.unlock();
+        read_cond_.notify_one();
+
+        return true;
+    }
+
+private:
+    void read_routine() {
+        while (it_.is_valid()) {
+            cs::Bytes value = it_.value();
+            it_.next();
+
+            std::unique_lock<std::mutex> lock(lock_);
+            read_cond_.wait(lock, [this]() { return quit_ || read_count_ - next_ < window_; });
+
+            if (quit_) {
+                return;
+            }
+
+            raw_.emplace_back(read_count_++, std::move(value));
+
+            lock.unlock();
+            decode_cond_.notify_one();
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(lock_);
+            read_finished_ = true;
+        }
+
+        decode_cond_.notify_all();
+        ready_cond_.notify_all();
+    }
+
+    void decode_routine() {
+        std::unique_lock<std::mutex> lock(lock_);
+
+        while (true) {
+            decode_cond_.wait(lock, [this]() { return quit_ || read_finished_ || !raw_.empty(); });
+
+            if (quit_ || raw_.empty()) {
+                return;
+            }
+
+            auto item = std::move(raw_.front());
+            raw_.pop_front();
+
+            lock.unlock();
+            Pool pool = Pool::from_binary(std::move(item.second));
+            lock.lock();
+
+            decoded_.emplace(item.first, std::move(pool));
+
+            if (item.first == next_) {
+                ready_cond_.notify_one();
+            }
+        }
+    }
+
+    static constexpr size_t kMaxWorkers = 8;
+    static constexpr size_t kWindowPerWorker = 64;
+
+    Database::Iterator& it_;
+    const size_t window_;
+
+    std::mutex lock_;
+    std::condition_variable read_cond_;
+    std::condition_variable decode_cond_;
+    std::condition_variable ready_cond_;
+
+    std::deque<std::pair<size_t, cs::Bytes>> raw_;
+    std::map<size_t, Pool> decoded_;
+    size_t read_count_ = 0;
+    size_t next_ = 0;
+    bool read_finished_ = false;
+    bool quit_ = false;
+
+    std::vector<std::thread> threads_;
+};
+
 }  // namespace
 
 class Storage::priv {
@@ -113,16 +263,13 @@ public:
     }
 
     ~priv() {
-        if (write_thread.joinable()) {
-            quit = true;
-            write_cond_var.notify_one();
-            write_thread.join();
-        }
+        stop_write_routine();
     }
 
 private:
     bool rescan(Storage::OpenCallback callback);
     void write_routine();
+    void stop_write_routine();
 
     std::shared_ptr<Database> db = nullptr;
     PoolHash last_hash;     // Хеш последнего пула
@@ -140,8 +287,19 @@ private:
     std::mutex write_lock;
     std::condition_variable write_cond_var;
 
+    // Групповая запись, 0 - пулы пишутся сразу в pool_save
+    size_t group_commit_pools = 0;
+    size_t group_commit_bytes = 0;
+    // Количество пулов в начале очереди, записываемых текущей транзакцией
+    size_t write_in_flight = 0;
+    std::condition_variable write_done_cond_var;
+    Storage::WriteStats write_stats{};
+    // Запись остановлена после kMaxWriteRetries неудачных попыток, новые пулы не принимаются
+    bool write_failed = false;
+
 private signals:
     ReadBlockSignal read_block_event;
+    WriteFailedSignal write_failed_event;
 
     // TODO: Добавить кеш для хранения последних вычитанных пулов транзакций
 
@@ -193,11 +351,30 @@ bool Storage::priv::rescan(Storage::OpenCallback callback) {
     Database::IteratorPtr it = db->new_iterator();
     assert(it);
 
-    Storage::OpenProgress progress{0};
-    for (it->seek_to_first(); it->is_valid(); it->next()) {
-        cs::Bytes v = it->value();
+    it->seek_to_first();
+
+    // декодирование пулов выполняется параллельно, если есть свободные ядра
+    std::unique_ptr<rescan_pipeline> pipeline;
+    if (const size_t workers = rescan_pipeline::workers_count(); workers > 0) {
+        pipeline = std::make_unique<rescan_pipeline>(*it, workers);
+    }
 
-        Pool p = Pool::from_binary(std::move(v));
+    auto next_pool = [&pipeline, &it](Pool& pool) -> bool {
+        if (pipeline) {
+            return pipeline->next(pool);
+        }
+
+        if (!it->is_valid()) {
+            return false;
+        }
+
+        pool = Pool::from_binary(it->value());
+        it->next();
+        return true;
+    };
+
+    Storage::OpenProgress progress{0};
+    for (Pool p; next_pool(p);) {
         if (!p.is_valid()) {
             set_last_error(Storage::DataIntegrityError, "Data integrity error: Corrupted pool for key'.");
             return false;
@@ -261,24 +438,119 @@ bool Storage::priv::rescan(Storage::OpenCallback callback) {
 
 void Storage::priv::write_routine() {
     std::unique_lock<std::mutex> lock(write_lock);
-    while (!quit) {
-        write_cond_var.wait(lock);
-        while (!write_queue.empty()) {
-            Pool& pool = write_queue.front();
+    size_t retries = 0;
+
+    while (true) {
+        write_cond_var.wait(lock, [this]() { return quit || !write_queue.empty(); });
+
+        // при остановке очередь дописывается до конца
+        if (write_queue.empty()) {
+            break;
+        }
+
+        const size_t max_pools = std::max<size_t>(group_commit_pools, 1);
+        const size_t max_bytes = group_commit_bytes;
+
+        // пулы остаются в очереди до окончания записи, чтобы их можно было найти при загрузке,
+        // сериализуются они без блокировки очереди
+        std::vector<Pool> pools(write_queue.begin(), write_queue.begin() + static_cast<std::ptrdiff_t>(std::min(max_pools, write_queue.size())));
+        write_in_flight = pools.size();
+
+        for (Pool& pool : pools) {
             if (!pool.is_read_only()) {
                 if (!pool.compose()) {
                     set_last_error(Storage::DataIntegrityError, "Pool passed to storage is not composed and failed to compose now");
                 }
             }
-            const PoolHash hash = pool.hash();
+        }
+
+        lock.unlock();
+
+        size_t bytes = 0;
+        Database::SeqItemList batch;
+        batch.reserve(pools.size());
+
+        for (const Pool& pool : pools) {
+            if (max_bytes != 0 && bytes >= max_bytes) {
+                break;
+            }
+
+            cs::Bytes binary = pool.to_binary();
+            bytes += binary.size();
+            batch.push_back(Database::SeqItem{pool.hash().to_binary(), static_cast<uint32_t>(pool.sequence()), std::move(binary)});
+        }
+
+        // пулы, не вошедшие в группу из-за ограничения размера, можно извлечь во время записи
+        lock.lock();
+        write_in_flight = batch.size();
+        write_done_cond_var.notify_all();
+        lock.unlock();
+
+        const auto start = std::chrono::steady_clock::now();
+        const bool written = db->write_batch(batch);
+        const auto duration = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+
+        lock.lock();
+        write_in_flight = 0;
+
+        if (!written) {
+            // группа пишется одной транзакцией, поэтому при ошибке пулы остаются в очереди целиком и запись повторяется;
+            // при остановке ждать нельзя - недописанные пулы теряются, как и без групповой записи
+            set_last_error(Storage::DatabaseError, "Failed to write %zu pools starting from %zu", batch.size(), static_cast<size_t>(batch.front().seq_no));
+            ++write_stats.failed_batches;
+            write_done_cond_var.notify_all();
+
+            // очередь не может расти бесконечно: пулы остаются доступны для чтения, но новые не принимаются
+            if (++retries > kMaxWriteRetries) {
+                write_failed = true;
+
+                const auto sequence = static_cast<cs::Sequence>(batch.front().seq_no);
+                const size_t count = write_queue.size();
+
+                lock.unlock();
+                emit write_failed_event(sequence, count);
+                lock.lock();
+
+                write_cond_var.wait(lock, [this]() { return quit; });
+                break;
+            }
 
-            db->put(hash.to_binary(), static_cast<uint32_t>(pool.sequence()), pool.to_binary());
+            if (write_cond_var.wait_for(lock, kWriteRetryDelay, [this]() { return quit; })) {
+                break;
+            }
 
-            write_queue.pop_front();
+            continue;
         }
+
+        retries = 0;
+
+        write_queue.erase(write_queue.begin(), write_queue.begin() + static_cast<std::ptrdiff_t>(batch.size()));
+
+        const auto commit_us = static_cast<uint64_t>(duration);
+        ++write_stats.batches;
+        write_stats.pools_written += batch.size();
+        write_stats.last_commit_us = commit_us;
+        write_stats.max_commit_us = std::max(write_stats.max_commit_us, commit_us);
+        write_stats.total_commit_us += commit_us;
+
+        write_done_cond_var.notify_all();
     }
 }
 
+void Storage::priv::stop_write_routine() {
+    if (!write_thread.joinable()) {
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(write_lock);
+        quit = true;
+    }
+
+    write_cond_var.notify_one();
+    write_thread.join();
+}
+
 Storage::Storage()
 : d(::std::make_shared<priv>()) {
 }
@@ -371,16 +643,41 @@ bool Storage::open(const ::std::string& path_to_base, OpenCallback callback) {
     auto db{::std::make_shared<::csdb::DatabaseBerkeleyDB>()};
     db->open(path);
 
+    d->stop_write_routine();
+    d->quit = false;
     d->write_thread = std::thread(&Storage::priv::write_routine, d.get());
 
     return open(OpenOptions{db}, callback);
 }
 
 void Storage::close() {
+    // очередь групповой записи должна попасть в базу до её закрытия
+    d->stop_write_routine();
     d->db.reset();
     d->set_last_error();
 }
 
+void Storage::set_group_commit(size_t max_pools, size_t max_bytes) {
+    {
+        std::lock_guard<std::mutex> lock(d->write_lock);
+        d->group_commit_pools = max_pools;
+        d->group_commit_bytes = max_bytes;
+    }
+
+    // хранилище, открытое по набору параметров, не запускает поток записи само
+    if (max_pools != 0 && !d->write_thread.joinable()) {
+        d->quit = false;
+        d->write_thread = std::thread(&Storage::priv::write_routine, d.get());
+    }
+}
+
+Storage::WriteStats Storage::write_stats() const {
+    std::lock_guard<std::mutex> lock(d->write_lock);
+    WriteStats stats = d->write_stats;
+    stats.queue_depth = d->write_queue.size();
+    return stats;
+}
+
 bool Storage::isOpen() const {
     return ((d->db) && (d->db->is_open()));
 }
@@ -412,14 +709,30 @@ bool Storage::pool_save(Pool pool) {
         d->set_last_error(InvalidParameter, "%s: Pool already pressent [hash: %s]", funcName(), hash.to_string().c_str());
         return false;
     }
-    /*
-      {
+
+    {
         std::unique_lock<std::mutex> lock(d->write_lock);
-        d->write_queue.push_back(pool);
-        d->write_cond_var.notify_one();
-      }
-    */
-    d->db->put(hash.to_binary(), static_cast<uint32_t>(pool.sequence()), pool.to_binary());
+
+        if (d->group_commit_pools != 0 && d->write_thread.joinable() && !d->quit) {
+            if (d->write_failed) {
+                d->set_last_error(DatabaseError, "%s: Pools are not written after write failure [hash: %s]", funcName(), hash.to_string().c_str());
+                return false;
+            }
+
+            if (std::any_of(d->write_queue.begin(), d->write_queue.end(), [&](const Pool& queued) { return queued.hash() == hash; })) {
+                d->set_last_error(InvalidParameter, "%s: Pool already queued [hash: %s]", funcName(), hash.to_string().c_str());
+                return false;
+            }
+
+            d->write_queue.push_back(pool);
+            d->write_stats.max_queue_depth = std::max(d->write_stats.max_queue_depth, d->write_queue.size());
+            d->write_cond_var.notify_one();
+        }
+        else {
+            lock.unlock();
+            d->db->put(hash.to_binary(), static_cast<uint32_t>(pool.sequence()), pool.to_binary());
+        }
+    }
 
     {
         std::unique_lock<std::mutex> lock(d->data_lock);
@@ -488,22 +801,25 @@ Pool Storage::pool_load_internal(const PoolHash& hash, const bool metaOnly, size
 }
 
 bool Storage::write_queue_search(const PoolHash& hash, Pool& res_pool) const {
-    std::unique_lock<std::mutex> lock(d->write_lock, std::defer_lock);
+    // поток записи не держит блокировку во время сериализации и записи, поэтому ожидание короткое
+    std::lock_guard<std::mutex> lock(d->write_lock);
 
-    if (!d->write_queue.empty() && lock.try_lock()) {
-        auto pos = std::find_if(d->write_queue.begin(), d->write_queue.end(), [&](Pool& pool) { return hash == pool.hash(); });
+    auto pos = std::find_if(d->write_queue.begin(), d->write_queue.end(), [&](Pool& pool) { return hash == pool.hash(); });
 
-        if (pos != d->write_queue.cend()) {
-            res_pool = *pos;
-            return true;
-        }
+    if (pos != d->write_queue.cend()) {
+        res_pool = *pos;
+        return true;
     }
+
     return false;
 }
 
 bool Storage::write_queue_pop(Pool& res_pool) {
     std::unique_lock<std::mutex> lock(d->write_lock);
 
+    // пулы, которые уже записываются, извлечь нельзя - дожидаемся окончания записи
+    d->write_done_cond_var.wait(lock, [this]() { return d->write_in_flight == 0 || d->write_queue.size() > d->write_in_flight; });
+
     if (!d->write_queue.empty()) {
         res_pool = d->write_queue.back();
         d->write_queue.pop_back();
@@ -517,6 +833,39 @@ Pool Storage::pool_load(const PoolHash& hash) const {
     return pool_load_internal(hash, false, size);
 }
 
+cs::Bytes Storage::pool_load_raw(const cs::Sequence sequence) const {
+    if (!isOpen()) {
+        d->set_last_error(NotOpen);
+        return cs::Bytes{};
+    }
+
+    cs::Bytes data;
+    if (d->db->get(static_cast<uint32_t>(sequence), &data)) {
+        d->set_last_error();
+        return data;
+    }
+
+    {
+        std::unique_lock<std::mutex> lock(d->write_lock);
+        for (auto& poolToWrite : d->write_queue) {
+            // sequence is the record number, i.e. pool sequence + 1
+            if (poolToWrite.sequence() + 1 == sequence && poolToWrite.is_read_only()) {
+                d->set_last_error();
+                return poolToWrite.to_binary();
+            }
+        }
+    }
+
+    // pool could be written while the queue was searched
+    if (!d->db->get(static_cast<uint32_t>(sequence), &data)) {
+        d->set_last_error(DatabaseError);
+        return cs::Bytes{};
+    }
+
+    d->set_last_error();
+    return data;
+}
+
 Pool Storage::pool_load(const cs::Sequence sequence) const {
     if (!isOpen()) {
         d->set_last_error(NotOpen);
@@ -531,7 +880,8 @@ Pool Storage::pool_load(const cs::Sequence sequence) const {
         {
             std::unique_lock<std::mutex> lock2(d->write_lock);
             for (auto& poolToWrite : d->write_queue) {
-                if (poolToWrite.sequence() == sequence) {
+                // sequence is the record number, i.e. pool sequence + 1
+                if (poolToWrite.sequence() + 1 == sequence) {
                     res = poolToWrite;
                     needParseData = false;
                     break;
@@ -603,6 +953,8 @@ Pool Storage::pool_remove_last() {
     bool found = write_queue_pop(res);
 
     if (found) {
+        std::unique_lock<std::mutex> lock(d->data_lock);
+        --d->count_pool;
         d->last_hash = res.previous_hash();
         return res;
     }
@@ -688,6 +1040,10 @@ const ReadBlockSignal& Storage::readBlockEvent() const {
     return d->read_block_event;
 }
 
+const WriteFailedSignal& Storage::writeFailedEvent() const {
+    return d->write_failed_event;
+}
+
 std::vector<Transaction> Storage::transactions(const Address& addr, size_t limit, const TransactionID& offset) const {
     std::vector<Transaction> res;
     res.reserve(limit);
@@ -817,6 +1173,143 @@ void Storage::set_previous_transaction_block(const Address& addr, const PoolHash
   d->db->putToTransIndex(key, os.buffer());
 }
 
+namespace {
+// the key can't be confused with address keys as they are longer
+const cs::Bytes kAddressIndexSequenceKey = {'s', 'e', 'q'};
+}  // namespace
+
+cs::Bytes Storage::get_address_index_key(const Address& addr) {
+    ::csdb::priv::obstream os;
+    addr.put(os);
+    return os.buffer();
+}
+
+cs::Bytes Storage::get_address_index_key(const Address& addr, uint64_t position) {
+    ::csdb::priv::obstream os;
+    addr.put(os);
+    os.put(position);
+    return os.buffer();
+}
+
+bool Storage::get_address_transaction(const Address& addr, uint64_t position, TransactionPosition& result) const {
+    cs::Bytes data;
+    if (!d->db->getFromAddressIndex(get_address_index_key(addr, position), &data)) {
+        return false;
+    }
+
+    ::csdb::priv::ibstream is(data.data(), data.size());
+    return is.get(result.first) && is.get(result.second);
+}
+
+uint64_t Storage::address_transactions_count(const Address& addr) const {
+    uint64_t count = 0;
+    cs::Bytes data;
+
+    if (d->db->getFromAddressIndex(get_address_index_key(addr), &data)) {
+        ::csdb::priv::ibstream is(data.data(), data.size());
+        is.get(count);
+    }
+
+    return count;
+}
+
+bool Storage::add_address_transactions(const Address& addr, cs::Sequence sequence, const std::vector<uint32_t>& indexes) {
+    // block may be indexed already if node was stopped before the index sequence had been saved
+    if (!remove_address_transactions(addr, sequence)) {
+        return false;
+    }
+
+    uint64_t count = address_transactions_count(addr);
+
+    for (const auto index : indexes) {
+        ::csdb::priv::obstream os;
+        os.put(sequence);
+        os.put(index);
+
+        if (!d->db->putToAddressIndex(get_address_index_key(addr, count), os.buffer())) {
+            return false;
+        }
+
+        ++count;
+    }
+
+    // count is written last, so interrupted write leaves the index consistent
+    ::csdb::priv::obstream os;
+    os.put(count);
+    return d->db->putToAddressIndex(get_address_index_key(addr), os.buffer());
+}
+
+bool Storage::remove_address_transactions(const Address& addr, cs::Sequence sequence) {
+    const uint64_t count = address_transactions_count(addr);
+    uint64_t rest = count;
+
+    TransactionPosition last;
+    while (rest > 0 && get_address_transaction(addr, rest - 1, last) && last.first >= sequence) {
+        --rest;
+    }
+
+    if (rest == count) {
+        return true;
+    }
+
+    ::csdb::priv::obstream os;
+    os.put(rest);
+    if (!d->db->putToAddressIndex(get_address_index_key(addr), os.buffer())) {
+        return false;
+    }
+
+    for (uint64_t position = rest; position < count; ++position) {
+        d->db->removeFromAddressIndex(get_address_index_key(addr, position));
+    }
+
+    return true;
+}
+
+std::vector<Storage::TransactionPosition> Storage::address_transactions(const Address& addr, uint64_t offset, uint64_t limit, cs::Sequence before) const {
+    std::vector<TransactionPosition> result;
+    uint64_t count = address_transactions_count(addr);
+
+    // index is appended by blocks order, so postings of skipped blocks are the last ones
+    TransactionPosition last;
+    while (count > 0 && get_address_transaction(addr, count - 1, last) && last.first >= before) {
+        --count;
+    }
+
+    if (offset >= count) {
+        return result;
+    }
+
+    const uint64_t size = std::min(limit, count - offset);
+    result.reserve(static_cast<size_t>(size));
+
+    for (uint64_t position = count - offset; result.size() < size; --position) {
+        TransactionPosition item;
+        if (!get_address_transaction(addr, position - 1, item)) {
+            break;
+        }
+
+        result.push_back(item);
+    }
+
+    return result;
+}
+
+bool Storage::get_address_index_sequence(cs::Sequence& sequence) const {
+    cs::Bytes data;
+    if (!d->db->getFromAddressIndex(kAddressIndexSequenceKey, &data)) {
+        return false;
+    }
+
+    ::csdb::priv::ibstream is(data.data(), data.size());
+    return is.get(sequence);
+}
+
+bool Storage::set_address_index_sequence(cs::Sequence sequence) {
+    ::csdb::priv::obstream os;
+    os.put(sequence);
+    return d->db->putToAddressIndex(kAddressIndexSequenceKey, os.buffer());
+}
+
 #endif
 
 }  // namespace csdb
@@ -0,0 +1,220 @@
+#include "csdb/transaction_view.hpp"
+
+#include <cstring>
+
+#include "binary_streams.hpp"
+#include "csdb/address.hpp"
+#include "csdb/currency.hpp"
+#include "csdb/transaction.hpp"
+
+namespace csdb {
+
+namespace {
+// serialized user field is id, type and value, value size depends on type
+constexpr size_t kUserFieldHeaderSize = sizeof(user_field_id_t) + sizeof(UserField::Type);
+constexpr size_t kAmountSize = sizeof(int32_t) + sizeof(uint64_t);
+
+struct UserFieldBinary {
+    user_field_id_t id = 0;
+    UserField::Type type = UserField::Unknown;
+    const cs::Byte* value = nullptr;
+    size_t valueSize = 0;
+};
+
+// returns size of serialized field or 0 if data is not a valid field
+size_t parseUserField(const cs::Byte* data, size_t size, UserFieldBinary& field) {
+    if (size < kUserFieldHeaderSize) {
+        return 0;
+    }
+
+    std::memcpy(&field.id, data, sizeof(field.id));
+    std::memcpy(&field.type, data + sizeof(field.id), sizeof(field.type));
+
+    field.value = data + kUserFieldHeaderSize;
+    size -= kUserFieldHeaderSize;
+
+    switch (field.type) {
+        case UserField::Integer:
+            field.valueSize = sizeof(uint64_t);
+            break;
+
+        case UserField::String: {
+            uint32_t length = 0;
+
+            if (size < sizeof(length)) {
+                return 0;
+            }
+
+            std::memcpy(&length, field.value, sizeof(length));
+            field.valueSize = sizeof(length) + length;
+            break;
+        }
+
+        case UserField::Amount:
+            field.valueSize = kAmountSize;
+            break;
+
+        default:
+            return 0;
+    }
+
+    if (field.valueSize > size) {
+        return 0;
+    }
+
+    return kUserFieldHeaderSize + field.valueSize;
+}
+
+template <typename Func>
+void forEachUserField(cs::BytesView fields, Func func) {
+    auto data = fields.data();
+    size_t size = fields.size();
+
+    UserFieldBinary field;
+
+    while (size > 0) {
+        const size_t fieldSize = parseUserField(data, size, field);
+
+        if (fieldSize == 0 || !func(field)) {
+            break;
+        }
+
+        data += fieldSize;
+        size -= fieldSize;
+    }
+}
+}  // namespace
+
+Address AddressView::to_address() const {
+    return is_wallet_id_ ? Address::from_wallet_id(wallet_id_) : Address::from_public_key(public_key_);
+}
+
+bool AddressView::operator==(const Address& other) const noexcept {
+    if (is_wallet_id_ != other.is_wallet_id()) {
+        return false;
+    }
+
+    return is_wallet_id_ ? wallet_id_ == other.wallet_id() : public_key_ == other.public_key();
+}
+
+UserField TransactionView::user_field(user_field_id_t id) const {
+    UserField result;
+
+    forEachUserField(user_fields_binary(), [&](const UserFieldBinary& field) {
+        if (field.id < id) {
+            return true;
+        }
+
+        if (field.id == id) {
+            ::csdb::priv::ibstream is(field.value - sizeof(field.type), field.valueSize + sizeof(field.type));
+            is.get(result);
+        }
+
+        return false;
+    });
+
+    return result;
+}
+
+std::vector<uint8_t> TransactionView::to_byte_stream_for_sig() const {
+    if (!is_valid_) {
+        return std::vector<uint8_t>();
+    }
+
+    ::csdb::priv::obstream os;
+
+    // signed part precedes user fields
+    const auto fieldsOffset = static_cast<size_t>(user_fields_ - binary_) - sizeof(user_fields_count_);
+    os.put(binary_, fieldsOffset);
+
+    // only custom fields are signed, they are ordered by id, so follow the standard ones
+    uint8_t count = 0;
+    const auto countPosition = os.buffer().size();
+    os.put(count);
+
+    forEachUserField(user_fields_binary(), [&](const UserFieldBinary& field) {
+        if (field.id >= 0) {
+            os.put(field.value, field.valueSize);
+            ++count;
+        }
+
+        return true;
+    });
+
+    auto result = os.buffer();
+    result[countPosition] = count;
+
+    return result;
+}
+
+Transaction TransactionView::to_transaction() const {
+    Transaction result;
+    ::csdb::priv::ibstream is(binary_, binary_size_);
+
+    if (!is_valid_ || !result.get(is)) {
+        return Transaction();
+    }
+
+    return result;
+}
+
+size_t TransactionView::read(const cs::Byte* data, size_t size) {
+    ::csdb::priv::ibstream is(data, size);
+
+    if (!get(is)) {
+        return 0;
+    }
+
+    return size - is.size();
+}
+
+bool TransactionView::get(::csdb::priv::ibstream& is) {
+    is_valid_ = false;
+    binary_ = static_cast<const cs::Byte*>(is.data());
+
+    const size_t size = is.size();
+    uint16_t lo = 0;
+    uint32_t hi = 0;
+
+    if (!is.get(lo) || !is.get(hi)) {
+        return false;
+    }
+
+    innerID_ = static_cast<int64_t>((static_cast<uint64_t>(hi) & 0x3fffffff) << 16 | lo);
+    source_.is_wallet_id_ = (hi & 0x80000000) != 0;
+    target_.is_wallet_id_ = (hi & 0x40000000) != 0;
+
+    for (auto address : {&source_, &target_}) {
+        if (!(address->is_wallet_id_ ? is.get(address->wallet_id_) : is.get(address->public_key_))) {
+            return false;
+        }
+    }
+
+    if (!is.get(amount_) || !is.get(max_fee_) || !is.get(currency_) || !is.get(user_fields_count_)) {
+        return false;
+    }
+
+    user_fields_ = static_cast<const cs::Byte*>(is.data());
+
+    for (uint8_t i = 0; i < user_fields_count_; ++i) {
+        UserFieldBinary field;
+        const size_t fieldSize = parseUserField(static_cast<const cs::Byte*>(is.data()), is.size(), field);
+
+        if (fieldSize == 0 || !is.skip(fieldSize)) {
+            return false;
+        }
+    }
+
+    user_fields_size_ = static_cast<uint32_t>(static_cast<const cs::Byte*>(is.data()) - user_fields_);
+
+    if (!is.get(signature_) || !is.get(counted_fee_)) {
+        return false;
+    }
+
+    binary_size_ = size - is.size();
+    is_valid_ = true;
+
+    return true;
+}
+
+}  // namespace csdb
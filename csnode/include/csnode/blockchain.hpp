@@ -1,10 +1,12 @@
 #ifndef BLOCKCHAIN_HPP
 #define BLOCKCHAIN_HPP
 
+#include <deque>
 #include <list>
 #include <map>
 #include <memory>
 #include <mutex>
+#include <optional>
 #include <vector>
 
 #include <fstream>
@@ -20,6 +22,7 @@
 #include <csdb/storage.hpp>
 
 #include <csdb/internal/types.hpp>
+#include <csnode/blockhashes.hpp>
 #include <csnode/nodecore.hpp>
 #include <csnode/walletscache.hpp>
 #include <csnode/walletsids.hpp>
@@ -29,6 +32,7 @@
 
 #include <condition_variable>
 #include <mutex>
+#include <thread>
 
 namespace cs {
 class BlockHashes;
@@ -42,6 +46,9 @@ using StoreBlockSignal = cs::Signal<void(const csdb::Pool&)>;
 /** @brief   The write block or remove block signal emits when block is flushed to disk */
 using ChangeBlockSignal = cs::Signal<void(const cs::Sequence)>;
 using ReadBlockSignal = csdb::ReadBlockSignal;
+
+/** @brief   The write failed signal emits from storage write thread when queued blocks can't be written */
+using WriteFailedSignal = csdb::WriteFailedSignal;
 }  // namespace cs
 
 class BlockChain {
@@ -125,6 +132,8 @@ public:
 
     // storage adaptor
     void close();
+    void setGroupCommit(size_t maxBlocks, size_t maxBytes);
+    csdb::Storage::WriteStats getWriteStats() const;
     bool getTransaction(const csdb::Address& addr, const int64_t& innerId, csdb::Transaction& result) const;
 
 public:
@@ -182,18 +191,31 @@ public signals:
 
     const cs::ReadBlockSignal& readBlockEvent() const;
 
+    /** @brief The write failed event. Raised by storage write thread in group commit mode if blocks starting from sequence
+     *  are not written after retries, storage doesn't accept next blocks then */
+    const cs::WriteFailedSignal& writeFailedEvent() const;
+
 public slots:
 
     // prototype is void (csdb::Transaction)
     // subscription is placed in SmartContracts constructor
     void onPayableContractReplenish(const csdb::Transaction& starter) {
+        const auto sequence = getLastSequence();
+        std::lock_guard lock(cacheMutex_);
         this->walletsCacheUpdater_->invokeReplenishPayableContract(starter);
+        this->walletsCacheStorage_->publishSnapshot(sequence);
     }
     void onPayableContractTimeout(const csdb::Transaction& starter) {
+        const auto sequence = getLastSequence();
+        std::lock_guard lock(cacheMutex_);
         this->walletsCacheUpdater_->rollbackReplenishPayableContract(starter);
+        this->walletsCacheStorage_->publishSnapshot(sequence);
     }
     void onContractEmittedAccepted(const csdb::Transaction& emitted, const csdb::Transaction& starter) {
+        const auto sequence = getLastSequence();
+        std::lock_guard lock(cacheMutex_);
         this->walletsCacheUpdater_->smartSourceTransactionReleased(emitted, starter);
+        this->walletsCacheStorage_->publishSnapshot(sequence);
     }
 
 public:
@@ -203,8 +225,12 @@ public:
     csdb::Pool loadBlock(const csdb::PoolHash&) const;
     csdb::Pool loadBlock(const cs::Sequence sequence) const;
     csdb::Pool loadBlockMeta(const csdb::PoolHash&, size_t& cnt) const;
+    // serialized block as stored in db, empty if block is absent
+    cs::Bytes loadBlockRaw(const cs::Sequence sequence) const;
     csdb::Transaction loadTransaction(const csdb::TransactionID&) const;
     void iterateOverWallets(const std::function<bool(const cs::WalletsCache::WalletData::Address&, const cs::WalletsCache::WalletData&)>);
+    // page of wallets with non negative balance in requested order
+    void getRankedWallets(cs::WalletsRanking::Order order, bool desc, uint64_t offset, uint64_t limit, std::vector<WalletData>& wallets) const;
     csdb::Pool getLastBlock() const {
         return loadBlock(getLastSequence());
     }
@@ -222,7 +248,7 @@ public:
     bool findWalletData(const csdb::Address&, WalletData& wallData, WalletId& id) const;
     bool findWalletData(WalletId id, WalletData& wallData) const;
     bool findWalletId(const WalletAddress& address, WalletId& id) const;
-    // wallet transactions: pools cache + db search
+    // wallet transactions newest first: address index + blocks not indexed yet if TRANSACTIONS_INDEX, db search otherwise
     void getTransactions(Transactions& transactions, csdb::Address address, uint64_t offset, uint64_t limit);
     // wallets modified by last new block
     bool getModifiedWallets(Mask& dest) const;
@@ -252,6 +278,19 @@ private:
     void writeGenesisBlock();
 #ifdef TRANSACTIONS_INDEX
     void createTransactionsIndex(csdb::Pool&);
+
+    // per address list of (sequence, index), lets wallet history be paged without reading blocks;
+    // changes of finalized and removed blocks are written by index thread, so it may lag behind the chain
+    struct AddressIndexUpdate;
+
+    void createAddressIndex(const csdb::Pool&);
+    void removeAddressIndex(const csdb::Pool&);
+    void updateAddressIndex();
+    AddressIndexUpdate addressIndexOf(const csdb::Pool& pool, bool remove) const;
+    void pushAddressIndex(AddressIndexUpdate&& update);
+    void addressIndexRoutine();
+    void writeAddressIndex(const AddressIndexUpdate& update);
+    void stopAddressIndex();
 #endif
 
     void logBlockInfo(csdb::Pool& pool);
@@ -295,6 +334,7 @@ private:
     std::unique_ptr<cs::WalletsCache> walletsCacheStorage_;
     std::unique_ptr<cs::WalletsCache::Updater> walletsCacheUpdater_;
     std::unique_ptr<cs::WalletsPools> walletsPools_;
+    // guards wallets cache writers and pools, wallet ids have own lock
     mutable cs::SpinLock cacheMutex_{ATOMIC_FLAG_INIT};
 
 #ifdef TRANSACTIONS_INDEX
@@ -307,6 +347,19 @@ private:
     std::map<csdb::PoolHash, NonEmptyBlockData> previousNonEmpty_;
 
     NonEmptyBlockData lastNonEmptyBlock_;
+
+    // addresses in public key form, positions are empty if block is removed
+    struct AddressIndexUpdate {
+        cs::Sequence sequence = 0;
+        bool remove = false;
+        std::map<csdb::Address, std::vector<uint32_t>> positions;
+    };
+
+    std::thread addressIndexThread_;
+    std::mutex addressIndexLock_;
+    std::condition_variable addressIndexCondVar_;
+    std::deque<AddressIndexUpdate> addressIndexQueue_;
+    bool addressIndexQuit_ = false;
 #endif
 
     /**
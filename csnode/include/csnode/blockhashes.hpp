@@ -2,6 +2,8 @@
 #define BLOCKHASHES_HPP
 
 #include <csdb/pool.hpp>
+
+#include <cstdint>
 #include <vector>
 
 namespace cs {
@@ -39,7 +41,17 @@ public:
     const std::vector<csdb::PoolHash>& getHashes() const;
 
 private:
+    // hash -> sequence index, open addressing with linear probing,
+    // slot stores position in hashes_ + 1, zero marks an empty slot
+    using IndexSlot = uint32_t;
+
+    void indexInsert(size_t position);
+    void indexErase(size_t position);
+    void indexRebuild(size_t capacity);
+    size_t indexCapacityFor(size_t count) const;
+
     std::vector<csdb::PoolHash> hashes_;
+    std::vector<IndexSlot> index_;
 
     DbStructure db_;
     bool isDbInited_;
@@ -0,0 +1,43 @@
+#ifndef BLOCKREPLYCACHE_HPP
+#define BLOCKREPLYCACHE_HPP
+
+#include <deque>
+#include <map>
+
+#include <csnode/nodecore.hpp>
+#include <lib/system/allocators.hpp>
+
+namespace cs {
+// compressed BlockRequest replies keyed by the first requested sequence,
+// the oldest replies are dropped first when it is full
+class BlockReplyCache {
+public:
+    struct Reply {
+        cs::PoolsRequestedSequences sequences;
+        // region is shared with replies being sent, so it is never changed
+        RegionPtr compressed;
+        std::size_t realBinSize = 0;
+    };
+
+    explicit BlockReplyCache(std::size_t capacity);
+
+    // returns nullptr if there is no reply to exactly these sequences
+    const Reply* find(const cs::PoolsRequestedSequences& sequences) const;
+    void insert(const Reply& reply);
+
+    // replies containing sequence or later blocks are dropped
+    void remove(cs::Sequence sequence);
+
+    std::size_t size() const {
+        return replies_.size();
+    }
+
+private:
+    const std::size_t capacity_;
+
+    std::map<cs::Sequence, Reply> replies_;
+    std::deque<cs::Sequence> order_;
+};
+}  // namespace cs
+
+#endif  // BLOCKREPLYCACHE_HPP
@@ -12,6 +12,7 @@
 
 namespace csdb {
 class Transaction;
+class Pool;
 }
 
 namespace cs {
@@ -77,6 +78,12 @@ public:
     ///
     const cs::PacketQueue& packetQueue() const;
 
+    ///
+    /// @brief Sets resolver of transaction source to the form mempool keys its chains by.
+    /// @param resolver Returns public key address for any form of source address.
+    ///
+    void setSourceResolver(cs::Mempool::SourceResolver resolver);
+
     ///
     /// @brief Returns pair of transactions packet created in current round and smart contract packets.
     /// @warning Slow-performance method. Thread safe.
@@ -291,6 +298,9 @@ public slots:
     /// try to send transactions packets to network
     void flushTransactions();
 
+    /// releases mempool transactions confirmed by stored block
+    void onBlockStored(const csdb::Pool& pool);
+
 protected:
     void removeHashesFromTable(const cs::PacketsHashes& hashes);
     cs::TransactionsPacketTable& poolTable(cs::RoundNumber round);
@@ -569,6 +569,33 @@ inline DataStream& operator>>(DataStream& stream, csdb::PoolHash& hash) {
     return stream;
 }
 
+inline DataStream& operator>>(DataStream& stream, csdb::Address& address) {
+    uint8_t isWalletId = 0;
+    stream >> isWalletId;
+
+    if (isWalletId) {
+        csdb::Address::WalletId id = 0;
+        stream >> id;
+        address = csdb::Address::from_wallet_id(id);
+    }
+    else {
+        cs::PublicKey key{};
+        stream >> key;
+        address = csdb::Address::from_public_key(key);
+    }
+
+    return stream;
+}
+
+inline DataStream& operator>>(DataStream& stream, csdb::TransactionID& id) {
+    csdb::PoolHash hash;
+    cs::Sequence index = 0;
+    stream >> hash >> index;
+
+    id = csdb::TransactionID(hash, index);
+    return stream;
+}
+
 inline DataStream& operator>>(DataStream& stream, csdb::Pool& pool) {
     cs::Bytes bytes;
     stream >> bytes;
@@ -700,6 +727,25 @@ inline DataStream& operator<<(DataStream& stream, const csdb::PoolHash& hash) {
     return stream;
 }
 
+inline DataStream& operator<<(DataStream& stream, const csdb::Address& address) {
+    const uint8_t isWalletId = address.is_wallet_id();
+    stream << isWalletId;
+
+    if (isWalletId) {
+        stream << address.wallet_id();
+    }
+    else {
+        stream << address.public_key();
+    }
+
+    return stream;
+}
+
+inline DataStream& operator<<(DataStream& stream, const csdb::TransactionID& id) {
+    stream << id.pool_hash() << id.index();
+    return stream;
+}
+
 inline DataStream& operator<<(DataStream& stream, const csdb::Pool& pool) {
     uint32_t bSize;
     auto dataPtr = const_cast<csdb::Pool&>(pool).to_byte_stream(bSize);
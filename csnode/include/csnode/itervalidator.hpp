@@ -6,6 +6,7 @@
 #include <vector>
 
 #include <csnode/nodecore.hpp>
+#include <csnode/nodeutils.hpp>
 #include <csnode/transactionsvalidator.hpp>
 #include <lib/system/common.hpp>
 
@@ -27,7 +28,10 @@ private:
 
     void checkSignaturesSmartSource(SolverContext&, Packets& smartContractsPackets);
     void checkTransactionsSignatures(SolverContext& context, const Transactions& transactions, Bytes& characteristicMask, Packets& smartsPackets);
-    bool checkTransactionSignature(SolverContext& context, const csdb::Transaction& transaction);
+
+    // returns false if signature is checked by smart contracts rules, otherwise fills message to verify
+    bool prepareSignatureCheck(SolverContext& context, const csdb::Transaction& transaction, NodeUtils::SignedMessage& message);
+    bool checkSmartTransactionSignature(const csdb::Transaction& transaction);
 
     bool deployAdditionalCheck(SolverContext& context, size_t trxInd, const csdb::Transaction& transaction);
 
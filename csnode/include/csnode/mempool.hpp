@@ -0,0 +1,165 @@
+#ifndef MEMPOOL_HPP
+#define MEMPOOL_HPP
+
+#include <deque>
+#include <functional>
+#include <map>
+#include <optional>
+#include <set>
+#include <vector>
+
+#include <csdb/address.hpp>
+#include <csdb/transaction.hpp>
+
+namespace cs {
+// pending transactions indexed by (source, inner id) and by fee per byte,
+// the cheapest transactions are evicted when capacity is reached
+class Mempool {
+public:
+    enum class Admission {
+        Admitted,
+        Duplicate,
+        Conflict,
+        Rejected
+    };
+
+    struct Stats {
+        uint64_t admitted = 0;
+        // exactly the same transaction is already pending, or inner id is already taken or confirmed
+        uint64_t duplicates = 0;
+        // other transaction with the same source and inner id is pending
+        uint64_t conflicts = 0;
+        // mempool is full and transaction is not more expensive than pending ones
+        uint64_t rejected = 0;
+        uint64_t evicted = 0;
+        uint64_t admissionNanoseconds = 0;
+
+        uint64_t attempts() const {
+            return admitted + duplicates + conflicts + rejected;
+        }
+
+        double duplicatesRate() const {
+            return attempts() != 0 ? static_cast<double>(duplicates) / static_cast<double>(attempts()) : 0.0;
+        }
+
+        double averageAdmissionNanoseconds() const {
+            return attempts() != 0 ? static_cast<double>(admissionNanoseconds) / static_cast<double>(attempts()) : 0.0;
+        }
+    };
+
+    // returns the form of source address transactions are keyed by,
+    // so one wallet given as public key and as wallet id makes one chain
+    using SourceResolver = std::function<csdb::Address(const csdb::Address&)>;
+
+    explicit Mempool(size_t capacity);
+
+    void setSourceResolver(SourceResolver resolver);
+
+    Admission add(const csdb::Transaction& transaction);
+
+    // removes up to count transactions with the highest fee per byte,
+    // transactions of one source are taken by increasing inner id, the ones after a gap in inner ids
+    // wait until the missing transaction is added or confirmed
+    std::vector<csdb::Transaction> take(size_t count);
+
+    // transaction of source with inner id is stored to chain, so pending ones up to it are dropped
+    // and the next one may be taken
+    void confirm(const csdb::Address& source, int64_t innerId);
+
+    // chains without pending transactions are kept to know the inner id expected next,
+    // they are forgotten if nothing is confirmed or added for ExpireRounds rounds
+    static constexpr uint64_t ExpireRounds = 10;
+    void nextRound();
+
+    // calls func for pending transactions while it returns true
+    void forEach(const std::function<bool(const csdb::Transaction&)>& func) const;
+
+    size_t size() const {
+        return size_;
+    }
+
+    bool isEmpty() const {
+        return size_ == 0;
+    }
+
+    // sources with pending transactions or waiting for confirmation of taken ones
+    size_t chainsCount() const {
+        return chains_.size();
+    }
+
+    const Stats& stats() const {
+        return stats_;
+    }
+
+private:
+    struct Entry {
+        csdb::Transaction transaction;
+        double feePerByte = 0;
+        uint64_t order = 0;
+    };
+
+    // inner id to entry
+    using Entries = std::map<int64_t, Entry>;
+
+    struct Chain {
+        Entries entries;
+        // inner id of the last taken or confirmed transaction, unknown until the first one
+        std::optional<int64_t> lastInnerId;
+        // round the last transaction left the chain at
+        uint64_t emptySince = 0;
+    };
+
+    // the cheapest and the latest transaction goes first
+    struct FeeKey {
+        double feePerByte;
+        uint64_t order;
+        csdb::Address source;
+        int64_t innerId;
+
+        bool operator<(const FeeKey& other) const {
+            if (feePerByte != other.feePerByte) {
+                return feePerByte < other.feePerByte;
+            }
+
+            return order > other.order;
+        }
+    };
+
+    static FeeKey keyOf(const csdb::Address& source, const Entries::value_type& entry);
+
+    csdb::Address sourceOf(const csdb::Address& address) const;
+
+    Admission admit(const csdb::Transaction& transaction);
+
+    // the first transaction of chain becomes a head if it follows the last taken or confirmed one
+    void insertHead(const csdb::Address& source, const Chain& chain);
+
+    // evicts the cheapest transaction with the following transactions of the same source
+    void evict();
+
+    // empty chain is scheduled to be forgotten
+    void expireLater(const csdb::Address& source, Chain& chain);
+
+    const size_t capacity_;
+    size_t size_ = 0;
+    uint64_t order_ = 0;
+
+    SourceResolver resolver_;
+
+    std::map<csdb::Address, Chain> chains_;
+
+    // empty chains by the round they became empty at, checked when rounds pass
+    uint64_t round_ = 0;
+    std::deque<std::pair<uint64_t, csdb::Address>> expiring_;
+
+    // all transactions
+    std::set<FeeKey> byFee_;
+
+    // transactions with the lowest inner id of their source, unless they are after a gap
+    std::set<FeeKey> heads_;
+
+    Stats stats_;
+};
+}  // namespace cs
+
+#endif  // MEMPOOL_HPP
@@ -9,6 +9,7 @@
 #include <csconnector/csconnector.hpp>
 #include <csstats.hpp>
 
+#include <csnode/blockreplycache.hpp>
 #include <csnode/conveyer.hpp>
 #include <lib/system/timer.hpp>
 
@@ -162,7 +163,7 @@ public:
     // smarts consensus additional functions:
 
     // syncro send functions
-    void sendBlockReply(const cs::PoolsBlock& poolsBlock, const cs::PublicKey& target, std::size_t packCounter);
+    void sendBlockReply(const cs::PoolsRequestedSequences& sequences, const cs::PublicKey& target, std::size_t packCounter);
 
     void flushCurrentTasks();
     void becomeWriter();
@@ -242,6 +243,8 @@ public slots:
     void onPingReceived(cs::Sequence sequence, const cs::PublicKey& sender);
     void sendBlockRequest(const ConnectionPtr target, const cs::PoolsRequestedSequences& sequences, std::size_t packCounter);
     void validateBlock(csdb::Pool block, bool* shouldStop);
+    void onRemoveBlock(const cs::Sequence sequence);
+    void onWriteFailed(const cs::Sequence sequence, size_t count);
 
 private:
     bool init(const Config& config);
@@ -302,7 +305,8 @@ private:
     template <typename... Args>
     void writeDefaultStream(Args&&... args);
 
-    RegionPtr compressPoolsBlock(const cs::PoolsBlock& poolsBlock, std::size_t& realBinSize);
+    // compressed BlockRequest reply assembled from stored blocks bytes
+    bool prepareBlockReply(const cs::PoolsRequestedSequences& sequences, cs::BlockReplyCache::Reply& reply);
     cs::PoolsBlock decompressPoolsBlock(const uint8_t* data, const size_t size);
 
     // TODO: C++ 17 static inline?
@@ -336,6 +340,9 @@ private:
     RegionAllocator allocator_;
     RegionAllocator packStreamAllocator_;
 
+    static const std::size_t blockReplyCacheSize_ = 256;
+    cs::BlockReplyCache blockReplyCache_{blockReplyCacheSize_};
+
     uint32_t startPacketRequestPoint_ = 0;
 
     // ms timeout
@@ -13,6 +13,7 @@
 
 #include <lib/system/common.hpp>
 #include <lib/system/metastorage.hpp>
+#include <lib/system/structures.hpp>
 
 namespace std {
 // transactions packet hash specialization
@@ -24,7 +25,7 @@ struct hash<cs::TransactionsPacketHash> {
 
 namespace cs {
 // table for fast transactions storage
-using TransactionsPacketTable = std::map<TransactionsPacketHash, TransactionsPacket>;  // TODO: check performance of map/unordered_map
+using TransactionsPacketTable = OpenHashMap<TransactionsPacketHash, TransactionsPacket>;
 
 // array of packets
 using TransactionsBlock = std::vector<cs::TransactionsPacket>;
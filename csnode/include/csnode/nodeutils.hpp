@@ -10,6 +10,16 @@ class Pool;
 namespace cs {
 class NodeUtils {
 public:
+    // signature with its key and signed data for batch verification
+    struct SignedMessage {
+        cs::Signature signature;
+        cs::PublicKey publicKey;
+        cs::Bytes message;
+    };
+
+    // verifies signatures not found in SignatureCache in thread pool, result[i] is 1 if messages[i] signature is valid, 0 otherwise
+    static cs::Bytes verifySignatures(const std::vector<SignedMessage>& messages);
+
     static bool checkGroupSignature(const cs::ConfidantsKeys& confidants, const cs::Bytes& mask, const cs::Signatures& signatures, const cs::Hash& hash);
     static size_t realTrustedValue(const cs::Bytes& mask);
     static cs::Bytes getTrustedMask(const csdb::Pool& block);
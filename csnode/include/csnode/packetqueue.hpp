@@ -2,13 +2,16 @@
 #define PACKETQUEUE_HPP
 
 #include <deque>
+#include <functional>
 #include <optional>
 
+#include <csnode/mempool.hpp>
 #include <csnode/nodecore.hpp>
 #include <boost/noncopyable.hpp>
 
 namespace cs {
-// implements business logic for transpaction packet
+// implements business logic for transpaction packet,
+// single transactions wait in mempool and packets of them are built in fee order
 class PacketQueue : public boost::noncopyable {
 public:
     explicit PacketQueue(size_t queueSize, size_t transactionsSize, size_t packetsPerRound);
@@ -19,17 +22,24 @@ public:
 
     cs::TransactionsBlock pop();
 
-    std::deque<cs::TransactionsPacket>::const_iterator begin() const;
-    std::deque<cs::TransactionsPacket>::const_iterator end() const;
+    // transactions of stored block are not expected from mempool anymore
+    void confirmTransactions(const csdb::Pool& pool);
+    void setSourceResolver(Mempool::SourceResolver resolver);
 
+    // calls func for transactions of separate packets and mempool while it returns true
+    void forEachTransaction(const std::function<bool(const csdb::Transaction&)>& func) const;
+
+    // count of packets to be popped
     size_t size() const;
+    size_t transactionsCount() const;
     bool isEmpty() const;
-    std::deque<cs::TransactionsPacket>::const_reference back() const;
+
+    const Mempool::Stats& mempoolStats() const;
 
 private:
     std::deque<cs::TransactionsPacket> queue_;
+    Mempool mempool_;
 
-    size_t maxQueueSize_;
     size_t maxTransactionsSize_;
     size_t maxPacketsPerRound_;
 
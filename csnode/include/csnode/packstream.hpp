@@ -195,9 +195,11 @@ public:
         delete[] packets_;
     }
 
-    void init(cs::Byte flags) {
+    // packetSize is the fragment size, receiver should accept it
+    void init(cs::Byte flags, uint32_t packetSize = Packet::MaxSize) {
         clear();
         ++id_;
+        packetSize_ = packetSize;
 
         newPack();
 
@@ -350,7 +352,7 @@ private:
             }
         }
 
-        new (packetsEnd_) Packet(allocator_->allocateNext(Packet::MaxSize));
+        new (packetsEnd_) Packet(allocator_->allocateNext(packetSize_));
 
         ptr_ = static_cast<cs::Byte*>(packetsEnd_->data());
         end_ = ptr_ + packetsEnd_->size();
@@ -396,6 +398,7 @@ private:
     cs::Byte* end_ = nullptr;
 
     RegionAllocator* allocator_;
+    uint32_t packetSize_ = Packet::MaxSize;
 
     Packet* packets_;
     uint16_t packetsCount_ = 0;
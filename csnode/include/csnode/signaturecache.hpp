@@ -0,0 +1,66 @@
+#ifndef SIGNATURECACHE_HPP
+#define SIGNATURECACHE_HPP
+
+#include <atomic>
+#include <mutex>
+
+#include <lib/system/common.hpp>
+#include <lib/system/hash.hpp>
+#include <lib/system/structures.hpp>
+
+namespace csdb {
+class Transaction;
+}
+
+namespace cs {
+class TransactionsPacket;
+
+// bounded thread safe storage of successfully verified signatures,
+// the oldest records are evicted when it is full
+class SignatureCache {
+public:
+    static constexpr uint32_t MaxSize = 100000;
+
+    // node uses the shared instance, separate ones are for tests
+    SignatureCache() = default;
+
+    static SignatureCache& instance();
+
+    // returns cached result if signature of message was verified before,
+    // otherwise verifies it and caches success
+    bool verify(const cs::Signature& signature, const cs::PublicKey& publicKey, const cs::Bytes& message);
+    bool verify(const csdb::Transaction& transaction, const cs::PublicKey& publicKey);
+
+    // verifies signatures of packet transactions and caches successes,
+    // transactions with wallet id sources are skipped as their keys are in blockchain
+    void verify(const cs::TransactionsPacket& packet);
+
+    // the same as verify of packet, but in thread pool
+    void preverify(const cs::TransactionsPacket& packet);
+
+    uint64_t hits() const {
+        return hits_.load(std::memory_order_relaxed);
+    }
+
+    uint64_t misses() const {
+        return misses_.load(std::memory_order_relaxed);
+    }
+
+protected:
+    // signature does not identify message, so key covers all of signed data
+    static cs::Hash keyOf(const cs::Signature& signature, const cs::PublicKey& publicKey, const cs::Bytes& message);
+
+    bool contains(const cs::Hash& key);
+    void store(const cs::Hash& key);
+
+private:
+
+    std::mutex mutex_;
+    FixedHashMap<cs::Hash, bool, uint64_t, MaxSize> verified_;
+
+    std::atomic<uint64_t> hits_ = {0};
+    std::atomic<uint64_t> misses_ = {0};
+};
+}  // namespace cs
+
+#endif  // SIGNATURECACHE_HPP
@@ -9,7 +9,7 @@
 
 namespace cs {
 ///
-/// Wrapper of std::vector<uint8_t> to represent hash
+/// Fixed size hash stored inline with precomputed hash table index
 ///
 class TransactionsPacketHash {
 public:  // Static interface
@@ -60,14 +60,34 @@ public:  // Interface
     /// @brief Coverts transactions packet hash to binary.
     /// @return vector of bytes
     ///
-    const cs::Bytes& toBinary() const noexcept;
+    cs::Bytes toBinary() const;
+
+    ///
+    /// @brief Returns hash bytes without copying, size() bytes are valid.
+    ///
+    const cs::Byte* data() const noexcept {
+        return m_bytes.data();
+    }
+
+    ///
+    /// @brief Returns non cryptographic hash for hash tables.
+    /// @return first bytes of hash, they are already uniformly distributed
+    ///
+    size_t calcHash() const noexcept {
+        return m_hash;
+    }
 
     bool operator==(const TransactionsPacketHash& other) const noexcept;
     bool operator!=(const TransactionsPacketHash& other) const noexcept;
     bool operator<(const TransactionsPacketHash& other) const noexcept;
 
+private:  // Service
+    void assign(const cs::Bytes& data);
+
 private:  // Members
-    cs::Bytes m_bytes;
+    cs::Hash m_bytes{};
+    size_t m_hash = 0;
+    bool m_isEmpty = true;
 };
 
 ///
@@ -9,9 +9,11 @@
 #include <csdb/transaction.hpp>
 #include <csnode/nodecore.hpp>
 #include <csnode/transactionstail.hpp>
+#include <csnode/walletsranking.hpp>
 #include <list>
 #include <map>
 #include <memory>
+#include <mutex>
 #include <vector>
 
 #include <lib/system/common.hpp>
@@ -60,6 +62,35 @@ public:
         csdb::Amount totalFee;
     };
 
+    // immutable copy of wallets published by writer, readers use it without locks
+    class Snapshot {
+    public:
+        static constexpr size_t ChunkSize = 256;
+
+        cs::Sequence sequence() const {
+            return sequence_;
+        }
+
+        size_t size() const {
+            return size_;
+        }
+
+        const WalletData* findWallet(WalletId id) const;
+        void iterateOverWallets(const std::function<bool(const WalletData::Address&, const WalletData&)>) const;
+
+    private:
+        // chunks not modified since previous snapshot are shared with it
+        using Chunk = std::vector<std::shared_ptr<const WalletData>>;
+
+        std::vector<std::shared_ptr<const Chunk>> chunks_;
+        size_t size_ = 0;
+        cs::Sequence sequence_ = 0;
+
+        friend class WalletsCache;
+    };
+
+    using SnapshotPtr = std::shared_ptr<const Snapshot>;
+
 public:
     static void convert(const csdb::Address& address, WalletData::Address& walletAddress);
     static void convert(const WalletData::Address& walletAddress, csdb::Address& address);
@@ -74,6 +105,16 @@ public:
         return wallets_.size();
     }
 
+    // last published state, may be called concurrently with writer
+    SnapshotPtr snapshot() const;
+
+    // publishes wallets modified since previous call, caller must exclude other writers
+    void publishSnapshot(cs::Sequence sequence);
+
+    // ids of ranked wallets in requested order and snapshot consistent with them
+    SnapshotPtr rankWallets(WalletsRanking::Order order, bool desc, size_t offset, size_t limit, std::vector<WalletId>& ids) const;
+    size_t rankedCount() const;
+
 private:
     using Data = std::vector<WalletData*>;
 
@@ -90,6 +131,8 @@ private:
         void load(csdb::Pool& curr, const cs::ConfidantsKeys& confidants, const BlockChain& blockchain);
         double load(const csdb::Transaction& tr, const BlockChain& blockchain);
         double loadTrxForSource(const csdb::Transaction& tr, const BlockChain& blockchain);
+        // plain transfer without user fields, so smart contracts rules are not applied
+        double loadTransfer(const csdb::TransactionView& view, const csdb::Pool& pool, size_t index);
         void fundConfidantsWalletsWithFee(const csdb::Amount& totalFee, const cs::ConfidantsKeys& confidants, const std::vector<uint8_t>& realTrusted);
         void loadTrxForTarget(const csdb::Transaction& tr);
         virtual WalletData& getWalletData(WalletId id, const csdb::Address& address) = 0;
@@ -170,6 +213,7 @@ public:
     std::unique_ptr<Initer> createIniter();
     std::unique_ptr<Updater> createUpdater();
 
+
 private:
     const Config config_;
     WalletsIds& walletsIds_;
@@ -178,6 +222,14 @@ private:
     std::list<csdb::Transaction> smartPayableTransactions_;
     std::list<csdb::Transaction> closedSmarts_;
 
+    SnapshotPtr snapshot_;
+    std::vector<WalletId> snapshotModified_;
+    bool snapshotOutdated_ = true;
+
+    // ranking is updated together with snapshot
+    WalletsRanking ranking_;
+    mutable std::mutex rankingMutex_;
+
 #ifdef MONITOR_NODE
     std::map<WalletData::Address, TrustedData> trusted_info_;
 #endif
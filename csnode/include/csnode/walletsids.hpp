@@ -5,10 +5,13 @@
 #include <memory>
 #include <type_traits>
 #include <unordered_map>
+#include <vector>
 #include "csdb/internal/types.hpp"
 
-namespace cs {
+#include <lib/system/common.hpp>
 
+namespace cs {
+// methods may be called concurrently: lookups share the lock, insertions and removals are exclusive
 class WalletsIds {
 public:
     using WalletId = csdb::internal::WalletId;
@@ -28,6 +31,8 @@ public:
         bool findAnyOrInsertSpecial(const WalletAddress& address, WalletId& id);
 
     private:
+        friend class WalletsIds;
+
         WalletsIds& norm_;
         WalletId nextIdSpecial_;
         static constexpr uint32_t maskSpecial_ = (1u << 31);
@@ -76,8 +81,14 @@ public:
     }
 
 private:
+    void setAddress(WalletId id, const WalletAddress& address);
+
     using Data = std::unordered_map<WalletAddress, WalletId>;
+
+    mutable cs::SharedMutex mutex_;
     Data data_;
+    // addresses of normal ids by id, invalid address marks a free id
+    std::vector<WalletAddress> addresses_;
     WalletId nextId_;
     std::unique_ptr<Special> special_;
     std::unique_ptr<Normal> norm_;
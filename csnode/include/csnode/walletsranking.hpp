@@ -0,0 +1,283 @@
+#ifndef WALLETSRANKING_HPP
+#define WALLETSRANKING_HPP
+
+#include <algorithm>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include <csdb/amount.hpp>
+#include <csdb/internal/types.hpp>
+
+namespace cs {
+
+// sorted set with access by position, values are stored in blocks of limited size
+// and block sizes are summed in fenwick tree, so both update and search of position are O(log n)
+template <typename T>
+class OrderedIndex {
+public:
+    static constexpr size_t BlockSize = 512;
+
+    void assign(std::vector<T> values);
+    void insert(const T& value);
+    bool erase(const T& value);
+
+    size_t size() const {
+        return size_;
+    }
+
+    // calls func for values starting from position offset while it returns true,
+    // in descending order positions are counted from the greatest value
+    template <typename Func>
+    void forEach(size_t offset, bool desc, Func func) const;
+
+    size_t memoryUsage() const;
+
+private:
+    size_t findBlock(const T& value) const;
+    std::pair<size_t, size_t> locate(size_t position) const;
+
+    void increaseCount(size_t block);
+    void decreaseCount(size_t block);
+    void rebuildCounts();
+
+    std::vector<std::vector<T>> blocks_;
+    std::vector<size_t> counts_;
+    size_t size_ = 0;
+};
+
+// wallets with non negative balance ordered by api columns,
+// updated with wallets modified by block instead of full scan on request
+class WalletsRanking {
+public:
+    using WalletId = csdb::internal::WalletId;
+
+    enum class Order : uint8_t {
+        Balance,
+        CreateTime,
+        TransactionsCount
+    };
+
+    struct Values {
+        csdb::Amount balance;
+        uint64_t createTime = 0;
+        uint64_t transactionsCount = 0;
+    };
+
+    // rebuilds all indexes
+    void reset(const std::vector<std::pair<WalletId, Values>>& wallets);
+
+    // values is nullptr if wallet is removed
+    void update(WalletId id, const Values* values);
+
+    // returns empty list for order not indexed in current build
+    std::vector<WalletId> get(Order order, bool desc, size_t offset, size_t limit) const;
+
+    size_t size() const {
+        return balance_.size();
+    }
+
+    size_t memoryUsage() const;
+
+private:
+    template <typename T>
+    using Index = OrderedIndex<std::pair<T, WalletId>>;
+
+    struct Entry {
+        Values values;
+        bool ranked = false;
+    };
+
+    static bool isRanked(const Values& values);
+
+    void insert(WalletId id, const Values& values);
+    void erase(WalletId id, const Values& values);
+
+    std::vector<Entry> entries_;
+
+    Index<csdb::Amount> balance_;
+#ifdef MONITOR_NODE
+    Index<uint64_t> createTime_;
+    Index<uint64_t> transactionsCount_;
+#endif
+};
+
+template <typename T>
+void OrderedIndex<T>::assign(std::vector<T> values) {
+    std::sort(values.begin(), values.end());
+
+    blocks_.clear();
+    size_ = values.size();
+
+    for (size_t begin = 0; begin < values.size(); begin += BlockSize) {
+        const size_t end = std::min(begin + BlockSize, values.size());
+        blocks_.emplace_back(values.begin() + static_cast<std::ptrdiff_t>(begin), values.begin() + static_cast<std::ptrdiff_t>(end));
+    }
+
+    rebuildCounts();
+}
+
+template <typename T>
+void OrderedIndex<T>::insert(const T& value) {
+    ++size_;
+
+    if (blocks_.empty()) {
+        blocks_.emplace_back(1, value);
+        rebuildCounts();
+        return;
+    }
+
+    const size_t index = findBlock(value);
+    auto& block = blocks_[index];
+    block.insert(std::lower_bound(block.begin(), block.end(), value), value);
+
+    if (block.size() < BlockSize * 2) {
+        increaseCount(index);
+        return;
+    }
+
+    // split is rare, so tree is simply rebuilt
+    std::vector<T> tail(block.begin() + static_cast<std::ptrdiff_t>(BlockSize), block.end());
+    block.resize(BlockSize);
+    blocks_.insert(blocks_.begin() + static_cast<std::ptrdiff_t>(index) + 1, std::move(tail));
+
+    rebuildCounts();
+}
+
+template <typename T>
+bool OrderedIndex<T>::erase(const T& value) {
+    if (blocks_.empty()) {
+        return false;
+    }
+
+    const size_t index = findBlock(value);
+    auto& block = blocks_[index];
+    auto it = std::lower_bound(block.begin(), block.end(), value);
+
+    if (it == block.end() || value < *it) {
+        return false;
+    }
+
+    block.erase(it);
+    --size_;
+
+    if (!block.empty()) {
+        decreaseCount(index);
+        return true;
+    }
+
+    blocks_.erase(blocks_.begin() + static_cast<std::ptrdiff_t>(index));
+    rebuildCounts();
+
+    return true;
+}
+
+template <typename T>
+template <typename Func>
+void OrderedIndex<T>::forEach(size_t offset, bool desc, Func func) const {
+    if (offset >= size_) {
+        return;
+    }
+
+    auto [block, index] = locate(desc ? size_ - 1 - offset : offset);
+
+    while (block < blocks_.size()) {
+        if (!func(blocks_[block][index])) {
+            return;
+        }
+
+        if (!desc) {
+            if (++index == blocks_[block].size()) {
+                ++block;
+                index = 0;
+            }
+        }
+        else if (index > 0) {
+            --index;
+        }
+        else if (block > 0) {
+            --block;
+            index = blocks_[block].size() - 1;
+        }
+        else {
+            return;
+        }
+    }
+}
+
+template <typename T>
+size_t OrderedIndex<T>::memoryUsage() const {
+    size_t result = blocks_.capacity() * sizeof(std::vector<T>) + counts_.capacity() * sizeof(size_t);
+
+    for (const auto& block : blocks_) {
+        result += block.capacity() * sizeof(T);
+    }
+
+    return result;
+}
+
+template <typename T>
+size_t OrderedIndex<T>::findBlock(const T& value) const {
+    auto it = std::lower_bound(blocks_.begin(), blocks_.end(), value, [](const std::vector<T>& block, const T& val) { return block.back() < val; });
+
+    if (it == blocks_.end()) {
+        return blocks_.size() - 1;
+    }
+
+    return static_cast<size_t>(it - blocks_.begin());
+}
+
+template <typename T>
+std::pair<size_t, size_t> OrderedIndex<T>::locate(size_t position) const {
+    size_t mask = 1;
+
+    while (mask * 2 <= counts_.size()) {
+        mask *= 2;
+    }
+
+    size_t block = 0;
+
+    for (; mask > 0; mask /= 2) {
+        const size_t next = block + mask;
+
+        if (next <= counts_.size() && counts_[next - 1] <= position) {
+            block = next;
+            position -= counts_[next - 1];
+        }
+    }
+
+    return std::make_pair(block, position);
+}
+
+template <typename T>
+void OrderedIndex<T>::increaseCount(size_t block) {
+    for (size_t i = block + 1; i <= counts_.size(); i += i & (~i + 1)) {
+        ++counts_[i - 1];
+    }
+}
+
+template <typename T>
+void OrderedIndex<T>::decreaseCount(size_t block) {
+    for (size_t i = block + 1; i <= counts_.size(); i += i & (~i + 1)) {
+        --counts_[i - 1];
+    }
+}
+
+template <typename T>
+void OrderedIndex<T>::rebuildCounts() {
+    counts_.assign(blocks_.size(), 0);
+
+    for (size_t i = 1; i <= counts_.size(); ++i) {
+        counts_[i - 1] += blocks_[i - 1].size();
+
+        const size_t parent = i + (i & (~i + 1));
+
+        if (parent <= counts_.size()) {
+            counts_[parent - 1] += counts_[i - 1];
+        }
+    }
+}
+
+}  // namespace cs
+
+#endif  // WALLETSRANKING_HPP
@@ -34,6 +34,9 @@ BlockChain::BlockChain(csdb::Address genesisAddress, csdb::Address startAddress)
 }
 
 BlockChain::~BlockChain() {
+#ifdef TRANSACTIONS_INDEX
+    stopAddressIndex();
+#endif
 }
 
 bool BlockChain::init(const std::string& path) {
@@ -48,6 +51,10 @@ bool BlockChain::init(const std::string& path) {
         return false;
     };
 
+#ifdef TRANSACTIONS_INDEX
+    addressIndexThread_ = std::thread(&BlockChain::addressIndexRoutine, this);
+#endif
+
     if (!storage_.open(path, progress)) {
         cserror() << "Couldn't open database at " << path;
         return false;
@@ -67,6 +74,11 @@ bool BlockChain::init(const std::string& path) {
         if (!postInitFromDB()) {
             return false;
         }
+
+#ifdef TRANSACTIONS_INDEX
+        updateAddressIndex();
+#endif
+
         std::cout << "Done\n";
     }
 
@@ -136,11 +148,17 @@ bool BlockChain::postInitFromDB() {
         return true;
     };
     walletsCacheStorage_->iterateOverWallets(func);
+
+    const auto sequence = getLastSequence();
+    std::lock_guard lock(cacheMutex_);
+    walletsCacheStorage_->publishSnapshot(sequence);
     return true;
 }
 
 #ifdef TRANSACTIONS_INDEX
 void BlockChain::createTransactionsIndex(csdb::Pool& pool) {
+    createAddressIndex(pool);
+
 #ifdef RECREATE_INDEX
     static std::map<csdb::Address, csdb::PoolHash> lapoos;
 #endif
@@ -178,6 +196,142 @@ void BlockChain::createTransactionsIndex(csdb::Pool& pool) {
         lastNonEmptyBlock_.transCount = static_cast<uint32_t>(pool.transactions().size());
     }
 }
+
+void BlockChain::createAddressIndex(const csdb::Pool& pool) {
+    pushAddressIndex(addressIndexOf(pool, false));
+}
+
+void BlockChain::removeAddressIndex(const csdb::Pool& pool) {
+    // addresses are resolved before wallets of the block are removed from caches
+    pushAddressIndex(addressIndexOf(pool, true));
+}
+
+BlockChain::AddressIndexUpdate BlockChain::addressIndexOf(const csdb::Pool& pool, bool remove) const {
+    AddressIndexUpdate update;
+    update.sequence = pool.sequence();
+    update.remove = remove;
+
+    const auto& transactions = pool.transactions();
+    for (uint32_t i = 0; i < transactions.size(); ++i) {
+        for (const auto& addr : {transactions[i].source(), transactions[i].target()}) {
+            auto& indexes = update.positions[getAddressByType(addr, BlockChain::AddressType::PublicKey)];
+
+            if (!remove && (indexes.empty() || indexes.back() != i)) {
+                indexes.push_back(i);
+            }
+        }
+    }
+
+    return update;
+}
+
+void BlockChain::pushAddressIndex(AddressIndexUpdate&& update) {
+    {
+        std::lock_guard lock(addressIndexLock_);
+        addressIndexQueue_.push_back(std::move(update));
+    }
+
+    addressIndexCondVar_.notify_one();
+}
+
+void BlockChain::addressIndexRoutine() {
+    std::unique_lock lock(addressIndexLock_);
+
+    while (true) {
+        addressIndexCondVar_.wait(lock, [this]() { return addressIndexQuit_ || !addressIndexQueue_.empty(); });
+
+        if (addressIndexQueue_.empty()) {
+            return;
+        }
+
+        auto queue = std::move(addressIndexQueue_);
+        addressIndexQueue_.clear();
+        lock.unlock();
+
+        // updates are applied in order, so a removed block never outlives its own indexing
+        for (const auto& update : queue) {
+            writeAddressIndex(update);
+        }
+
+        lock.lock();
+    }
+}
+
+void BlockChain::writeAddressIndex(const AddressIndexUpdate& update) {
+    std::lock_guard lock(dbLock_);
+
+    // index sequence is written last: postings of a block are replaced on repeated write,
+    // so blocks not written before crash are indexed again on the next start
+    if (update.remove) {
+        for (const auto& [addr, indexes] : update.positions) {
+            storage_.remove_address_transactions(addr, update.sequence);
+        }
+
+        storage_.set_address_index_sequence(update.sequence - 1);
+        return;
+    }
+
+    for (const auto& [addr, indexes] : update.positions) {
+        if (!storage_.add_address_transactions(addr, update.sequence, indexes)) {
+            cserror() << "Blockchain: couldn't index transactions of block #" << update.sequence << " by address";
+            return;
+        }
+    }
+
+    storage_.set_address_index_sequence(update.sequence);
+}
+
+void BlockChain::stopAddressIndex() {
+    if (!addressIndexThread_.joinable()) {
+        return;
+    }
+
+    {
+        std::lock_guard lock(addressIndexLock_);
+        addressIndexQuit_ = true;
+    }
+
+    addressIndexCondVar_.notify_one();
+    addressIndexThread_.join();
+}
+
+void BlockChain::updateAddressIndex() {
+    cs::Sequence next = 0;
+
+    {
+        std::lock_guard lock(dbLock_);
+        cs::Sequence indexed = 0;
+
+        if (storage_.get_address_index_sequence(indexed)) {
+            next = indexed + 1;
+        }
+    }
+
+    const cs::Sequence last = getLastSequence();
+    if (next > last) {
+        return;
+    }
+
+    cslog() << "Blockchain: indexing transactions by address from block #" << WithDelimiters(next) << " to #" << WithDelimiters(last);
+
+    for (cs::Sequence sequence = next; sequence <= last; ++sequence) {
+        const auto pool = loadBlock(sequence);
+
+        if (!pool.is_valid()) {
+            cserror() << "Blockchain: couldn't load block #" << sequence << " to index it by address";
+            return;
+        }
+
+        // start is not consensus path, so catching up is written directly
+        writeAddressIndex(addressIndexOf(pool, false));
+
+        if (sequence % 1000 == 0) {
+            std::cout << '\r' << WithDelimiters(sequence);
+        }
+    }
+
+    cslog() << "\rBlockchain: transactions are indexed by address";
+}
 #endif
 
 cs::Sequence BlockChain::getLastSequence() const {
@@ -232,8 +386,7 @@ void BlockChain::writeGenesisBlock() {
 }
 
 void BlockChain::iterateOverWallets(const std::function<bool(const cs::WalletsCache::WalletData::Address&, const cs::WalletsCache::WalletData&)> func) {
-    std::lock_guard lock(cacheMutex_);
-    walletsCacheStorage_->iterateOverWallets(func);
+    walletsCacheStorage_->snapshot()->iterateOverWallets(func);
 }
 
 #ifdef MONITOR_NODE
@@ -243,14 +396,17 @@ void BlockChain::iterateOverWriters(const std::function<bool(const cs::WalletsCa
 }
 
 void BlockChain::applyToWallet(const csdb::Address& addr, const std::function<void(const cs::WalletsCache::WalletData&)> func) {
-    std::lock_guard lock(cacheMutex_);
     WalletId id;
-    if (!walletIds_->normal().find(addr, id)) {
+    if (!findWalletId(addr, id)) {
         return;
     }
-    auto wd = walletsCacheUpdater_->findWallet(id);
 
-    func(*wd);
+    const auto snapshot = walletsCacheStorage_->snapshot();
+    auto wd = snapshot->findWallet(id);
+
+    if (wd) {
+        func(*wd);
+    }
 }
 #endif
 
@@ -298,6 +454,20 @@ csdb::Pool BlockChain::loadBlock(const cs::Sequence sequence) const {
     return storage_.pool_load(sequence + 1);
 }
 
+cs::Bytes BlockChain::loadBlockRaw(const cs::Sequence sequence) const {
+    std::lock_guard lock(dbLock_);
+
+    if (deferredBlock_.is_valid() && deferredBlock_.sequence() == sequence) {
+        return deferredBlock_.to_binary();
+    }
+
+    if (sequence > getLastSequence()) {
+        return cs::Bytes{};
+    }
+
+    return storage_.pool_load_raw(sequence + 1);
+}
+
 csdb::Pool BlockChain::loadBlockMeta(const csdb::PoolHash& ph, size_t& cnt) const {
     std::lock_guard lock(dbLock_);
 
@@ -372,6 +542,7 @@ void BlockChain::removeLastBlock() {
 
 #ifdef TRANSACTIONS_INDEX
     total_transactions_count_ -= pool.transactions().size();
+    removeAddressIndex(pool);
 #endif
 
     removeWalletsInPoolFromCache(pool);
@@ -535,18 +706,20 @@ csdb::PoolHash BlockChain::getHashBySequence(cs::Sequence seq) const {
 }
 
 uint64_t BlockChain::getWalletsCountWithBalance() {
-    std::lock_guard lock(cacheMutex_);
+    return walletsCacheStorage_->rankedCount();
+}
+
+void BlockChain::getRankedWallets(cs::WalletsRanking::Order order, bool desc, uint64_t offset, uint64_t limit, std::vector<WalletData>& wallets) const {
+    std::vector<WalletId> ids;
+    const auto snapshot = walletsCacheStorage_->rankWallets(order, desc, offset, limit, ids);
 
-    uint64_t count = 0;
-    auto proc = [&](const WalletData::Address& addr, const WalletData& wallet) {
-        constexpr csdb::Amount zero_balance(0);
-        if (!addr.empty() && wallet.balance_ >= zero_balance) {
-            count++;
+    wallets.reserve(wallets.size() + ids.size());
+
+    for (auto id : ids) {
+        if (const WalletData* wallet = snapshot->findWallet(id)) {
+            wallets.push_back(*wallet);
         }
-        return true;
-    };
-    walletsCacheStorage_->iterateOverWallets(proc);
-    return count;
+    }
 }
 
 class BlockChain::TransactionsLoader {
@@ -573,15 +746,17 @@ public:
         if (curr.transactions_count()) {
             bool hasMyTransactions = false;
 
-            for (auto trans : curr.transactions()) {
+            const auto views = curr.transaction_views();
+
+            for (size_t i = 0; i < views.size(); ++i) {
                 if (transactions_.size() == limit)
                     break;
 
-                if (trans.target() == wallPubKey_ || trans.source() == wallPubKey_) {
+                if (views[i].target() == wallPubKey_ || views[i].source() == wallPubKey_) {
                     hasMyTransactions = true;
 
                     if (offset == 0)
-                        transactions_.push_back(trans);
+                        transactions_.push_back(curr.transaction(views[i], i));
                     else
                         --offset;
                 }
@@ -606,6 +781,73 @@ private:
 };
 
 void BlockChain::getTransactions(Transactions& transactions, csdb::Address address, uint64_t offset, uint64_t limit) {
+#ifdef TRANSACTIONS_INDEX
+    const auto key = getAddressByType(address, BlockChain::AddressType::PublicKey);
+    const auto walletId = getAddressByType(address, BlockChain::AddressType::Id);
+
+    auto isOwn = [&key, &walletId](const csdb::AddressView& addr) {
+        return addr == key || addr == walletId;
+    };
+
+    // index thread writes under dbLock_, so indexed sequence and postings don't change until the page is read
+    std::lock_guard lock(dbLock_);
+
+    cs::Sequence indexed = 0;
+    const cs::Sequence from = storage_.get_address_index_sequence(indexed) ? indexed + 1 : 0;
+
+    // the latest blocks may be not indexed yet by the index thread, they hold the newest transactions
+    for (cs::Sequence sequence = getLastSequence() + 1; sequence-- > from && limit > 0;) {
+        const csdb::Pool pool = loadBlock(sequence);
+
+        if (!pool.is_valid()) {
+            continue;
+        }
+
+        const auto views = pool.transaction_views();
+
+        for (size_t i = views.size(); i-- > 0 && limit > 0;) {
+            if (!isOwn(views[i].source()) && !isOwn(views[i].target())) {
+                continue;
+            }
+
+            if (offset > 0) {
+                --offset;
+                continue;
+            }
+
+            transactions.push_back(pool.transaction(views[i], i));
+            transactions.back().set_time(pool.get_time());
+            --limit;
+        }
+    }
+
+    if (limit == 0) {
+        return;
+    }
+
+    // postings of a block partially written before failure are not covered by indexed sequence
+    const auto positions = storage_.address_transactions(key, offset, limit, from);
+
+    // consecutive transactions of a wallet are often in the same block
+    csdb::Pool pool;
+
+    for (const auto& [sequence, index] : positions) {
+        if (!pool.is_valid() || pool.sequence() != sequence) {
+            pool = loadBlock(sequence);
+        }
+
+        csdb::Transaction transaction = pool.transaction(index);
+
+        // index may refer to a block which was replaced before it had been stored
+        if (!transaction.id().is_valid() || (!isEqual(transaction.source(), address) && !isEqual(transaction.target(), address))) {
+            cswarning() << "Blockchain: address index doesn't match block #" << sequence;
+            continue;
+        }
+
+        transaction.set_time(pool.get_time());
+        transactions.push_back(transaction);
+    }
+#else
     for (auto trIt = TransactionsIterator(*this, address); trIt.isValid(); trIt.next()) {
         if (offset > 0) {
             --offset;
@@ -618,6 +860,7 @@ void BlockChain::getTransactions(Transactions& transactions, csdb::Address addre
         if (--limit == 0)
             break;
     }
+#endif
 }
 
 bool BlockChain::findDataForTransactions(csdb::Address address, csdb::Address& wallPubKey, WalletId& id, WalletsPools::WalletData::PoolsHashes& hashesArray) const {
@@ -653,6 +896,12 @@ bool BlockChain::findDataForTransactions(csdb::Address address, csdb::Address& w
 
 void BlockChain::getTransactions(Transactions& transactions, csdb::Address wallPubKey, WalletId id, const WalletsPools::WalletData::PoolsHashes& hashesArray, uint64_t offset,
                                  uint64_t limit) {
+#ifdef TRANSACTIONS_INDEX
+    // pools cache is not needed if wallet transactions are found by address index
+    csunused(id);
+    csunused(hashesArray);
+    getTransactions(transactions, wallPubKey, offset, limit);
+#else
     bool isToLoadWalletsPoolsCache = hashesArray.empty() && wallPubKey != genesisAddress_ && wallPubKey != startAddress_;
     if (wallPubKey.is_public_key()) {
         WalletId _id;
@@ -694,6 +943,7 @@ void BlockChain::getTransactions(Transactions& transactions, csdb::Address wallP
             break;
         }
     }
+#endif
 }
 
 template <typename WalletCacheProcessor>
@@ -802,10 +1052,23 @@ void BlockChain::addNewWalletsToPool(csdb::Pool& pool) {
 }
 
 void BlockChain::close() {
+#ifdef TRANSACTIONS_INDEX
+    // index thread writes under dbLock_
+    stopAddressIndex();
+#endif
     cs::Lock lock(dbLock_);
     storage_.close();
 }
 
+void BlockChain::setGroupCommit(size_t maxBlocks, size_t maxBytes) {
+    cs::Lock lock(dbLock_);
+    storage_.set_group_commit(maxBlocks, maxBytes);
+}
+
+csdb::Storage::WriteStats BlockChain::getWriteStats() const {
+    return storage_.write_stats();
+}
+
 bool BlockChain::getTransaction(const csdb::Address& addr, const int64_t& innerId, csdb::Transaction& result) const {
     cs::Lock lock(dbLock_);
     return storage_.get_from_blockchain(addr, innerId, result);
@@ -823,6 +1086,7 @@ bool BlockChain::updateFromNextBlock(csdb::Pool& nextPool) {
         // currently block stores own round confidants, not next round:
         const auto& currentRoundConfidants = nextPool.confidants();
         walletsCacheUpdater_->loadNextBlock(nextPool, currentRoundConfidants, *this);
+        walletsCacheStorage_->publishSnapshot(nextPool.sequence());
         walletsPools_->loadNextBlock(nextPool);
         if (!blockHashes_->loadNextBlock(nextPool)) {
             cslog() << "Error writing DB structure";
@@ -845,8 +1109,7 @@ bool BlockChain::findWalletData(const csdb::Address& address, WalletData& wallDa
         return findWalletData(address.wallet_id(), wallData);
     }
 
-    std::lock_guard lock(cacheMutex_);
-
+    // ids have own lock, so lookup does not wait for the block being applied
     if (!walletIds_->normal().find(address, id)) {
         return false;
     }
@@ -855,12 +1118,13 @@ bool BlockChain::findWalletData(const csdb::Address& address, WalletData& wallDa
 }
 
 bool BlockChain::findWalletData(WalletId id, WalletData& wallData) const {
-    std::lock_guard lock(cacheMutex_);
     return findWalletData_Unsafe(id, wallData);
 }
 
 bool BlockChain::findWalletData_Unsafe(WalletId id, WalletData& wallData) const {
-    const WalletData* wallDataPtr = walletsCacheUpdater_->findWallet(id);
+    // published snapshot is immutable, so no lock is required
+    const auto snapshot = walletsCacheStorage_->snapshot();
+    const WalletData* wallDataPtr = snapshot->findWallet(id);
 
     if (wallDataPtr) {
         wallData = *wallDataPtr;
@@ -887,7 +1151,6 @@ bool BlockChain::findWalletId(const WalletAddress& address, WalletId& id) const
         return true;
     }
     else if (address.is_public_key()) {
-        std::lock_guard lock(cacheMutex_);
         return walletIds_->normal().find(address, id);
     }
 
@@ -901,7 +1164,6 @@ bool BlockChain::getWalletId(const WalletAddress& address, WalletId& id) {
         return false;
     }
     else if (address.is_public_key()) {
-        std::lock_guard lock(cacheMutex_);
         return walletIds_->normal().get(address, id);
     }
 
@@ -1124,6 +1386,10 @@ const cs::ReadBlockSignal& BlockChain::readBlockEvent() const {
     return storage_.readBlockEvent();
 }
 
+const cs::WriteFailedSignal& BlockChain::writeFailedEvent() const {
+    return storage_.writeFailedEvent();
+}
+
 std::size_t BlockChain::getCachedBlocksSize() const {
     return cachedBlocks_.size();
 }
@@ -1217,18 +1483,14 @@ bool BlockChain::isEqual(const csdb::Address& laddr, const csdb::Address& raddr)
 }
 
 uint32_t BlockChain::getTransactionsCount(const csdb::Address& addr) {
-    std::lock_guard lock(cacheMutex_);
     WalletId id;
 
-    if (addr.is_wallet_id()) {
-        id = addr.wallet_id();
-    }
-
-    else if (!walletIds_->normal().find(addr, id)) {
+    if (!findWalletId(addr, id)) {
         return 0;
     }
 
-    const WalletData* wallDataPtr = walletsCacheUpdater_->findWallet(id);
+    const auto snapshot = walletsCacheStorage_->snapshot();
+    const WalletData* wallDataPtr = snapshot->findWallet(id);
 
     if (!wallDataPtr) {
         return 0;
@@ -1258,17 +1520,14 @@ uint32_t BlockChain::getTransactionsCount(const csdb::Address& addr) {
 
 #ifdef TRANSACTIONS_INDEX
 csdb::TransactionID BlockChain::getLastTransaction(const csdb::Address& addr) {
-    std::lock_guard lock(cacheMutex_);
     WalletId id;
 
-    if (addr.is_wallet_id()) {
-        id = addr.wallet_id();
-    }
-    else if (!walletIds_->normal().find(addr, id)) {
+    if (!findWalletId(addr, id)) {
         return csdb::TransactionID();
     }
 
-    const WalletData* wallDataPtr = walletsCacheUpdater_->findWallet(id);
+    const auto snapshot = walletsCacheStorage_->snapshot();
+    const WalletData* wallDataPtr = snapshot->findWallet(id);
 
     if (!wallDataPtr) {
         return csdb::TransactionID();
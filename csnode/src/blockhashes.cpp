@@ -1,4 +1,5 @@
 #include <csnode/blockhashes.hpp>
+#include <algorithm>
 #include <cstring>
 #include <fstream>
 #include <lib/system/logger.hpp>
@@ -19,10 +20,12 @@ bool BlockHashes::initFromPrevBlock(csdb::Pool prevBlock) {
         db_.first_ = 0;
         db_.last_ = seq;
         hashes_.reserve(db_.last_ + 1);
+        indexRebuild(indexCapacityFor(db_.last_ + 1));
         isDbInited_ = true;
     }
 
     hashes_.emplace_back(prevBlock.hash());
+    indexInsert(hashes_.size() - 1);
     return true;
 }
 
@@ -33,6 +36,9 @@ void BlockHashes::initFinish() {
         while (lh < rh) {
             std::swap(hashes_[lh++], hashes_[rh--]);
         }
+
+        // positions are changed, so index should be filled again
+        indexRebuild(index_.size());
     }
 
     for (const auto& hash : hashes_) {
@@ -58,6 +64,7 @@ bool BlockHashes::loadNextBlock(csdb::Pool nextBlock) {
     }
 
     hashes_.emplace_back(nextBlock.hash());
+    indexInsert(hashes_.size() - 1);
     db_.last_ = seq;
     return true;
 }
@@ -74,10 +81,18 @@ csdb::PoolHash BlockHashes::find(cs::Sequence seq) const {
 }
 
 cs::Sequence BlockHashes::find(csdb::PoolHash hash) const {
-    const auto result = std::find(hashes_.cbegin(), hashes_.cend(), hash);
+    if (index_.empty() || hash.is_empty()) {
+        return 0;
+    }
+
+    const size_t mask = index_.size() - 1;
 
-    if (result != hashes_.cend()) {
-        return std::distance(hashes_.cbegin(), result);
+    for (size_t i = hash.calcHash() & mask; index_[i] != 0; i = (i + 1) & mask) {
+        const size_t position = index_[i] - 1;
+
+        if (hashes_[position] == hash) {
+            return position;
+        }
     }
 
     return 0;
@@ -88,6 +103,7 @@ csdb::PoolHash BlockHashes::removeLast() {
         return csdb::PoolHash{};
     }
     const auto result = hashes_.back();
+    indexErase(hashes_.size() - 1);
     hashes_.pop_back();
     --db_.last_;
     return result;
@@ -104,4 +120,79 @@ const std::vector<csdb::PoolHash>& BlockHashes::getHashes() const {
     return hashes_;
 }
 
+void BlockHashes::indexInsert(size_t position) {
+    // keep load factor not greater than 1/2
+    if ((hashes_.size() << 1) > index_.size()) {
+        indexRebuild(indexCapacityFor(hashes_.size()));
+        return;  // rebuild has already indexed the position
+    }
+
+    const size_t mask = index_.size() - 1;
+    size_t i = hashes_[position].calcHash() & mask;
+
+    while (index_[i] != 0) {
+        i = (i + 1) & mask;
+    }
+
+    index_[i] = static_cast<IndexSlot>(position + 1);
+}
+
+void BlockHashes::indexErase(size_t position) {
+    if (index_.empty()) {
+        return;
+    }
+
+    const size_t mask = index_.size() - 1;
+    const IndexSlot value = static_cast<IndexSlot>(position + 1);
+
+    size_t i = hashes_[position].calcHash() & mask;
+
+    while (index_[i] != value) {
+        if (index_[i] == 0) {
+            return;
+        }
+
+        i = (i + 1) & mask;
+    }
+
+    // backward shift deletion, no tombstones are left in the table
+    for (size_t j = (i + 1) & mask; index_[j] != 0; j = (j + 1) & mask) {
+        const size_t home = hashes_[index_[j] - 1].calcHash() & mask;
+        const bool inRange = (i <= j) ? (i < home && home <= j) : (i < home || home <= j);
+
+        if (!inRange) {
+            index_[i] = index_[j];
+            i = j;
+        }
+    }
+
+    index_[i] = 0;
+}
+
+void BlockHashes::indexRebuild(size_t capacity) {
+    index_.assign(std::max(capacity, indexCapacityFor(hashes_.size())), 0);
+
+    const size_t mask = index_.size() - 1;
+
+    for (size_t position = 0; position < hashes_.size(); ++position) {
+        size_t i = hashes_[position].calcHash() & mask;
+
+        while (index_[i] != 0) {
+            i = (i + 1) & mask;
+        }
+
+        index_[i] = static_cast<IndexSlot>(position + 1);
+    }
+}
+
+size_t BlockHashes::indexCapacityFor(size_t count) const {
+    size_t capacity = 16;
+
+    while (capacity < (count << 1)) {
+        capacity <<= 1;
+    }
+
+    return capacity;
+}
+
 }  // namespace cs
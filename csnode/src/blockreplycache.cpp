@@ -0,0 +1,54 @@
+#include <csnode/blockreplycache.hpp>
+
+#include <algorithm>
+
+namespace cs {
+BlockReplyCache::BlockReplyCache(std::size_t capacity)
+: capacity_(capacity) {
+}
+
+const BlockReplyCache::Reply* BlockReplyCache::find(const cs::PoolsRequestedSequences& sequences) const {
+    if (sequences.empty()) {
+        return nullptr;
+    }
+
+    const auto it = replies_.find(sequences.front());
+
+    if (it == replies_.end() || it->second.sequences != sequences) {
+        return nullptr;
+    }
+
+    return &it->second;
+}
+
+void BlockReplyCache::insert(const Reply& reply) {
+    if (reply.sequences.empty() || capacity_ == 0) {
+        return;
+    }
+
+    const auto [it, inserted] = replies_.insert_or_assign(reply.sequences.front(), reply);
+
+    if (!inserted) {
+        return;
+    }
+
+    order_.push_back(it->first);
+
+    if (order_.size() > capacity_) {
+        replies_.erase(order_.front());
+        order_.pop_front();
+    }
+}
+
+void BlockReplyCache::remove(cs::Sequence sequence) {
+    for (auto it = replies_.begin(); it != replies_.end();) {
+        if (it->second.sequences.back() >= sequence) {
+            order_.erase(std::find(order_.begin(), order_.end(), it->first));
+            it = replies_.erase(it);
+        }
+        else {
+            ++it;
+        }
+    }
+}
+}  // namespace cs
@@ -10,6 +10,7 @@
 #include <lib/system/common.hpp>
 #include <csnode/walletsstate.hpp>
 #include <csnode/walletscache.hpp>
+#include <csnode/signaturecache.hpp>
 #include <csdb/amount_commission.hpp>
 #include <csdb/pool.hpp>
 #include <cscrypto/cscrypto.hpp>
@@ -260,7 +261,7 @@ bool SmartSourceSignaturesValidator::checkSignatures(const SmartSignatures& sigs
                   << s.first << " in init pool with sequence " << initPool.sequence();
         return false;
       }
-      if (!cscrypto::verifySignature(s.second, confidants[s.first], pack.hash().toBinary().data(), cscrypto::kHashSize)) {
+      if (!cscrypto::verifySignature(s.second, confidants[s.first], pack.hash().data(), cscrypto::kHashSize)) {
         cserror() << kLogPrefix << "incorrect signature of smart "
                   << pack.transactions()[0].source().to_string() << " of confidant " << s.first
                   << " from init pool with sequence " << initPool.sequence();
@@ -373,9 +374,9 @@ bool TransactionsChecker::checkSignature(const csdb::Transaction& t) {
                 << t.source().wallet_id() << " in blockchain";
       return false;
     }
-    return t.verify_signature(dataToFetchPublicKey.address_);
+    return SignatureCache::instance().verify(t, dataToFetchPublicKey.address_);
   } else {
-    return t.verify_signature(t.source().public_key());
+    return SignatureCache::instance().verify(t, t.source().public_key());
   }
 }
 
@@ -3,6 +3,7 @@
 #include <csdb/transaction.hpp>
 
 #include <csnode/datastream.hpp>
+#include <csnode/signaturecache.hpp>
 #include <solver/smartcontracts.hpp>
 
 #include <exception>
@@ -90,10 +91,11 @@ void cs::ConveyerBase::addTransaction(const csdb::Transaction& transaction) {
     auto id = transaction.innerID();
 
     if (pimpl_->packetQueue.push(transaction)) {
-        csdetails() << csname() << "Add valid transaction to conveyer id: " << id << ", queue size: " << pimpl_->packetQueue.size();
+        csdetails() << csname() << "Add valid transaction to conveyer id: " << id << ", queue transactions: " << pimpl_->packetQueue.transactionsCount();
     }
     else {
-        cswarning() << csname() << "Add transaction failed to queue, transaction id: " << id << ", queue size: " << pimpl_->packetQueue.size();
+        cswarning() << csname() << "Add transaction failed to queue (duplicate or too cheap), transaction id: " << id
+                    << ", queue transactions: " << pimpl_->packetQueue.transactionsCount();
     }
 }
 
@@ -107,14 +109,20 @@ void cs::ConveyerBase::addSeparatePacket(const cs::TransactionsPacket& packet) {
 
 void cs::ConveyerBase::addTransactionsPacket(const cs::TransactionsPacket& packet) {
     cs::TransactionsPacketHash hash = packet.hash();
-    cs::Lock lock(sharedMutex_);
 
-    if (auto iterator = pimpl_->packetsTable.find(hash); iterator == pimpl_->packetsTable.end()) {
+    {
+        cs::Lock lock(sharedMutex_);
+
+        if (auto iterator = pimpl_->packetsTable.find(hash); iterator != pimpl_->packetsTable.end()) {
+            csdebug() << csname() << "Same hash already exists at table: " << hash.toString();
+            return;
+        }
+
         pimpl_->packetsTable.emplace(std::move(hash), packet);
     }
-    else {
-        csdebug() << csname() << "Same hash already exists at table: " << hash.toString();
-    }
+
+    // signatures are checked by consensus later, so verify them while packet waits
+    cs::SignatureCache::instance().preverify(packet);
 }
 
 const cs::TransactionsPacketTable& cs::ConveyerBase::transactionsPacketTable() const {
@@ -125,6 +133,11 @@ const cs::PacketQueue& cs::ConveyerBase::packetQueue() const {
     return pimpl_->packetQueue;
 }
 
+void cs::ConveyerBase::setSourceResolver(cs::Mempool::SourceResolver resolver) {
+    cs::Lock lock(sharedMutex_);
+    pimpl_->packetQueue.setSourceResolver(std::move(resolver));
+}
+
 std::optional<std::pair<cs::TransactionsPacket, cs::Packets>> cs::ConveyerBase::createPacket() const {
     cs::Lock lock(sharedMutex_);
 
@@ -611,16 +624,7 @@ bool cs::ConveyerBase::isMetaTransactionInvalid(int64_t id) {
 
 size_t cs::ConveyerBase::packetQueueTransactionsCount() const {
     cs::SharedLock lock(sharedMutex_);
-    size_t count = 0;
-
-    auto begin = pimpl_->packetQueue.begin();
-    auto end = pimpl_->packetQueue.end();
-
-    std::for_each(begin, end, [&](const auto& packet) {
-        count += packet.transactionsCount();
-    });
-
-    return count;
+    return pimpl_->packetQueue.transactionsCount();
 }
 
 std::unique_lock<cs::SharedMutex> cs::ConveyerBase::lock() const {
@@ -632,6 +636,13 @@ void cs::ConveyerBase::flushTransactions() {
 
     auto packets = pimpl_->packetQueue.pop();
 
+    if (!packets.empty()) {
+        const auto& stats = pimpl_->packetQueue.mempoolStats();
+        csdebug() << csname() << "Mempool admitted " << stats.admitted << ", duplicates " << stats.duplicates << " (" << stats.duplicatesRate() * 100.0
+                  << "%), conflicts " << stats.conflicts << ", rejected " << stats.rejected << ", evicted " << stats.evicted << ", average admission "
+                  << stats.averageAdmissionNanoseconds() << " ns";
+    }
+
     for (auto& packet : packets) {
         if ((packet.transactionsCount() != 0u)) {
             if (packet.isHashEmpty()) {
@@ -655,6 +666,11 @@ void cs::ConveyerBase::flushTransactions() {
     }
 }
 
+void cs::ConveyerBase::onBlockStored(const csdb::Pool& pool) {
+    cs::Lock lock(sharedMutex_);
+    pimpl_->packetQueue.confirmTransactions(pool);
+}
+
 void cs::ConveyerBase::removeHashesFromTable(const cs::PacketsHashes& hashes) {
     for (const auto& hash : hashes) {
         csdetails() << csname() << " remove hash " << hash.toString();
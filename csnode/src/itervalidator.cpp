@@ -1,5 +1,6 @@
 #include <csnode/itervalidator.hpp>
 
+#include <algorithm>
 #include <cstring>
 
 #include <csnode/walletsstate.hpp>
@@ -131,29 +132,53 @@ bool IterValidator::deployAdditionalCheck(SolverContext& context, size_t trxInd,
 
 void IterValidator::checkTransactionsSignatures(SolverContext& context, const Transactions& transactions, cs::Bytes& characteristicMask, Packets& smartsPackets) {
     checkSignaturesSmartSource(context, smartsPackets);
-    size_t transactionsCount = transactions.size();
-    size_t maskSize = characteristicMask.size();
+    size_t transactionsCount = std::min(transactions.size(), characteristicMask.size());
     size_t rejectedCounter = 0;
+
+    auto reject = [&](size_t i) {
+        characteristicMask[i] = kInvalidMarker;
+        rejectedCounter++;
+        cslog() << kLogPrefix << "transaction[" << i << "] rejected, incorrect signature.";
+        if (SmartContracts::is_new_state(transactions[i])) {
+            pTransval_->addRejectedNewState(context.smart_contracts().absolute_address(transactions[i].source()));
+        }
+    };
+
+    // keys are found here, signatures are verified by all cores
+    std::vector<NodeUtils::SignedMessage> messages;
+    std::vector<size_t> indexes;
+    messages.reserve(transactionsCount);
+    indexes.reserve(transactionsCount);
+
     for (size_t i = 0; i < transactionsCount; ++i) {
-        if (i < maskSize) {
-            bool correctSignature = checkTransactionSignature(context, transactions[i]);
-            if (!correctSignature) {
-                characteristicMask[i] = kInvalidMarker;
-                rejectedCounter++;
-                cslog() << kLogPrefix << "transaction[" << i << "] rejected, incorrect signature.";
-                if (SmartContracts::is_new_state(transactions[i])) {
-                    pTransval_->addRejectedNewState(context.smart_contracts().absolute_address(transactions[i].source()));
-                }
-            }
+        messages.emplace_back();
+
+        if (prepareSignatureCheck(context, transactions[i], messages.back())) {
+            indexes.push_back(i);
+            continue;
+        }
+
+        messages.pop_back();
+
+        if (!checkSmartTransactionSignature(transactions[i])) {
+            reject(i);
         }
     }
+
+    const auto results = NodeUtils::verifySignatures(messages);
+
+    for (size_t j = 0; j < results.size(); ++j) {
+        if (!results[j]) {
+            reject(indexes[j]);
+        }
+    }
+
     if (rejectedCounter) {
         cslog() << kLogPrefix << "wrong signatures num: " << rejectedCounter;
     }
 }
 
-bool IterValidator::checkTransactionSignature(SolverContext& context, const csdb::Transaction& transaction) {
-    BlockChain::WalletData data_to_fetch_pulic_key;
+bool IterValidator::prepareSignatureCheck(SolverContext& context, const csdb::Transaction& transaction, NodeUtils::SignedMessage& message) {
     csdb::Address src = transaction.source();
     // TODO: is_known_smart_contract() does not recognize not yet deployed contract, so all transactions emitted in constructor
     // currently will be rejected
@@ -162,26 +187,36 @@ bool IterValidator::checkTransactionSignature(SolverContext& context, const csdb
     if (!isSmart) {
         smartSourceTransaction = context.smart_contracts().is_known_smart_contract(transaction.source());
     }
-    if (!SmartContracts::is_new_state(transaction) && !smartSourceTransaction) {
-        if (src.is_wallet_id()) {
-            context.blockchain().findWalletData(src.wallet_id(), data_to_fetch_pulic_key);
-            return transaction.verify_signature(data_to_fetch_pulic_key.address_);
-        }
-        return transaction.verify_signature(src.public_key());
+    if (SmartContracts::is_new_state(transaction) || smartSourceTransaction) {
+        return false;
+    }
+
+    if (src.is_wallet_id()) {
+        BlockChain::WalletData data_to_fetch_pulic_key;
+        context.blockchain().findWalletData(src.wallet_id(), data_to_fetch_pulic_key);
+        message.publicKey = data_to_fetch_pulic_key.address_;
     }
     else {
-        // special rule for new_state transactions
-        if (SmartContracts::is_new_state(transaction) && src != transaction.target()) {
-            csdebug() << kLogPrefix << "smart state transaction has different source and target";
-            return false;
-        }
-        auto it = smartSourceInvalidSignatures_.find(transaction.source());
-        if (it != smartSourceInvalidSignatures_.end()) {
-            csdebug() << kLogPrefix << "smart contract transaction has invalid signature";
-            return false;
-        }
-        return true;
+        message.publicKey = src.public_key();
+    }
+
+    message.signature = transaction.signature();
+    message.message = transaction.to_byte_stream_for_sig();
+    return true;
+}
+
+bool IterValidator::checkSmartTransactionSignature(const csdb::Transaction& transaction) {
+    // special rule for new_state transactions
+    if (SmartContracts::is_new_state(transaction) && transaction.source() != transaction.target()) {
+        csdebug() << kLogPrefix << "smart state transaction has different source and target";
+        return false;
+    }
+    auto it = smartSourceInvalidSignatures_.find(transaction.source());
+    if (it != smartSourceInvalidSignatures_.end()) {
+        csdebug() << kLogPrefix << "smart contract transaction has invalid signature";
+        return false;
     }
+    return true;
 }
 
 void IterValidator::checkSignaturesSmartSource(SolverContext& context, cs::Packets& smartContractsPackets) {
@@ -217,7 +252,7 @@ void IterValidator::checkSignaturesSmartSource(SolverContext& context, cs::Packe
             for (const auto& signature : signatures) {
                 if (signature.first < confidants.size()) {
                     const auto& confidantPublicKey = confidants[signature.first];
-                    const cs::Byte* signedHash = smartContractPacket.hash().toBinary().data();
+                    const cs::Byte* signedHash = smartContractPacket.hash().data();
                     if (cscrypto::verifySignature(signature.second, confidantPublicKey, signedHash, cscrypto::kHashSize)) {
                         ++correctSignaturesCounter;
                     }
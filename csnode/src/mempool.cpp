@@ -0,0 +1,246 @@
+#include <csnode/mempool.hpp>
+
+#include <algorithm>
+#include <chrono>
+
+#include <csdb/amount_commission.hpp>
+
+namespace cs {
+Mempool::Mempool(size_t capacity)
+: capacity_(capacity) {
+}
+
+void Mempool::setSourceResolver(SourceResolver resolver) {
+    resolver_ = std::move(resolver);
+}
+
+Mempool::Admission Mempool::add(const csdb::Transaction& transaction) {
+    const auto start = std::chrono::steady_clock::now();
+    const Admission result = admit(transaction);
+    const auto duration = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start);
+
+    stats_.admissionNanoseconds += static_cast<uint64_t>(duration.count());
+
+    switch (result) {
+        case Admission::Admitted:
+            ++stats_.admitted;
+            break;
+        case Admission::Duplicate:
+            ++stats_.duplicates;
+            break;
+        case Admission::Conflict:
+            ++stats_.conflicts;
+            break;
+        case Admission::Rejected:
+            ++stats_.rejected;
+            break;
+    }
+
+    return result;
+}
+
+std::vector<csdb::Transaction> Mempool::take(size_t count) {
+    std::vector<csdb::Transaction> result;
+
+    while (result.size() < count && !heads_.empty()) {
+        const auto head = std::prev(heads_.end());
+        const FeeKey key = *head;
+
+        heads_.erase(head);
+        byFee_.erase(key);
+
+        auto& chain = chains_.find(key.source)->second;
+        auto entryIt = chain.entries.begin();
+
+        result.push_back(std::move(entryIt->second.transaction));
+
+        chain.entries.erase(entryIt);
+        chain.lastInnerId = key.innerId;
+        --size_;
+
+        // chain is kept while it is empty to know the inner id expected next
+        if (chain.entries.empty()) {
+            expireLater(key.source, chain);
+        }
+        else {
+            insertHead(key.source, chain);
+        }
+    }
+
+    return result;
+}
+
+void Mempool::confirm(const csdb::Address& source, int64_t innerId) {
+    if (chains_.empty()) {
+        return;
+    }
+
+    // source is resolved only if it is not the form chains are keyed by
+    auto chainIt = chains_.find(source);
+
+    if (chainIt == chains_.end() && resolver_) {
+        chainIt = chains_.find(resolver_(source));
+    }
+
+    if (chainIt == chains_.end()) {
+        return;
+    }
+
+    auto& chain = chainIt->second;
+    const auto end = chain.entries.upper_bound(innerId);
+
+    for (auto it = chain.entries.begin(); it != end; ++it) {
+        const FeeKey key = keyOf(chainIt->first, *it);
+
+        byFee_.erase(key);
+        heads_.erase(key);
+        --size_;
+    }
+
+    chain.entries.erase(chain.entries.begin(), end);
+
+    if (!chain.lastInnerId || *chain.lastInnerId < innerId) {
+        chain.lastInnerId = innerId;
+    }
+
+    // all taken transactions are confirmed, so nothing is expected from source
+    if (chain.entries.empty() && *chain.lastInnerId == innerId) {
+        chains_.erase(chainIt);
+        return;
+    }
+
+    if (chain.entries.empty()) {
+        expireLater(chainIt->first, chain);
+        return;
+    }
+
+    insertHead(chainIt->first, chain);
+}
+
+void Mempool::nextRound() {
+    ++round_;
+
+    while (!expiring_.empty() && round_ - expiring_.front().first >= ExpireRounds) {
+        const auto& [round, source] = expiring_.front();
+
+        // chain might get transactions or be emptied again since then
+        if (auto chainIt = chains_.find(source); chainIt != chains_.end() && chainIt->second.entries.empty() && chainIt->second.emptySince == round) {
+            chains_.erase(chainIt);
+        }
+
+        expiring_.pop_front();
+    }
+}
+
+void Mempool::forEach(const std::function<bool(const csdb::Transaction&)>& func) const {
+    for (const auto& [source, chain] : chains_) {
+        for (const auto& [innerId, entry] : chain.entries) {
+            if (!func(entry.transaction)) {
+                return;
+            }
+        }
+    }
+}
+
+Mempool::FeeKey Mempool::keyOf(const csdb::Address& source, const Entries::value_type& entry) {
+    return FeeKey{entry.second.feePerByte, entry.second.order, source, entry.first};
+}
+
+csdb::Address Mempool::sourceOf(const csdb::Address& address) const {
+    return resolver_ ? resolver_(address) : address;
+}
+
+void Mempool::insertHead(const csdb::Address& source, const Chain& chain) {
+    if (chain.entries.empty()) {
+        return;
+    }
+
+    const auto& first = *chain.entries.begin();
+
+    if (!chain.lastInnerId || first.first <= *chain.lastInnerId + 1) {
+        heads_.insert(keyOf(source, first));
+    }
+}
+
+Mempool::Admission Mempool::admit(const csdb::Transaction& transaction) {
+    const csdb::Address source = sourceOf(transaction.source());
+    const int64_t innerId = transaction.innerID();
+
+    if (auto chainIt = chains_.find(source); chainIt != chains_.end()) {
+        const Chain& chain = chainIt->second;
+
+        // transaction with this inner id is already taken or confirmed
+        if (chain.lastInnerId && innerId <= *chain.lastInnerId) {
+            return Admission::Duplicate;
+        }
+
+        if (auto it = chain.entries.find(innerId); it != chain.entries.end()) {
+            return it->second.transaction.signature() == transaction.signature() ? Admission::Duplicate : Admission::Conflict;
+        }
+    }
+
+    const size_t binarySize = std::max<size_t>(transaction.to_byte_stream().size(), 1);
+    const double feePerByte = transaction.max_fee().to_double() / static_cast<double>(binarySize);
+
+    while (size_ >= capacity_) {
+        if (byFee_.empty() || !(byFee_.begin()->feePerByte < feePerByte)) {
+            return Admission::Rejected;
+        }
+
+        evict();
+    }
+
+    auto& chain = chains_[source];
+    const auto it = chain.entries.emplace(innerId, Entry{transaction, feePerByte, order_++}).first;
+
+    byFee_.insert(keyOf(source, *it));
+    ++size_;
+
+    if (it == chain.entries.begin()) {
+        if (auto next = std::next(it); next != chain.entries.end()) {
+            heads_.erase(keyOf(source, *next));
+        }
+
+        insertHead(source, chain);
+    }
+
+    return Admission::Admitted;
+}
+
+void Mempool::evict() {
+    const FeeKey key = *byFee_.begin();
+
+    auto chainIt = chains_.find(key.source);
+    auto& chain = chainIt->second;
+    auto it = chain.entries.find(key.innerId);
+
+    // following transactions would not be accepted without evicted one
+    for (auto entryIt = it; entryIt != chain.entries.end(); ++entryIt) {
+        const FeeKey entryKey = keyOf(key.source, *entryIt);
+
+        byFee_.erase(entryKey);
+        heads_.erase(entryKey);
+
+        --size_;
+        ++stats_.evicted;
+    }
+
+    chain.entries.erase(it, chain.entries.end());
+
+    if (!chain.entries.empty()) {
+        return;
+    }
+
+    if (chain.lastInnerId) {
+        expireLater(key.source, chain);
+    }
+    else {
+        chains_.erase(chainIt);
+    }
+}
+
+void Mempool::expireLater(const csdb::Address& source, Chain& chain) {
+    chain.emptySince = round_;
+    expiring_.emplace_back(round_, source);
+}
+}  // namespace cs
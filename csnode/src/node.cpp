@@ -57,6 +57,7 @@ Node::Node(const Config& config)
     cs::Connector::connect(&transport_->pingReceived, this, &Node::onPingReceived);
     cs::Connector::connect(&Node::stopRequested, this, &Node::onStopRequested);
     cs::Connector::connect(&blockChain_.readBlockEvent(), this, &Node::validateBlock);
+    cs::Connector::connect(&blockChain_.removeBlockEvent, this, &Node::onRemoveBlock);
 
     alwaysExecuteContracts_ = config.alwaysExecuteContracts();
 
@@ -74,9 +75,13 @@ Node::~Node() {
 bool Node::init(const Config& config) {
 #ifdef NODE_API
     std::cout << "Init API... ";
-    api_ = std::make_unique<csconnector::connector>(
-        blockChain_, solver_,
-        csconnector::Config{config.getApiSettings().port, config.getApiSettings().ajaxPort, config.getApiSettings().executorPort, config.getApiSettings().apiexecPort});
+    csconnector::Config apiConfig{config.getApiSettings().port, config.getApiSettings().ajaxPort, config.getApiSettings().executorPort, config.getApiSettings().apiexecPort};
+
+    if (config.persistApiCaches()) {
+        apiConfig.caches_dir = config.getPathToDB();
+    }
+
+    api_ = std::make_unique<csconnector::connector>(blockChain_, solver_, apiConfig);
     std::cout << "Done\n";
     cs::Connector::connect(&blockChain_.readBlockEvent(), api_.get(), &csconnector::connector::onReadFromDB);
     cs::Connector::connect(&blockChain_.storeBlockEvent, api_.get(), &csconnector::connector::onStoreBlock);
@@ -85,6 +90,17 @@ bool Node::init(const Config& config) {
     if (!blockChain_.init(config.getPathToDB())) {
         return false;
     }
+
+    // mempool keys transaction chains by public key whatever form source has
+    cs::Conveyer::instance().setSourceResolver([this](const csdb::Address& address) {
+        return blockChain_.getAddressByType(address, BlockChain::AddressType::PublicKey);
+    });
+    cs::Connector::connect(&blockChain_.storeBlockEvent, &cs::Conveyer::instance(), &cs::ConveyerBase::onBlockStored);
+
+    if (config.getGroupCommitBlocks() > 0) {
+        cs::Connector::connect(&blockChain_.writeFailedEvent(), this, &Node::onWriteFailed);
+        blockChain_.setGroupCommit(config.getGroupCommitBlocks(), config.getGroupCommitBytes());
+    }
     cslog() << "Blockchain is ready, contains " << WithDelimiters(stat_.total_transactions()) << " transactions";
 
 #ifdef NODE_API
@@ -619,34 +635,13 @@ void Node::getBlockRequest(const uint8_t* data, const size_t size, const cs::Pub
         return;
     }
 
-    const bool isOneBlockReply = poolSynchronizer_->isOneBlockReply();
-    const std::size_t reserveSize = isOneBlockReply ? 1 : sequences.size();
-
-    cs::PoolsBlock poolsBlock;
-    poolsBlock.reserve(reserveSize);
-
-    auto sendReply = [&] {
-        sendBlockReply(poolsBlock, sender, packetNum);
-        poolsBlock.clear();
-    };
-
-    for (auto& sequence : sequences) {
-        csdb::Pool pool = blockChain_.loadBlock(sequence);
-
-        if (pool.is_valid()) {
-            poolsBlock.push_back(std::move(pool));
-
-            if (isOneBlockReply) {
-                sendReply();
-            }
-        }
-        else {
-            csmeta(cserror) << "Load block: " << sequence << " from blockchain is Invalid";
+    if (poolSynchronizer_->isOneBlockReply()) {
+        for (const auto sequence : sequences) {
+            sendBlockReply(cs::PoolsRequestedSequences{sequence}, sender, packetNum);
         }
     }
-
-    if (!isOneBlockReply) {
-        sendReply();
+    else {
+        sendBlockReply(sequences, sender, packetNum);
     }
 }
 
@@ -675,20 +670,86 @@ void Node::getBlockReply(const uint8_t* data, const size_t size) {
     poolSynchronizer_->getBlockReply(std::move(poolsBlock), packetNum);
 }
 
-void Node::sendBlockReply(const cs::PoolsBlock& poolsBlock, const cs::PublicKey& target, std::size_t packetNum) {
-    for (const auto& pool : poolsBlock) {
-        csdebug() << "NODE> Send block reply. Sequence: " << pool.sequence();
+void Node::sendBlockReply(const cs::PoolsRequestedSequences& sequences, const cs::PublicKey& target, std::size_t packetNum) {
+    cs::BlockReplyCache::Reply reply;
+
+    if (!prepareBlockReply(sequences, reply)) {
+        return;
     }
 
-    csdebug() << "Node> Sending blocks with signatures:";
-    for (const auto& it : poolsBlock) {
-        csdebug() << "#" << it.sequence() << " signs = " << it.signatures().size();
+    csdebug() << "NODE> Send block reply. Sequences: " << sequences.front() << " - " << sequences.back() << ", compressed size: " << reply.compressed->size();
+
+    // cached region is sent as is, it is not changed by anyone
+    tryToSendDirect(target, MsgTypes::RequestedBlock, cs::Conveyer::instance().currentRoundNumber(), reply.realBinSize, cs::numeric_cast<uint32_t>(reply.compressed->size()),
+                    reply.compressed, packetNum);
+}
+
+bool Node::prepareBlockReply(const cs::PoolsRequestedSequences& sequences, cs::BlockReplyCache::Reply& reply) {
+    if (const auto cached = blockReplyCache_.find(sequences); cached) {
+        reply = *cached;
+        return true;
     }
 
-    std::size_t realBinSize = 0;
-    RegionPtr memPtr = compressPoolsBlock(poolsBlock, realBinSize);
+    // stored blocks bytes are the same as serialized pools, so reply is built without pools parsing
+    cs::Bytes bytes;
+    cs::DataStream stream(bytes);
+
+    std::vector<cs::Bytes> blocks;
+    blocks.reserve(sequences.size());
+
+    for (const auto sequence : sequences) {
+        cs::Bytes block = blockChain_.loadBlockRaw(sequence);
+
+        if (!block.empty()) {
+            blocks.push_back(std::move(block));
+        }
+        else {
+            csmeta(cserror) << "Load block: " << sequence << " from blockchain is Invalid";
+        }
+    }
+
+    if (blocks.empty() && sequences.size() == 1) {
+        return false;
+    }
+
+    stream << blocks;
+
+    const int binSize = cs::numeric_cast<int>(bytes.size());
+    const int compressBound = LZ4_compressBound(binSize);
+
+    // blocks are compressed directly to the reply region, its size is cut to the compressed data
+    RegionPtr compressed = allocator_.allocateNext(static_cast<uint32_t>(compressBound));
+    const int compressedSize = LZ4_compress_default(reinterpret_cast<char*>(bytes.data()), static_cast<char*>(compressed->data()), binSize, compressBound);
+
+    if (!compressedSize) {
+        csmeta(cserror) << "Compress poools block error";
+        return false;
+    }
+
+    compressed->setSize(static_cast<uint32_t>(compressedSize));
+
+    reply.sequences = sequences;
+    reply.realBinSize = bytes.size();
+    reply.compressed = std::move(compressed);
+
+    // incomplete reply is not cached, missing blocks may appear later
+    if (blocks.size() == sequences.size()) {
+        blockReplyCache_.insert(reply);
+    }
 
-    tryToSendDirect(target, MsgTypes::RequestedBlock, cs::Conveyer::instance().currentRoundNumber(), realBinSize, cs::numeric_cast<uint32_t>(memPtr->size()), memPtr, packetNum);
+    return true;
+}
+
+void Node::onRemoveBlock(const cs::Sequence sequence) {
+    // cached replies containing removed block are not valid anymore
+    blockReplyCache_.remove(sequence);
+}
+
+void Node::onWriteFailed(const cs::Sequence sequence, size_t count) {
+    cserror() << "NODE> " << count << " blocks starting from #" << sequence << " can't be written to database, node will be stopped";
+
+    // signal comes from storage write thread
+    CallsQueue::instance().insert([] { Node::requestStop(); });
 }
 
 void Node::becomeWriter() {
@@ -1052,7 +1113,8 @@ bool Node::sendToNeighbour(const cs::PublicKey& target, const MsgTypes msgType,
 
 template <typename... Args>
 void Node::sendToNeighbour(const ConnectionPtr target, const MsgTypes msgType, const cs::RoundNumber round, Args&&... args) {
-    ostream_.init(BaseFlags::Neighbours | BaseFlags::Broadcast /*| BaseFlags::Fragmented*/ | BaseFlags::Compressed);
+    // neighbours packets are not redirected, so the fragment size accepted by target is used
+    ostream_.init(BaseFlags::Neighbours | BaseFlags::Broadcast /*| BaseFlags::Fragmented*/ | BaseFlags::Compressed, std::min(transport_->getPacketSize(), target->packetSize));
     ostream_ << msgType << round;
 
     writeDefaultStream(std::forward<Args>(args)...);
@@ -1158,30 +1220,6 @@ void Node::sendBroadcastImpl(const MsgTypes& msgType, const cs::RoundNumber roun
     ostream_.clear();
 }
 
-RegionPtr Node::compressPoolsBlock(const cs::PoolsBlock& poolsBlock, std::size_t& realBinSize) {
-    cs::Bytes bytes;
-    cs::DataStream stream(bytes);
-
-    stream << poolsBlock;
-
-    char* data = reinterpret_cast<char*>(bytes.data());
-    const int binSize = cs::numeric_cast<int>(bytes.size());
-
-    const auto maxSize = LZ4_compressBound(binSize);
-    auto memPtr = allocator_.allocateNext(static_cast<uint32_t>(maxSize));
-
-    const int compressedSize = LZ4_compress_default(data, static_cast<char*>(memPtr->data()), binSize, cs::numeric_cast<int>(memPtr->size()));
-
-    if (!compressedSize) {
-        csmeta(cserror) << "Compress poools block error";
-    }
-
-    memPtr->setSize(static_cast<uint32_t>(compressedSize));
-    realBinSize = cs::numeric_cast<std::size_t>(binSize);
-
-    return memPtr;
-}
-
 cs::PoolsBlock Node::decompressPoolsBlock(const uint8_t* data, const size_t size) {
     istream_.init(data, size);
     std::size_t realBinSize = 0;
@@ -2586,13 +2624,21 @@ void Node::onRoundStart(const cs::RoundTable& roundTable) {
 
     csdebug() << line2.str();
     stat_.onRoundStart(cs::Conveyer::instance().currentRoundNumber());
+
+    if (const auto writeStats = blockChain_.getWriteStats(); writeStats.batches != 0 || writeStats.failed_batches != 0) {
+        csdebug() << "Storage: " << WithDelimiters(writeStats.pools_written) << " blocks in " << WithDelimiters(writeStats.batches) << " batches, queue "
+                  << writeStats.queue_depth << " (max " << writeStats.max_queue_depth << "), last commit " << writeStats.last_commit_us << " us (max "
+                  << writeStats.max_commit_us << " us), failed " << writeStats.failed_batches;
+    }
+
     csdebug() << line2.str();
 
     solver_->nextRound();
 
     if (!sendingTimer_.isRunning()) {
         csdebug() << "NODE> Transaction timer started";
-        sendingTimer_.start(cs::TransactionsPacketInterval);
+        // flush locks conveyer and builds packets, so it must not delay other timers of timer service thread
+        sendingTimer_.start(cs::TransactionsPacketInterval, cs::Timer::Type::Standard, cs::RunPolicy::CallQueuePolicy);
     }
 }
 
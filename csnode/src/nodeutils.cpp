@@ -1,5 +1,8 @@
 #include <csdb/pool.hpp>
 #include <csnode/nodeutils.hpp>
+#include <csnode/signaturecache.hpp>
+
+#include <lib/system/concurrent.hpp>
 
 namespace
 {
@@ -7,6 +10,24 @@ namespace
 }
 
 namespace cs {
+/*static*/
+cs::Bytes NodeUtils::verifySignatures(const std::vector<SignedMessage>& messages) {
+    // small chunks keep threads busy evenly, large ones cost less in synchronization
+    constexpr size_t minChunkSize = 16;
+    const size_t threads = std::max(std::thread::hardware_concurrency(), 1u);
+    const size_t chunkSize = std::max(minChunkSize, messages.size() / (threads * 4));
+
+    cs::Bytes result(messages.size(), 0);
+    auto& cache = SignatureCache::instance();
+
+    cs::Concurrent::forEach(messages.size(), chunkSize, [&](size_t i) {
+        const auto& message = messages[i];
+        result[i] = cache.verify(message.signature, message.publicKey, message.message) ? 1 : 0;
+    });
+
+    return result;
+}
+
 /*static*/
 bool NodeUtils::checkGroupSignature(const cs::ConfidantsKeys& confidants, const cs::Bytes& mask, const cs::Signatures& signatures, const cs::Hash& hash) {
     if (confidants.size() == 0) {
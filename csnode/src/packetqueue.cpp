@@ -2,7 +2,7 @@
 #include <csnode/conveyer.hpp>
 
 cs::PacketQueue::PacketQueue(size_t queueSize, size_t transactionsSize, size_t packetsPerRound)
-: maxQueueSize_(queueSize)
+: mempool_(queueSize * transactionsSize)
 , maxTransactionsSize_(transactionsSize)
 , maxPacketsPerRound_(packetsPerRound) {
     cachedRound_ = 0;
@@ -10,21 +10,12 @@ cs::PacketQueue::PacketQueue(size_t queueSize, size_t transactionsSize, size_t p
 }
 
 bool cs::PacketQueue::push(const csdb::Transaction& transaction) {
-    if (queue_.size() >= maxQueueSize_) {
-        return false;
-    }
-
-    if (queue_.empty() || queue_.back().transactions().size() >= maxTransactionsSize_) {
-        queue_.push_back(cs::TransactionsPacket{});
-    }
-
-    return queue_.back().addTransaction(transaction);
+    return mempool_.add(transaction) == Mempool::Admission::Admitted;
 }
 
 void cs::PacketQueue::push(const cs::TransactionsPacket& packet) {
     // ignore size of queue for packs
     queue_.push_back(packet);
-    queue_.push_back(cs::TransactionsPacket{});
 }
 
 cs::TransactionsBlock cs::PacketQueue::pop() {
@@ -37,8 +28,10 @@ cs::TransactionsBlock cs::PacketQueue::pop() {
 
     if (round != cachedRound_) {
         cachedPackets_ = 0;
+        mempool_.nextRound();
     }
 
+    // separate packets keep their order
     while (!queue_.empty() && cachedPackets_ < maxPacketsPerRound_) {
         block.push_back(std::move(queue_.front()));
         queue_.pop_front();
@@ -46,26 +39,84 @@ cs::TransactionsBlock cs::PacketQueue::pop() {
         ++cachedPackets_;
     }
 
+    while (!mempool_.isEmpty() && cachedPackets_ < maxPacketsPerRound_) {
+        auto transactions = mempool_.take(maxTransactionsSize_);
+
+        // rest of mempool waits for missing inner ids
+        if (transactions.empty()) {
+            break;
+        }
+
+        cs::TransactionsPacket packet;
+
+        for (auto& transaction : transactions) {
+            packet.addTransaction(transaction);
+        }
+
+        block.push_back(std::move(packet));
+        ++cachedPackets_;
+    }
+
     cachedRound_ = round;
     return block;
 }
 
-typename std::deque<cs::TransactionsPacket>::const_iterator cs::PacketQueue::begin() const {
-    return queue_.begin();
+void cs::PacketQueue::confirmTransactions(const csdb::Pool& pool) {
+    // nothing is pending or expected from any source, e.g. during sync
+    if (mempool_.chainsCount() == 0) {
+        return;
+    }
+
+    // views are empty if pool is not composed yet
+    const auto views = pool.transaction_views();
+
+    if (views.size() != pool.transactions_count()) {
+        for (const auto& transaction : pool.transactions()) {
+            mempool_.confirm(transaction.source(), transaction.innerID());
+        }
+
+        return;
+    }
+
+    for (const auto& view : views) {
+        mempool_.confirm(view.source().to_address(), view.innerID());
+    }
 }
 
-typename std::deque<cs::TransactionsPacket>::const_iterator cs::PacketQueue::end() const {
-    return queue_.end();
+void cs::PacketQueue::setSourceResolver(Mempool::SourceResolver resolver) {
+    mempool_.setSourceResolver(std::move(resolver));
+}
+
+void cs::PacketQueue::forEachTransaction(const std::function<bool(const csdb::Transaction&)>& func) const {
+    for (const auto& packet : queue_) {
+        for (const auto& transaction : packet.transactions()) {
+            if (!func(transaction)) {
+                return;
+            }
+        }
+    }
+
+    mempool_.forEach(func);
 }
 
 size_t cs::PacketQueue::size() const {
-    return queue_.size();
+    return queue_.size() + (mempool_.size() + maxTransactionsSize_ - 1) / maxTransactionsSize_;
+}
+
+size_t cs::PacketQueue::transactionsCount() const {
+    size_t count = mempool_.size();
+
+    for (const auto& packet : queue_) {
+        count += packet.transactionsCount();
+    }
+
+    return count;
 }
 
 bool cs::PacketQueue::isEmpty() const {
-    return queue_.empty();
+    return queue_.empty() && mempool_.isEmpty();
 }
 
-std::deque<cs::TransactionsPacket>::const_reference cs::PacketQueue::back() const {
-    return queue_.back();
+const cs::Mempool::Stats& cs::PacketQueue::mempoolStats() const {
+    return mempool_.stats();
 }
@@ -1,4 +1,5 @@
 #include <csnode/roundstat.hpp>
+#include <csnode/signaturecache.hpp>
 #include <lib/system/logger.hpp>
 #include <sstream>
 
@@ -64,6 +65,9 @@ void RoundStat::onRoundStart(RoundNumber round) {
            //<< totalReceivedTransactions_ << " viewed transactions, "
            << WithDelimiters(totalAcceptedTransactions_) << " stored transactions.";
         cslog() << os.str();
+
+        const auto& signatures = SignatureCache::instance();
+        csdebug() << "Signature cache: " << WithDelimiters(signatures.hits()) << " hits, " << WithDelimiters(signatures.misses()) << " misses";
     }
 }
 
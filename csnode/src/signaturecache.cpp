@@ -0,0 +1,86 @@
+#include <csnode/signaturecache.hpp>
+
+#include <csdb/address.hpp>
+#include <csdb/transaction.hpp>
+#include <csnode/transactionspacket.hpp>
+#include <solver/smartcontracts.hpp>
+
+#include <lib/system/concurrent.hpp>
+
+namespace cs {
+/*static*/
+SignatureCache& SignatureCache::instance() {
+    static SignatureCache cache;
+    return cache;
+}
+
+bool SignatureCache::verify(const cs::Signature& signature, const cs::PublicKey& publicKey, const cs::Bytes& message) {
+    const cs::Hash key = keyOf(signature, publicKey, message);
+
+    if (contains(key)) {
+        hits_.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+
+    misses_.fetch_add(1, std::memory_order_relaxed);
+
+    if (!cscrypto::verifySignature(signature, publicKey, message.data(), message.size())) {
+        return false;
+    }
+
+    store(key);
+    return true;
+}
+
+bool SignatureCache::verify(const csdb::Transaction& transaction, const cs::PublicKey& publicKey) {
+    return verify(transaction.signature(), publicKey, transaction.to_byte_stream_for_sig());
+}
+
+void SignatureCache::verify(const cs::TransactionsPacket& packet) {
+    for (const auto& transaction : packet.transactions()) {
+        const auto source = transaction.source();
+
+        // smart contract states are not checked by signature
+        if (!source.is_public_key() || SmartContracts::is_new_state(transaction)) {
+            continue;
+        }
+
+        const cs::Bytes message = transaction.to_byte_stream_for_sig();
+        const cs::Hash key = keyOf(transaction.signature(), source.public_key(), message);
+
+        if (!contains(key) && cscrypto::verifySignature(transaction.signature(), source.public_key(), message.data(), message.size())) {
+            store(key);
+        }
+    }
+}
+
+void SignatureCache::preverify(const cs::TransactionsPacket& packet) {
+    if (packet.transactionsCount() == 0) {
+        return;
+    }
+
+    cs::Concurrent::run([this, packet] { verify(packet); });
+}
+
+/*static*/
+cs::Hash SignatureCache::keyOf(const cs::Signature& signature, const cs::PublicKey& publicKey, const cs::Bytes& message) {
+    cs::Bytes data;
+    data.reserve(signature.size() + publicKey.size() + message.size());
+
+    data.insert(data.end(), signature.begin(), signature.end());
+    data.insert(data.end(), publicKey.begin(), publicKey.end());
+    data.insert(data.end(), message.begin(), message.end());
+
+    return generateHash(data.data(), data.size());
+}
+
+bool SignatureCache::contains(const cs::Hash& key) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return verified_.find(key) != nullptr;
+}
+
+void SignatureCache::store(const cs::Hash& key) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    verified_.tryStore(key) = true;
+}
+}  // namespace cs
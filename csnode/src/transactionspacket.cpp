@@ -1,5 +1,7 @@
 #include "csnode/transactionspacket.hpp"
 
+#include <cstring>
+
 #include <lz4.h>
 #include <csdb/csdb.hpp>
 #include <csdb/internal/utils.hpp>
@@ -17,40 +19,25 @@ TransactionsPacketHash TransactionsPacketHash::fromString(const ::std::string& s
     }
 
     TransactionsPacketHash res;
-    const cs::Bytes hash = ::csdb::internal::from_hex(str);
-
-    if (::csdb::priv::crypto::hash_size == hash.size()) {
-        res.m_bytes = hash;
-    }
+    res.assign(::csdb::internal::from_hex(str));
 
     return res;
 }
 
 TransactionsPacketHash TransactionsPacketHash::fromBinary(const cs::Bytes& data) {
-    const size_t size = data.size();
     TransactionsPacketHash hash;
-
-    if (::csdb::priv::crypto::hash_size == size) {
-        hash.m_bytes = data;
-    }
+    hash.assign(data);
 
     return hash;
 }
 
 TransactionsPacketHash TransactionsPacketHash::fromBinary(cs::Bytes&& data) {
-    const size_t size = data.size();
-    TransactionsPacketHash hash;
-
-    if (::csdb::priv::crypto::hash_size == size) {
-        hash.m_bytes = std::move(data);
-    }
-
-    return hash;
+    return fromBinary(static_cast<const cs::Bytes&>(data));
 }
 
 TransactionsPacketHash TransactionsPacketHash::calcFromData(const cs::Bytes& data) {
     TransactionsPacketHash resHash;
-    resHash.m_bytes = ::csdb::priv::crypto::calc_hash(data);
+    resHash.assign(::csdb::priv::crypto::calc_hash(data));
     return resHash;
 }
 
@@ -59,23 +46,23 @@ TransactionsPacketHash TransactionsPacketHash::calcFromData(const cs::Bytes& dat
 //
 
 bool TransactionsPacketHash::isEmpty() const noexcept {
-    return m_bytes.empty();
+    return m_isEmpty;
 }
 
 size_t TransactionsPacketHash::size() const noexcept {
-    return m_bytes.size();
+    return m_isEmpty ? 0 : m_bytes.size();
 }
 
 std::string TransactionsPacketHash::toString() const noexcept {
-    return csdb::internal::to_hex(m_bytes.begin(), m_bytes.end());
+    return csdb::internal::to_hex(m_bytes.begin(), m_bytes.begin() + static_cast<std::ptrdiff_t>(size()));
 }
 
-const cs::Bytes& TransactionsPacketHash::toBinary() const noexcept {
-    return m_bytes;
+cs::Bytes TransactionsPacketHash::toBinary() const {
+    return cs::Bytes(m_bytes.begin(), m_bytes.begin() + static_cast<std::ptrdiff_t>(size()));
 }
 
 bool TransactionsPacketHash::operator==(const TransactionsPacketHash& other) const noexcept {
-    return m_bytes == other.m_bytes;
+    return m_hash == other.m_hash && m_isEmpty == other.m_isEmpty && m_bytes == other.m_bytes;
 }
 
 bool TransactionsPacketHash::operator!=(const TransactionsPacketHash& other) const noexcept {
@@ -83,9 +70,24 @@ bool TransactionsPacketHash::operator!=(const TransactionsPacketHash& other) con
 }
 
 bool TransactionsPacketHash::operator<(const TransactionsPacketHash& other) const noexcept {
+    // empty hash goes first as empty vector did
+    if (m_isEmpty || other.m_isEmpty) {
+        return m_isEmpty && !other.m_isEmpty;
+    }
+
     return m_bytes < other.m_bytes;
 }
 
+void TransactionsPacketHash::assign(const cs::Bytes& data) {
+    if (data.size() != m_bytes.size()) {
+        return;
+    }
+
+    std::copy(data.begin(), data.end(), m_bytes.begin());
+    std::memcpy(&m_hash, m_bytes.data(), sizeof(m_hash));
+    m_isEmpty = false;
+}
+
 //
 // Static interface
 //
@@ -11,6 +11,15 @@ using namespace std;
 namespace {
 const uint8_t kUntrustedMarker = 255;
 
+cs::WalletsRanking::Values rankingValues(const cs::WalletsCache::WalletData& wallet) {
+    cs::WalletsRanking::Values values;
+    values.balance = wallet.balance_;
+    values.transactionsCount = wallet.transNum_;
+#ifdef MONITOR_NODE
+    values.createTime = wallet.createTime_;
+#endif
+    return values;
+}
 }  // namespace
 
 namespace cs {
@@ -28,6 +37,7 @@ WalletsCache::WalletsCache(const Config& config, csdb::Address genesisAddress, c
 , genesisAddress_(genesisAddress)
 , startAddress_(startAddress) {
     wallets_.reserve(config.initialWalletsNum_);
+    snapshot_ = std::make_shared<Snapshot>();
 }
 
 WalletsCache::~WalletsCache() {
@@ -43,10 +53,131 @@ std::unique_ptr<WalletsCache::Updater> WalletsCache::createUpdater() {
     return std::unique_ptr<Updater>(new Updater(*this));
 }
 
+WalletsCache::SnapshotPtr WalletsCache::snapshot() const {
+    return std::atomic_load(&snapshot_);
+}
+
+void WalletsCache::publishSnapshot(cs::Sequence sequence) {
+    auto prev = std::atomic_load(&snapshot_);
+    auto next = std::make_shared<Snapshot>();
+
+    next->sequence_ = sequence;
+    next->size_ = wallets_.size();
+
+    const size_t chunksCount = (wallets_.size() + Snapshot::ChunkSize - 1) / Snapshot::ChunkSize;
+    const auto makeWallet = [this](size_t id) -> std::shared_ptr<const WalletData> {
+        return wallets_[id] != nullptr ? std::make_shared<const WalletData>(*wallets_[id]) : nullptr;
+    };
+
+    std::lock_guard lock(rankingMutex_);
+
+    if (snapshotOutdated_ || !prev) {
+        next->chunks_.reserve(chunksCount);
+
+        std::vector<std::pair<WalletId, WalletsRanking::Values>> rankingWallets;
+        rankingWallets.reserve(wallets_.size());
+
+        for (size_t id = 0; id < wallets_.size(); ++id) {
+            if (wallets_[id] != nullptr) {
+                rankingWallets.emplace_back(static_cast<WalletId>(id), rankingValues(*wallets_[id]));
+            }
+        }
+
+        ranking_.reset(rankingWallets);
+        csdebug() << "WalletsCache: ranking of " << ranking_.size() << " wallets uses " << ranking_.memoryUsage() << " bytes";
+
+        for (size_t begin = 0; begin < wallets_.size(); begin += Snapshot::ChunkSize) {
+            auto chunk = std::make_shared<Snapshot::Chunk>(Snapshot::ChunkSize);
+
+            for (size_t i = 0; i < Snapshot::ChunkSize && begin + i < wallets_.size(); ++i) {
+                (*chunk)[i] = makeWallet(begin + i);
+            }
+
+            next->chunks_.push_back(std::move(chunk));
+        }
+    }
+    else {
+        // only chunks with modified wallets are copied, others are shared with previous snapshot
+        next->chunks_ = prev->chunks_;
+        next->chunks_.resize(chunksCount);
+
+        std::sort(snapshotModified_.begin(), snapshotModified_.end());
+        snapshotModified_.erase(std::unique(snapshotModified_.begin(), snapshotModified_.end()), snapshotModified_.end());
+
+        std::shared_ptr<Snapshot::Chunk> chunk;
+        size_t chunkIndex = chunksCount;
+
+        for (auto id : snapshotModified_) {
+            if (id >= wallets_.size()) {
+                continue;
+            }
+
+            if (id / Snapshot::ChunkSize != chunkIndex) {
+                chunkIndex = id / Snapshot::ChunkSize;
+
+                const auto& current = next->chunks_[chunkIndex];
+                chunk = current ? std::make_shared<Snapshot::Chunk>(*current) : std::make_shared<Snapshot::Chunk>(Snapshot::ChunkSize);
+                next->chunks_[chunkIndex] = chunk;
+            }
+
+            (*chunk)[id % Snapshot::ChunkSize] = makeWallet(id);
+
+            if (wallets_[id] != nullptr) {
+                const auto values = rankingValues(*wallets_[id]);
+                ranking_.update(id, &values);
+            }
+            else {
+                ranking_.update(id, nullptr);
+            }
+        }
+    }
+
+    std::atomic_store(&snapshot_, SnapshotPtr(std::move(next)));
+
+    snapshotModified_.clear();
+    snapshotOutdated_ = false;
+}
+
+WalletsCache::SnapshotPtr WalletsCache::rankWallets(WalletsRanking::Order order, bool desc, size_t offset, size_t limit, std::vector<WalletId>& ids) const {
+    std::lock_guard lock(rankingMutex_);
+    ids = ranking_.get(order, desc, offset, limit);
+    return std::atomic_load(&snapshot_);
+}
+
+size_t WalletsCache::rankedCount() const {
+    std::lock_guard lock(rankingMutex_);
+    return ranking_.size();
+}
+
+const WalletsCache::WalletData* WalletsCache::Snapshot::findWallet(WalletId id) const {
+    if (id >= size_) {
+        return nullptr;
+    }
+
+    const auto& chunk = chunks_[id / ChunkSize];
+    return chunk ? (*chunk)[id % ChunkSize].get() : nullptr;
+}
+
+void WalletsCache::Snapshot::iterateOverWallets(const std::function<bool(const WalletData::Address&, const WalletData&)> func) const {
+    for (const auto& chunk : chunks_) {
+        if (!chunk) {
+            continue;
+        }
+
+        for (const auto& wallet : *chunk) {
+            if (wallet != nullptr && !func(wallet->address_, *wallet)) {
+                return;
+            }
+        }
+    }
+}
+
 // Initer
 WalletsCache::Initer::Initer(WalletsCache& data)
 : ProcessorBase(data) {
     walletsSpecial_.reserve(data_.config_.initialWalletsNum_);
+    // initer rebuilds the whole state, so the next snapshot is built from scratch
+    data_.snapshotOutdated_ = true;
 }
 
 void WalletsCache::Initer::loadPrevBlock(csdb::Pool& curr, const cs::ConfidantsKeys& confidants, const BlockChain& blockchain) {
@@ -148,7 +279,6 @@ void WalletsCache::ProcessorBase::rollbackReplenishPayableContract(const csdb::T
 
 // ProcessorBase
 void WalletsCache::ProcessorBase::load(csdb::Pool& pool, const cs::ConfidantsKeys& confidants, const BlockChain& blockchain) {
-    csdb::Pool::Transactions& transactions = pool.transactions();
     csdb::Amount totalAmountOfCountedFee = 0;
 #ifdef MONITOR_NODE
     auto wrWall = pool.writer_public_key();
@@ -175,11 +305,22 @@ void WalletsCache::ProcessorBase::load(csdb::Pool& pool, const cs::ConfidantsKey
     }
 #endif
 
-    for (auto itTrx = transactions.begin(); itTrx != transactions.end(); ++itTrx) {
-        itTrx->set_time(pool.get_time());
-        totalAmountOfCountedFee += load(*itTrx, blockchain);
-        if (SmartContracts::is_new_state(*itTrx)) {
-            fundConfidantsWalletsWithExecFee(*itTrx, blockchain);
+    // views are empty if pool is not composed yet
+    const auto views = pool.transaction_views();
+    const size_t transactionsCount = pool.transactions_count();
+
+    for (size_t i = 0; i < transactionsCount; ++i) {
+        if (i < views.size() && views[i].user_fields_count() == 0) {
+            totalAmountOfCountedFee += loadTransfer(views[i], pool, i);
+            continue;
+        }
+
+        // pool decodes all its transactions on the first request
+        auto& transaction = pool.transactions()[i];
+        transaction.set_time(pool.get_time());
+        totalAmountOfCountedFee += load(transaction, blockchain);
+        if (SmartContracts::is_new_state(transaction)) {
+            fundConfidantsWalletsWithExecFee(transaction, blockchain);
         }
     }
 #ifdef MONITOR_NODE
@@ -197,9 +338,14 @@ void WalletsCache::ProcessorBase::load(csdb::Pool& pool, const cs::ConfidantsKey
 }
 #ifdef MONITOR_NODE
 bool WalletsCache::ProcessorBase::setWalletTime(const WalletData::Address& address, const uint64_t& p_timeStamp) {
-    for (auto& it : data_.wallets_) {
-        if (it != nullptr && it->address_ == address) {
-            it->createTime_ = p_timeStamp;
+    for (size_t i = 0; i < data_.wallets_.size(); ++i) {
+        auto wallet = data_.wallets_[i];
+
+        if (wallet != nullptr && wallet->address_ == address) {
+            wallet->createTime_ = p_timeStamp;
+            if (!data_.snapshotOutdated_) {
+                data_.snapshotModified_.push_back(static_cast<WalletId>(i));
+            }
             return true;
         }
     }
@@ -374,6 +520,61 @@ double WalletsCache::ProcessorBase::loadTrxForSource(const csdb::Transaction& tr
     return tr.counted_fee().to_double();
 }
 
+double WalletsCache::ProcessorBase::loadTransfer(const csdb::TransactionView& view, [[maybe_unused]] const csdb::Pool& pool, [[maybe_unused]] size_t index) {
+    const csdb::Address source = view.source().to_address();
+    const csdb::Address target = view.target().to_address();
+
+    if (target != data_.genesisAddress_ && target != data_.startAddress_) {
+        WalletId targetId{};
+
+        if (findWalletId(target, targetId)) {
+            WalletData& wallData = getWalletData(targetId, target);
+            wallData.balance_ += view.amount();
+            setModified(targetId);
+
+            if (source != target)  // Already counted for source
+                ++wallData.transNum_;
+
+#ifdef MONITOR_NODE
+            setWalletTime(wallData.address_, pool.get_time());
+#endif
+
+#ifdef TRANSACTIONS_INDEX
+            wallData.lastTransaction_ = csdb::TransactionID(pool.hash(), index);
+#endif
+        }
+        else {
+            cserror() << "Cannot find target wallet, target is " << target.to_string();
+        }
+    }
+
+    if (source == data_.genesisAddress_ || source == data_.startAddress_)
+        return 0;
+
+    WalletId sourceId{};
+    if (!findWalletId(source, sourceId)) {
+        cserror() << "Cannot find source wallet, source is " << source.to_string();
+        return 0;
+    }
+
+    WalletData& wallData = getWalletData(sourceId, source);
+    wallData.balance_ -= csdb::Amount(view.counted_fee().to_double());
+    wallData.balance_ -= view.amount();
+    ++wallData.transNum_;
+    wallData.trxTail_.push(view.innerID());
+
+#ifdef MONITOR_NODE
+    setWalletTime(wallData.address_, pool.get_time());
+#endif
+
+#ifdef TRANSACTIONS_INDEX
+    wallData.lastTransaction_ = csdb::TransactionID(pool.hash(), index);
+#endif
+
+    setModified(sourceId);
+    return view.counted_fee().to_double();
+}
+
 bool WalletsCache::ProcessorBase::isClosedSmart(const csdb::Transaction& transaction) {
     for (auto& smart : data_.closedSmarts_) {
         if (smart.target() == transaction.target()) {
@@ -531,6 +732,11 @@ WalletsCache::WalletData& WalletsCache::Initer::getWalletData(WalletId id, const
 }
 
 WalletsCache::WalletData& WalletsCache::Updater::getWalletData(WalletId id, const csdb::Address& address) {
+    // wallet may be changed by the caller, outdated snapshot is rebuilt anyway
+    if (!data_.snapshotOutdated_) {
+        data_.snapshotModified_.push_back(WalletsIds::Special::makeNormal(id));
+    }
+
     return ProcessorBase::getWalletData(data_.wallets_, id, address);
 }
 
@@ -13,11 +13,21 @@ WalletsIds::WalletsIds()
     norm_.reset(new Normal(*this));
 }
 
+void WalletsIds::setAddress(WalletId id, const WalletAddress& address) {
+    if (id >= addresses_.size()) {
+        addresses_.resize(static_cast<size_t>(id) + 1);
+    }
+
+    addresses_[id] = address;
+}
+
 WalletsIds::Normal::Normal(WalletsIds& norm)
 : norm_(norm) {
 }
 
 bool WalletsIds::Normal::insert(const WalletAddress& address, WalletId id) {
+    cs::Lock lock(norm_.mutex_);
+
     if (address.is_wallet_id()) {
         if (id != address.wallet_id()) {
             cserror() << "Wrong address";
@@ -32,6 +42,9 @@ bool WalletsIds::Normal::insert(const WalletAddress& address, WalletId id) {
 
             norm_.nextId_ = id + 1;
         }
+        if (res.second) {
+            norm_.setAddress(id, address);
+        }
         return res.second;
     }
     cserror() << "Wrong address";
@@ -44,6 +57,7 @@ bool WalletsIds::Normal::find(const WalletAddress& address, WalletId& id) const
         return true;
     }
     else if (address.is_public_key()) {
+        cs::SharedLock lock(norm_.mutex_);
         Data::const_iterator it = norm_.data_.find(address);
         if (it == norm_.data_.end())
             return false;
@@ -55,6 +69,18 @@ bool WalletsIds::Normal::find(const WalletAddress& address, WalletId& id) const
 }
 
 bool WalletsIds::Normal::findaddr(const WalletId& id, WalletAddress& address) const {
+    cs::SharedLock lock(norm_.mutex_);
+
+    if (!Special::isSpecial(id)) {
+        if (id < norm_.addresses_.size() && norm_.addresses_[id].is_valid()) {
+            address = norm_.addresses_[id];
+            return true;
+        }
+
+        cserror() << "Wrong WalletId";
+        return false;
+    }
+
     bool flgfind = false;
     for (auto& it : norm_.data_) {
         if (it.second == id) {
@@ -76,10 +102,12 @@ bool WalletsIds::Normal::get(const WalletAddress& address, WalletId& id) {
         return false;
     }
     else if (address.is_public_key()) {
+        cs::Lock lock(norm_.mutex_);
         std::pair<Data::const_iterator, bool> res = norm_.data_.insert(std::make_pair(address, norm_.nextId_));
         if (res.second) {
             if (norm_.nextId_ >= numeric_limits<WalletId>::max() / 2)
                 throw runtime_error("nextId_ >= numeric_limits<WalletId>::max() / 2");
+            norm_.setAddress(norm_.nextId_, address);
             ++norm_.nextId_;
         }
         id = res.first->second;
@@ -94,11 +122,18 @@ bool WalletsIds::Normal::remove(const WalletAddress& address) {
         cserror() << __func__ << ": wrong address type";
         return false;
     }
+    cs::Lock lock(norm_.mutex_);
     csdebug() << "Keys before erasing address " << address.to_string();
     for (auto& it : norm_.data_) {
         csdebug() << it.second << " - " << it.first.to_string();
     }
-    norm_.data_.erase(address);
+    const auto it = norm_.data_.find(address);
+    if (it != norm_.data_.end()) {
+        if (!Special::isSpecial(it->second)) {
+            norm_.setAddress(it->second, WalletAddress{});
+        }
+        norm_.data_.erase(it);
+    }
     if (norm_.nextId_ > 0) {
         --norm_.nextId_;
     }
@@ -136,6 +171,7 @@ bool WalletsIds::Special::insertNormal(const WalletAddress& address, WalletId id
         return false;
     }
     else if (address.is_public_key()) {
+        cs::Lock lock(norm_.mutex_);
         std::pair<Data::iterator, bool> res = norm_.data_.insert(std::make_pair(address, idNormal));
 
         const bool isInserted = res.second;
@@ -154,6 +190,7 @@ bool WalletsIds::Special::insertNormal(const WalletAddress& address, WalletId id
 
             norm_.nextId_ = idNormal + 1;
         }
+        norm_.setAddress(idNormal, address);
         return true;
     }
     cserror() << "Wrong address";
@@ -166,6 +203,7 @@ bool WalletsIds::Special::findAnyOrInsertSpecial(const WalletAddress& address, W
         return true;
     }
     else if (address.is_public_key()) {
+        cs::Lock lock(norm_.mutex_);
         std::pair<Data::const_iterator, bool> res = norm_.data_.insert(std::make_pair(address, nextIdSpecial_));
         if (res.second) {
             if (nextIdSpecial_ == numeric_limits<WalletId>::max())
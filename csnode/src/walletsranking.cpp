@@ -0,0 +1,123 @@
+#include <csnode/walletsranking.hpp>
+
+namespace cs {
+
+void WalletsRanking::reset(const std::vector<std::pair<WalletId, Values>>& wallets) {
+    entries_.clear();
+
+    std::vector<std::pair<csdb::Amount, WalletId>> balances;
+#ifdef MONITOR_NODE
+    std::vector<std::pair<uint64_t, WalletId>> createTimes;
+    std::vector<std::pair<uint64_t, WalletId>> transactionsCounts;
+#endif
+
+    for (const auto& [id, values] : wallets) {
+        if (id >= entries_.size()) {
+            entries_.resize(id + 1);
+        }
+
+        entries_[id].values = values;
+        entries_[id].ranked = isRanked(values);
+
+        if (!entries_[id].ranked) {
+            continue;
+        }
+
+        balances.emplace_back(values.balance, id);
+#ifdef MONITOR_NODE
+        createTimes.emplace_back(values.createTime, id);
+        transactionsCounts.emplace_back(values.transactionsCount, id);
+#endif
+    }
+
+    balance_.assign(std::move(balances));
+#ifdef MONITOR_NODE
+    createTime_.assign(std::move(createTimes));
+    transactionsCount_.assign(std::move(transactionsCounts));
+#endif
+}
+
+void WalletsRanking::update(WalletId id, const Values* values) {
+    if (id >= entries_.size()) {
+        if (values == nullptr) {
+            return;
+        }
+
+        entries_.resize(id + 1);
+    }
+
+    auto& entry = entries_[id];
+
+    if (entry.ranked) {
+        erase(id, entry.values);
+    }
+
+    entry.values = values != nullptr ? *values : Values{};
+    entry.ranked = values != nullptr && isRanked(*values);
+
+    if (entry.ranked) {
+        insert(id, entry.values);
+    }
+}
+
+std::vector<WalletsRanking::WalletId> WalletsRanking::get(Order order, bool desc, size_t offset, size_t limit) const {
+    std::vector<WalletId> result;
+    result.reserve(std::min(limit, size()));
+
+    auto collect = [&result, limit](const auto& value) {
+        if (result.size() == limit) {
+            return false;
+        }
+
+        result.push_back(value.second);
+        return true;
+    };
+
+    switch (order) {
+        case Order::Balance:
+            balance_.forEach(offset, desc, collect);
+            break;
+#ifdef MONITOR_NODE
+        case Order::CreateTime:
+            createTime_.forEach(offset, desc, collect);
+            break;
+        case Order::TransactionsCount:
+            transactionsCount_.forEach(offset, desc, collect);
+            break;
+#endif
+        default:
+            break;
+    }
+
+    return result;
+}
+
+size_t WalletsRanking::memoryUsage() const {
+    size_t result = entries_.capacity() * sizeof(Entry) + balance_.memoryUsage();
+#ifdef MONITOR_NODE
+    result += createTime_.memoryUsage() + transactionsCount_.memoryUsage();
+#endif
+    return result;
+}
+
+bool WalletsRanking::isRanked(const Values& values) {
+    return values.balance >= csdb::Amount(0);
+}
+
+void WalletsRanking::insert(WalletId id, const Values& values) {
+    balance_.insert(std::make_pair(values.balance, id));
+#ifdef MONITOR_NODE
+    createTime_.insert(std::make_pair(values.createTime, id));
+    transactionsCount_.insert(std::make_pair(values.transactionsCount, id));
+#endif
+}
+
+void WalletsRanking::erase(WalletId id, const Values& values) {
+    balance_.erase(std::make_pair(values.balance, id));
+#ifdef MONITOR_NODE
+    createTime_.erase(std::make_pair(values.createTime, id));
+    transactionsCount_.erase(std::make_pair(values.transactionsCount, id));
+#endif
+}
+
+}  // namespace cs
@@ -13,10 +13,118 @@
 #include "logger.hpp"
 #include "utils.hpp"
 
-/* Now, RegionAllocator provides a basic allocation strategy, where we
-   malloc() several memory pages of predefined size and a page can be
-   reused if and only if all of its memory has been unuse()d.
-   Thread safety: one allocator, many users */
+/* RegionPool keeps memory blocks of power of two size classes for
+   reuse, from 64 bytes up to 1 Mb. Freed blocks go to a thread local
+   cache first and are exchanged with global free lists in batches, so
+   a block freed by one thread is reused by another. Free lists of a
+   class keep up to 32 Mb, small classes are cut from pages while pages
+   of the class fit this limit, blocks bigger than the last class are not
+   pooled.
+   Thread safety: all functions may be called from any thread */
+class RegionPool {
+public:
+    static constexpr uint8_t NoClass = 0xff;
+    static constexpr uint8_t ClassesCount = 15;
+    static constexpr std::size_t MinClassSize = 64;
+
+    struct Stats {
+        uint64_t liveRegions = 0;
+        uint64_t liveBytes = 0;
+        uint64_t hits = 0;
+        uint64_t misses = 0;
+        // free blocks kept for reuse
+        uint64_t pooledBytes = 0;
+
+        double hitRate() const {
+            const auto total = hits + misses;
+            return total ? static_cast<double>(hits) / static_cast<double>(total) : 0.0;
+        }
+    };
+
+    // returns NoClass if size is not pooled
+    static uint8_t sizeClass(const std::size_t size) {
+        std::size_t classSize = MinClassSize;
+
+        for (uint8_t i = 0; i < ClassesCount; ++i, classSize <<= 1) {
+            if (size <= classSize) {
+                return i;
+            }
+        }
+
+        return NoClass;
+    }
+
+    static std::size_t classSize(const uint8_t sizeClass) {
+        return MinClassSize << sizeClass;
+    }
+
+    static void* allocate(const uint8_t sizeClass);
+    static void free(void* block, const uint8_t sizeClass);
+
+    static void onRegionCreated(const uint32_t size) {
+        liveRegions_.fetch_add(1, std::memory_order_relaxed);
+        liveBytes_.fetch_add(size, std::memory_order_relaxed);
+    }
+
+    static void onRegionDestroyed(const uint32_t size) {
+        liveRegions_.fetch_sub(1, std::memory_order_relaxed);
+        liveBytes_.fetch_sub(size, std::memory_order_relaxed);
+    }
+
+    static Stats stats();
+
+private:
+    inline static std::atomic<uint64_t> liveRegions_ = {0};
+    inline static std::atomic<uint64_t> liveBytes_ = {0};
+    inline static std::atomic<uint64_t> hits_ = {0};
+    inline static std::atomic<uint64_t> misses_ = {0};
+};
+
+/* std compatible allocator over RegionPool, used for shared pointers
+   control blocks */
+template <typename T>
+class RegionPoolAllocator {
+public:
+    using value_type = T;
+
+    RegionPoolAllocator() = default;
+
+    template <typename U>
+    RegionPoolAllocator(const RegionPoolAllocator<U>&) {
+    }
+
+    T* allocate(const std::size_t count) {
+        const auto sizeClass = RegionPool::sizeClass(sizeof(T) * count);
+
+        if (sizeClass == RegionPool::NoClass) {
+            return static_cast<T*>(::operator new(sizeof(T) * count));
+        }
+
+        return static_cast<T*>(RegionPool::allocate(sizeClass));
+    }
+
+    void deallocate(T* ptr, const std::size_t count) {
+        const auto sizeClass = RegionPool::sizeClass(sizeof(T) * count);
+
+        if (sizeClass == RegionPool::NoClass) {
+            ::operator delete(ptr);
+        }
+        else {
+            RegionPool::free(ptr, sizeClass);
+        }
+    }
+
+    template <typename U>
+    bool operator==(const RegionPoolAllocator<U>&) const {
+        return true;
+    }
+
+    template <typename U>
+    bool operator!=(const RegionPoolAllocator<U>&) const {
+        return false;
+    }
+};
+
 class RegionAllocator;
 
 class Region {
@@ -39,21 +147,31 @@ public:
     }
 
     ~Region() {
-        delete [] data_;
+        RegionPool::onRegionDestroyed(allocatedSize_);
+
+        if (sizeClass_ == RegionPool::NoClass) {
+            delete [] data_;
+        }
+        else {
+            RegionPool::free(data_, sizeClass_);
+        }
     }
 
     void setSize(uint32_t size) {
         size_ = size;
     }
 
-    explicit Region(cs::Byte* data, const uint32_t size, RegionPrivate)
+    explicit Region(cs::Byte* data, const uint32_t size, const uint8_t sizeClass, RegionPrivate)
     : data_(data)
-    , size_(size) {
+    , size_(size)
+    , allocatedSize_(size)
+    , sizeClass_(sizeClass) {
+        RegionPool::onRegionCreated(allocatedSize_);
     }
 
 private:
-    static RegionPtr create(cs::Byte* data, const uint32_t size) {
-        return std::make_shared<Region>(data, size, RegionPrivate());
+    static RegionPtr create(cs::Byte* data, const uint32_t size, const uint8_t sizeClass) {
+        return std::allocate_shared<Region>(RegionPoolAllocator<Region>(), data, size, sizeClass, RegionPrivate());
     }
 
     Region(const Region&) = delete;
@@ -63,6 +181,8 @@ private:
 
     cs::Byte* data_;
     uint32_t size_;
+    uint32_t allocatedSize_;
+    uint8_t sizeClass_;
 
     friend class RegionAllocator;
     friend class Network;
@@ -70,12 +190,10 @@ private:
 
 using RegionPtr = Region::RegionPtr;
 
-/* ActivePage points to a page with some free memory.
-   - If its free memory isn't enough to complete an alloc request,
-     ActivePage->nextPage becomes the next ActivePage;
-   - If there is no ActivePage->nextPage, we allocate another page.
-   - Whenever memory is freed on a page, if it is now empty, it
-     becomes the ActivePage->nextPage */
+/* RegionAllocator takes region memory and the region itself from
+   RegionPool, so both are recycled when the last RegionPtr drops and
+   the steady packet flow does not touch the heap.
+   Thread safety: one allocator, many users */
 class RegionAllocator {
 public:
     RegionAllocator() = default;
@@ -85,13 +203,18 @@ public:
     RegionAllocator& operator=(const RegionAllocator&) = delete;
     RegionAllocator& operator=(RegionAllocator&&) = delete;
 
-    /* Assumptions:
-     - allocateNext and shrinkLast are only called from the thread
-       that constructed the object
-     - shrinkLast is called before the last allocation gets unuse()d */
     RegionPtr allocateNext(const uint32_t size) {
-        auto ptr = new cs::Byte[size];
-        return Region::create(ptr, size);
+        const auto sizeClass = RegionPool::sizeClass(size);
+
+        if (sizeClass == RegionPool::NoClass) {
+            return Region::create(new cs::Byte[size], size, sizeClass);
+        }
+
+        return Region::create(static_cast<cs::Byte*>(RegionPool::allocate(sizeClass)), size, sizeClass);
+    }
+
+    static RegionPool::Stats stats() {
+        return RegionPool::stats();
     }
 };
 
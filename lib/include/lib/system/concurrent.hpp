@@ -2,11 +2,14 @@
 #define CONCURRENT_HPP
 
 #include <assert.h>
+#include <algorithm>
+#include <atomic>
 #include <condition_variable>
 #include <functional>
 #include <future>
 #include <list>
 #include <memory>
+#include <mutex>
 #include <thread>
 #include <type_traits>
 #include <unordered_map>
@@ -15,6 +18,7 @@
 #include <lib/system/common.hpp>
 #include <lib/system/logger.hpp>
 #include <lib/system/signals.hpp>
+#include <lib/system/timerservice.hpp>
 
 #include <boost/asio/post.hpp>
 #include <boost/asio/thread_pool.hpp>
@@ -357,10 +361,58 @@ public:
         Concurrent::run(std::bind(std::forward<Func>(func), std::forward<Args>(args)...));
     }
 
-    // calls std::function after ms time in another thread
+    // calls function(index) for every index in [0, count) by chunks in thread pool and current thread,
+    // returns when all calls are done, current thread takes chunks too, so busy pool does not block it
+    template <typename Func>
+    static void forEach(const size_t count, const size_t chunkSize, Func&& function) {
+        struct State {
+            std::atomic<size_t> next = {0};
+            std::atomic<size_t> done = {0};
+            std::mutex mutex;
+            std::condition_variable condition;
+        };
+
+        const size_t chunks = (count + chunkSize - 1) / chunkSize;
+
+        if (chunks == 0) {
+            return;
+        }
+
+        auto state = std::make_shared<State>();
+        auto func = &function;
+
+        // late pool tasks find no chunks and do not touch function
+        auto process = [state, func, chunks, chunkSize, count] {
+            for (size_t chunk = state->next.fetch_add(1); chunk < chunks; chunk = state->next.fetch_add(1)) {
+                const size_t end = std::min(count, (chunk + 1) * chunkSize);
+
+                for (size_t i = chunk * chunkSize; i < end; ++i) {
+                    (*func)(i);
+                }
+
+                if (state->done.fetch_add(1) + 1 == chunks) {
+                    std::lock_guard<std::mutex> lock(state->mutex);
+                    state->condition.notify_all();
+                }
+            }
+        };
+
+        const size_t helpers = std::min<size_t>(chunks - 1, std::max(std::thread::hardware_concurrency(), 1u) - 1);
+
+        for (size_t i = 0; i < helpers; ++i) {
+            Worker::execute(process);
+        }
+
+        process();
+
+        std::unique_lock<std::mutex> lock(state->mutex);
+        state->condition.wait(lock, [&] { return state->done.load() == chunks; });
+    }
+
+    // calls std::function after ms time by timer service thread or CallsQueue
     static void runAfter(const std::chrono::milliseconds& ms, cs::RunPolicy policy, std::function<void()> callBack) {
-        auto timePoint = std::chrono::steady_clock::now() + ms;
-        Worker::run(std::bind(&Concurrent::runAfterHelper, timePoint, policy, std::move(callBack)));
+        const auto executor = (policy == cs::RunPolicy::CallQueuePolicy) ? TimerService::Executor::CallsQueue : TimerService::Executor::TimerThread;
+        TimerService::instance().scheduleOnce(ms, executor, std::move(callBack));
     }
 
     template <typename Func>
@@ -369,11 +421,6 @@ public:
     }
 
 private:
-    static void runAfterHelper(const std::chrono::steady_clock::time_point& timePoint, cs::RunPolicy policy, std::function<void()> callBack) {
-        std::this_thread::sleep_until(timePoint);
-        Worker::execute(policy, std::move(callBack));
-    }
-
     inline static std::mutex executionsMutex_;
 };
 
@@ -5,28 +5,107 @@
 #include <lib/system/common.hpp>
 #include "utils.hpp"
 
+#include <array>
+#include <cstring>
+#include <random>
+
 inline cs::Hash generateHash(const void* data, size_t length) {
     return cscrypto::calculateHash(reinterpret_cast<const uint8_t*>(data), length);
 }
 
-template <>
-inline uint16_t getHashIndex(const cs::Hash& hash) {
-    constexpr const size_t border = kHashLength / 2;
+namespace cs {
+// non-cryptographic 128 bit identity of data for local tables only,
+// it is seeded per process, so it must not be sent or stored
+struct Identity {
+    uint64_t low = 0;
+    uint64_t high = 0;
+
+    bool operator==(const Identity& other) const {
+        return low == other.low && high == other.high;
+    }
+
+    bool operator!=(const Identity& other) const {
+        return !(*this == other);
+    }
+};
+
+namespace detail {
+inline const std::array<uint64_t, 4>& identitySeeds() {
+    static const std::array<uint64_t, 4> seeds = [] {
+        std::random_device device;
+        std::array<uint64_t, 4> result;
+
+        for (auto& seed : result) {
+            // nonzero seeds keep zero words from zeroing the product
+            seed = ((static_cast<uint64_t>(device()) << 32) ^ device()) | 1;
+        }
+
+        return result;
+    }();
+
+    return seeds;
+}
+
+// folds 128 bit product into 64 bits
+inline uint64_t foldMultiply(const uint64_t lhs, const uint64_t rhs) {
+#ifdef _MSC_VER
+    uint64_t high = 0;
+    const uint64_t low = _umul128(lhs, rhs, &high);
+    return low ^ high;
+#else
+    const auto product = static_cast<unsigned __int128>(lhs) * rhs;
+    return static_cast<uint64_t>(product) ^ static_cast<uint64_t>(product >> 64);
+#endif
+}
 
-    uint16_t result = 0;
-    auto byte = reinterpret_cast<uint8_t*>(&result);
+inline uint64_t readWord(const uint8_t* data) {
+    uint64_t result;
+    std::memcpy(&result, data, sizeof(result));
+    return result;
+}
+}  // namespace detail
+
+inline Identity generateIdentity(const void* data, size_t length) {
+    const auto& seeds = detail::identitySeeds();
+    auto bytes = static_cast<const uint8_t*>(data);
+
+    Identity result{seeds[0] ^ length, seeds[1] + length};
 
-    for (size_t i = 0; i < border; ++i) {
-        *byte ^= hash[i];
+    for (; length >= 16; length -= 16, bytes += 16) {
+        const uint64_t first = detail::readWord(bytes);
+        const uint64_t second = detail::readWord(bytes + 8);
+
+        result.low = detail::foldMultiply(first ^ seeds[2], second ^ result.low);
+        result.high = detail::foldMultiply(second ^ seeds[3], first ^ result.high);
     }
 
-    ++byte;
+    if (length) {
+        uint8_t tail[16] = {};
+        std::memcpy(tail, bytes, length);
 
-    for (size_t i = border; i < kHashLength; ++i) {
-        *byte ^= hash[i];
+        result.low = detail::foldMultiply(detail::readWord(tail) ^ seeds[2], detail::readWord(tail + 8) ^ result.low);
+        result.high = detail::foldMultiply(detail::readWord(tail + 8) ^ seeds[3], detail::readWord(tail) ^ result.high);
     }
 
+    const uint64_t low = result.low;
+    result.low = detail::foldMultiply(low ^ seeds[1], result.high ^ seeds[2]);
+    result.high = detail::foldMultiply(result.high ^ seeds[0], low ^ seeds[3]);
+
     return result;
 }
+}  // namespace cs
+
+// the hash is uniform, so its first word is enough
+template <>
+inline uint64_t getHashIndex(const cs::Hash& hash) {
+    uint64_t result;
+    std::memcpy(&result, hash.data(), sizeof(result));
+    return result;
+}
+
+template <>
+inline uint64_t getHashIndex(const cs::Identity& identity) {
+    return identity.low;
+}
 
 #endif  // HASH_HPP
@@ -3,6 +3,7 @@
 #define QUEUES_HPP
 #include <atomic>
 #include <cstdint>
+#include <memory>
 #include <thread>
 
 #include "cache.hpp"
@@ -99,4 +100,104 @@ private:
     __cacheline_aligned std::atomic<Element*> writingBarrier_ = {elements};
 };
 
+/* BoundedQueue is a lock-free ring of preallocated elements that
+   allows many writers and many readers. An element is locked for
+   writing or reading in place and is never destroyed, so it keeps its
+   resources (e.g. memory regions) for the next write. Writers spin
+   while the queue is full unless they use tryLockWrite, readers spin
+   while it is empty */
+template <typename T, std::size_t MaxSize, uint32_t BackOffTreshold = 1000>
+class BoundedQueue {
+    static_assert(MaxSize && (MaxSize & (MaxSize - 1)) == 0, "BoundedQueue size should be a power of two");
+
+public:
+    struct Element {
+        std::atomic<std::size_t> sequence;
+        T element;
+    };
+
+    BoundedQueue()
+    : elements_(new Element[MaxSize]) {
+        for (std::size_t i = 0; i < MaxSize; ++i) {
+            elements_[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    BoundedQueue(const BoundedQueue&) = delete;
+    BoundedQueue& operator=(const BoundedQueue&) = delete;
+
+    Element* lockWrite() {
+        return lock(writePosition_, 0, true);
+    }
+
+    // returns nullptr instead of waiting if the queue is full
+    Element* tryLockWrite() {
+        return lock(writePosition_, 0, false);
+    }
+
+    void unlockWrite(Element* ptr) {
+        // position + 1 marks element as ready for reading
+        ptr->sequence.store(ptr->sequence.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+
+    Element* lockRead() {
+        return lock(readPosition_, 1, true);
+    }
+
+    void unlockRead(Element* ptr) {
+        // position + MaxSize marks element as free for the next round of writing
+        ptr->sequence.store(ptr->sequence.load(std::memory_order_relaxed) + MaxSize - 1, std::memory_order_release);
+    }
+
+    // approximate count of written and not read elements
+    std::size_t size() const {
+        const auto written = writePosition_.load(std::memory_order_acquire);
+        const auto read = readPosition_.load(std::memory_order_acquire);
+        return written > read ? written - read : 0;
+    }
+
+    static constexpr std::size_t capacity() {
+        return MaxSize;
+    }
+
+private:
+    Element* lock(std::atomic<std::size_t>& position, std::size_t offset, bool wait) {
+        auto current = position.load(std::memory_order_relaxed);
+        uint32_t attempts = 0;
+
+        while (true) {
+            Element* ptr = &elements_[current & (MaxSize - 1)];
+            const auto sequence = ptr->sequence.load(std::memory_order_acquire);
+            const auto diff = static_cast<std::ptrdiff_t>(sequence - (current + offset));
+
+            if (diff == 0) {
+                if (position.compare_exchange_weak(current, current + 1, std::memory_order_relaxed)) {
+                    return ptr;
+                }
+
+                continue;
+            }
+
+            // element of the previous round is not released yet
+            if (diff < 0) {
+                if (!wait) {
+                    return nullptr;
+                }
+
+                if (++attempts == BackOffTreshold) {
+                    attempts = 0;
+                    std::this_thread::yield();
+                }
+            }
+
+            current = position.load(std::memory_order_relaxed);
+        }
+    }
+
+    std::unique_ptr<Element[]> elements_;
+
+    __cacheline_aligned std::atomic<std::size_t> writePosition_ = {0};
+    __cacheline_aligned std::atomic<std::size_t> readPosition_ = {0};
+};
+
 #endif  // QUEUES_HPP
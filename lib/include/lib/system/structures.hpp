@@ -1,10 +1,17 @@
 /* Send blaming letters to @yrtimd */
 #ifndef STRUCTURES_HPP
 #define STRUCTURES_HPP
+#include <algorithm>
 #include <cstdint>
 #include <cstdlib>
 #include <cstring>
 #include <functional>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <tuple>
+#include <utility>
+#include <vector>
 
 #include "allocators.hpp"
 #include "cache.hpp"
@@ -102,6 +109,9 @@ public:
     T* frontPtr() const {
         return head_;
     }
+    T* data() const {
+        return elements_;
+    }
     T* backPtr() const {
         return tail_;
     }
@@ -213,18 +223,19 @@ private:
     T* end_;
 };
 
-/* A simple queue-like counting hash-map of fixed size. Not
-   thread-safe. */
+/* A simple queue-like counting hash-map of fixed size, the oldest
+   element is evicted when the map is full. Elements are kept in
+   insertion order, the index is an open-addressing table with linear
+   probing over element positions. getHashIndex of IndexType width is
+   spread over the table, so narrow index types are valid but probe
+   longer. Not thread-safe. */
 template <typename ResultType, typename ArgType>
 inline ResultType getHashIndex(const ArgType&);
 
-template <typename KeyType, typename ArgType, typename IndexType = uint16_t, uint32_t MaxSize = 100000>
+template <typename KeyType, typename ArgType, typename IndexType = uint64_t, uint32_t MaxSize = 100000>
 class FixedHashMap {
 public:
     struct Element {
-        Element *up, *down = nullptr;
-        Element** bucket;
-
         KeyType key;
         ArgType data = {};
 
@@ -232,54 +243,68 @@ public:
             return data;
         }
 
-        Element(const KeyType& _key, Element** _bucket)
-        : bucket(_bucket)
-        , key(_key) {
+        explicit Element(const KeyType& _key)
+        : key(_key) {
         }
     };
-    using ElementPtr = Element*;
 
-    FixedHashMap() {
+    FixedHashMap()
+    : slots_(new Slot[SlotsCount]()) {
         static_assert(MaxSize >= 2, "Your member is too small");
-
-        const size_t bucketsSize = 1 << (sizeof(IndexType) * 8);
-        buckets_ = new ElementPtr[bucketsSize];
-        std::memset(buckets_, 0, bucketsSize * sizeof(ElementPtr));
+        static_assert(SlotsBits <= 31, "Your member is too big");
     }
 
     FixedHashMap(const FixedHashMap&) = delete;
     FixedHashMap(FixedHashMap&& rhs)
     : buffer_(std::move(rhs.buffer_))
-    , buckets_(rhs.buckets_) {
-        rhs.buckets_ = nullptr;
-    }
-
-    ~FixedHashMap() {
-        delete[] buckets_;
+    , slots_(std::move(rhs.slots_)) {
     }
 
     ArgType& tryStore(const KeyType& key) {
-        Element** myBucket;
-        auto foundElement = getElt(key, &myBucket);
+        const uint32_t tag = tagOf(key);
+        uint32_t pos = homeOf(tag);
 
-        if (foundElement) {
-            return foundElement->data;
+        for (; slots_[pos].element; pos = nextOf(pos)) {
+            if (slots_[pos].tag == tag) {
+                Element& element = elementOf(slots_[pos]);
+
+                if (element.key == key) {
+                    return element.data;
+                }
+            }
         }
 
         // Element not found, add a new one
         if (buffer_.size() == MaxSize) {
-            preparePopLeft();
+            eraseOldest();
+
+            // erased slot may be closer to home than the found one
+            for (pos = homeOf(tag); slots_[pos].element; pos = nextOf(pos))
+                ;
         }
 
-        Element& newComer = buffer_.emplace(key, myBucket);
-        newComer.up = *myBucket;
+        Element& newComer = buffer_.emplace(key);
+        slots_[pos].element = static_cast<uint32_t>(&newComer - buffer_.data()) + 1;
+        slots_[pos].tag = tag;
+
+        return newComer.data;
+    }
+
+    // returns nullptr if key is not stored, does not store it
+    ArgType* find(const KeyType& key) {
+        const uint32_t tag = tagOf(key);
+
+        for (uint32_t pos = homeOf(tag); slots_[pos].element; pos = nextOf(pos)) {
+            if (slots_[pos].tag == tag) {
+                Element& element = elementOf(slots_[pos]);
 
-        if (newComer.up) {
-            newComer.up->down = &newComer;
+                if (element.key == key) {
+                    return &element.data;
+                }
+            }
         }
 
-        *myBucket = &newComer;
-        return newComer.data;
+        return nullptr;
     }
 
     auto begin() {
@@ -290,39 +315,265 @@ public:
     }
 
 private:
-    Element* getElt(const KeyType& key, Element*** bucket) {
-        const IndexType idx = getHashIndex<IndexType, KeyType>(key);
-        *bucket = buckets_ + idx;
-
-        Element* eltInBucket = **bucket;
-        while (eltInBucket) {
-            if (eltInBucket->key == key) {
-                return eltInBucket;
+    // element is position in buffer + 1, 0 is empty slot
+    struct Slot {
+        uint32_t element;
+        uint32_t tag;
+    };
+
+    static constexpr uint32_t slotsBits() {
+        uint32_t bits = 1;
+
+        // load factor is not greater than 2/3
+        while ((uint64_t(1) << bits) < uint64_t(MaxSize) * 3 / 2) {
+            ++bits;
+        }
+
+        return bits;
+    }
+
+    static constexpr uint32_t SlotsBits = slotsBits();
+    static constexpr uint32_t SlotsCount = 1u << SlotsBits;
+
+    // fibonacci hashing, high bits of product depend on all bits of index
+    static uint32_t tagOf(const KeyType& key) {
+        return static_cast<uint32_t>((static_cast<uint64_t>(getHashIndex<IndexType, KeyType>(key)) * 0x9E3779B97F4A7C15ull) >> 32);
+    }
+
+    static uint32_t homeOf(const uint32_t tag) {
+        return tag >> (32 - SlotsBits);
+    }
+
+    static uint32_t nextOf(const uint32_t pos) {
+        return (pos + 1) & (SlotsCount - 1);
+    }
+
+    Element& elementOf(const Slot& slot) const {
+        return buffer_.data()[slot.element - 1];
+    }
+
+    // buffer destroys the oldest element on the next emplace
+    void eraseOldest() {
+        const uint32_t element = static_cast<uint32_t>(buffer_.frontPtr() - buffer_.data()) + 1;
+        uint32_t pos = homeOf(tagOf(buffer_.frontPtr()->key));
+
+        while (slots_[pos].element != element) {
+            pos = nextOf(pos);
+        }
+
+        // backward shift keeps probe sequences unbroken without tombstones
+        for (uint32_t next = nextOf(pos); slots_[next].element; next = nextOf(next)) {
+            const uint32_t home = homeOf(slots_[next].tag);
+
+            if (((next - home) & (SlotsCount - 1)) >= ((next - pos) & (SlotsCount - 1))) {
+                slots_[pos] = slots_[next];
+                pos = next;
             }
+        }
+
+        slots_[pos] = Slot{};
+    }
+
+    FixedCircularBuffer<Element, MaxSize> buffer_;
+    std::unique_ptr<Slot[]> slots_;
+};
 
-            eltInBucket = eltInBucket->up;
+/* Unbounded hash map with open addressing. Values are stored contiguously,
+   erase moves the last value to the place of the erased one, so any
+   modification invalidates iterators. Not thread-safe. */
+template <typename KeyType, typename ValueType, typename Hasher = std::hash<KeyType>>
+class OpenHashMap {
+public:
+    using value_type = std::pair<KeyType, ValueType>;
+    using iterator = typename std::vector<value_type>::iterator;
+    using const_iterator = typename std::vector<value_type>::const_iterator;
+
+    iterator begin() {
+        return values_.begin();
+    }
+    iterator end() {
+        return values_.end();
+    }
+    const_iterator begin() const {
+        return values_.begin();
+    }
+    const_iterator end() const {
+        return values_.end();
+    }
+
+    size_t size() const {
+        return values_.size();
+    }
+
+    bool empty() const {
+        return values_.empty();
+    }
+
+    iterator find(const KeyType& key) {
+        const uint32_t pos = findSlot(key);
+        return pos == NoSlot ? values_.end() : values_.begin() + (slots_[pos].element - 1);
+    }
+
+    const_iterator find(const KeyType& key) const {
+        const uint32_t pos = findSlot(key);
+        return pos == NoSlot ? values_.end() : values_.begin() + (slots_[pos].element - 1);
+    }
+
+    size_t count(const KeyType& key) const {
+        return findSlot(key) == NoSlot ? 0 : 1;
+    }
+
+    ValueType& at(const KeyType& key) {
+        auto it = find(key);
+
+        if (it == values_.end()) {
+            throw std::out_of_range("OpenHashMap::at");
         }
 
-        return nullptr;
+        return it->second;
     }
 
-    void preparePopLeft() {
-        auto toRemove = buffer_.frontPtr();
+    const ValueType& at(const KeyType& key) const {
+        auto it = find(key);
 
-        if (toRemove->down) {
-            toRemove->down->up = toRemove->up;
+        if (it == values_.end()) {
+            throw std::out_of_range("OpenHashMap::at");
         }
-        else {
-            *(toRemove->bucket) = toRemove->up;
+
+        return it->second;
+    }
+
+    // does nothing if key is already stored, like std::map
+    template <typename Key, typename... Args>
+    std::pair<iterator, bool> emplace(Key&& key, Args&&... args) {
+        if (const uint32_t pos = findSlot(key); pos != NoSlot) {
+            return std::make_pair(values_.begin() + (slots_[pos].element - 1), false);
         }
 
-        if (toRemove->up) {
-            toRemove->up->down = toRemove->down;
+        // load factor is not greater than 2/3
+        if ((values_.size() + 1) * 3 > slots_.size() * 2) {
+            rehash(slots_.empty() ? 16 : slots_.size() * 2);
         }
+
+        values_.emplace_back(std::piecewise_construct, std::forward_as_tuple(std::forward<Key>(key)), std::forward_as_tuple(std::forward<Args>(args)...));
+        insertSlot(tagOf(values_.back().first), static_cast<uint32_t>(values_.size()));
+
+        return std::make_pair(std::prev(values_.end()), true);
     }
 
-    FixedCircularBuffer<Element, MaxSize> buffer_;
-    Element** buckets_;
+    size_t erase(const KeyType& key) {
+        const uint32_t pos = findSlot(key);
+
+        if (pos == NoSlot) {
+            return 0;
+        }
+
+        const uint32_t element = slots_[pos].element;
+        eraseSlot(pos);
+
+        // the last value takes place of the erased one
+        const uint32_t last = static_cast<uint32_t>(values_.size());
+
+        if (element != last) {
+            uint32_t lastPos = homeOf(tagOf(values_.back().first));
+
+            while (slots_[lastPos].element != last) {
+                lastPos = nextOf(lastPos);
+            }
+
+            slots_[lastPos].element = element;
+            values_[element - 1] = std::move(values_.back());
+        }
+
+        values_.pop_back();
+        return 1;
+    }
+
+    void clear() {
+        values_.clear();
+        std::fill(slots_.begin(), slots_.end(), Slot{});
+    }
+
+private:
+    // element is position in values + 1, 0 is empty slot
+    struct Slot {
+        uint32_t element = 0;
+        uint32_t tag = 0;
+    };
+
+    static constexpr uint32_t NoSlot = ~uint32_t(0);
+
+    // fibonacci hashing, high bits of product depend on all bits of hash
+    static uint32_t tagOf(const KeyType& key) {
+        return static_cast<uint32_t>((static_cast<uint64_t>(Hasher{}(key)) * 0x9E3779B97F4A7C15ull) >> 32);
+    }
+
+    uint32_t homeOf(const uint32_t tag) const {
+        return tag >> (32 - slotsBits_);
+    }
+
+    uint32_t nextOf(const uint32_t pos) const {
+        return (pos + 1) & static_cast<uint32_t>(slots_.size() - 1);
+    }
+
+    uint32_t findSlot(const KeyType& key) const {
+        if (values_.empty()) {
+            return NoSlot;
+        }
+
+        const uint32_t tag = tagOf(key);
+
+        for (uint32_t pos = homeOf(tag); slots_[pos].element; pos = nextOf(pos)) {
+            if (slots_[pos].tag == tag && values_[slots_[pos].element - 1].first == key) {
+                return pos;
+            }
+        }
+
+        return NoSlot;
+    }
+
+    void insertSlot(const uint32_t tag, const uint32_t element) {
+        uint32_t pos = homeOf(tag);
+
+        while (slots_[pos].element) {
+            pos = nextOf(pos);
+        }
+
+        slots_[pos] = Slot{element, tag};
+    }
+
+    // backward shift keeps probe sequences unbroken without tombstones
+    void eraseSlot(uint32_t pos) {
+        const uint32_t mask = static_cast<uint32_t>(slots_.size() - 1);
+
+        for (uint32_t next = nextOf(pos); slots_[next].element; next = nextOf(next)) {
+            const uint32_t home = homeOf(slots_[next].tag);
+
+            if (((next - home) & mask) >= ((next - pos) & mask)) {
+                slots_[pos] = slots_[next];
+                pos = next;
+            }
+        }
+
+        slots_[pos] = Slot{};
+    }
+
+    void rehash(const size_t count) {
+        slots_.assign(count, Slot{});
+        slotsBits_ = 0;
+
+        while ((size_t(1) << slotsBits_) < count) {
+            ++slotsBits_;
+        }
+
+        for (size_t i = 0; i < values_.size(); ++i) {
+            insertSlot(tagOf(values_[i].first), static_cast<uint32_t>(i + 1));
+        }
+    }
+
+    std::vector<value_type> values_;
+    std::vector<Slot> slots_;
+    uint32_t slotsBits_ = 0;
 };
 
 class CallsQueue {
@@ -5,10 +5,9 @@
 #include <chrono>
 #include <functional>
 #include <memory>
-#include <thread>
-#include <vector>
 
 #include <lib/system/concurrent.hpp>
+#include <lib/system/timerservice.hpp>
 
 namespace cs {
 using TimerCallbackSignature = void();
@@ -19,16 +18,12 @@ class Timer;
 using TimerPtr = std::shared_ptr<Timer>;
 
 ///
-/// Represents standard timer that calls callbacks every msec with time correction.
-/// @brief Timer emits time out signal by run policy.
+/// Represents standard timer that calls callbacks every msec.
+/// @brief Timer emits time out signal by run policy, it is driven by shared TimerService.
 ///
 class Timer {
 public:
-    enum : unsigned int {
-        RangeDeltaInPercents = 10,
-        HighPreciseTimerSleepTimeMs = 1
-    };
-
+    // both types have 1 ms resolution of TimerService, type is kept for compatibility
     enum class Type : cs::Byte {
         Standard,
         HighPrecise
@@ -37,6 +32,8 @@ public:
     Timer();
     ~Timer();
 
+    // ThreadPolicy slots are called by timer service thread and delay all other timers,
+    // so slots doing more than a short non blocking action use CallQueuePolicy
     void start(int msec, Type type = Type::Standard, RunPolicy policy = RunPolicy::ThreadPolicy);
     void stop();
     void restart();
@@ -52,30 +49,11 @@ public signals:
     // generates when timer ticks
     TimeOutSignal timeOut;
 
-protected:
-    // timer main loop
-    void loop();
-    void preciseLoop();
-
-    // timer rehabilitation when timer degradate
-    void rehabilitation();
-    void call();
-
 private:
-    bool isRunning_;
-    bool isRehabilitation_;
-    std::atomic<bool> interruption_;
-
-    std::thread timerThread_;
+    std::atomic<TimerService::Id> id_;
     Type type_;
-    std::atomic<RunPolicy> policy_;
-
-    unsigned int allowDifference_;
+    RunPolicy policy_;
     std::chrono::milliseconds ms_;
-    std::atomic<int64_t> ns_;
-
-    std::chrono::milliseconds realMs_;
-    std::chrono::time_point<std::chrono::system_clock> rehabilitationStartValue_;
 };
 }  // namespace cs
 
@@ -0,0 +1,167 @@
+#ifndef TIMERSERVICE_HPP
+#define TIMERSERVICE_HPP
+
+#include <array>
+#include <bitset>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace cs {
+///
+/// Hierarchical timing wheel driven by one thread.
+/// @brief Keeps timers of the whole process, so they do not own threads.
+///
+/// The first wheel has 1 ms slots, every next wheel has slots as long as the whole previous one.
+/// Timer is linked to a slot by its deadline, so schedule and cancel are O(1), timers of upper
+/// wheels move down when time reaches their slot. Thread sleeps till the next non empty slot.
+///
+class TimerService {
+public:
+    using Id = uint64_t;
+    using Callback = std::function<void()>;
+    using Clock = std::chrono::steady_clock;
+
+    static constexpr Id InvalidId = 0;
+
+    static constexpr uint32_t SlotsBits = 8;
+    static constexpr uint32_t SlotsCount = 1u << SlotsBits;
+    static constexpr uint32_t WheelsCount = 4;
+
+    enum class Executor : uint8_t {
+        // callback is called by timer thread, so it must be short
+        TimerThread,
+        // callback is inserted to CallsQueue, the next call is skipped while previous one waits there
+        CallsQueue
+    };
+
+    static TimerService& instance();
+
+    TimerService();
+    ~TimerService();
+
+    TimerService(const TimerService&) = delete;
+    TimerService& operator=(const TimerService&) = delete;
+
+    ///
+    /// @brief Schedules callback after delay and then every period.
+    /// @param period Zero period makes one shot timer.
+    /// @return id to cancel timer.
+    ///
+    Id schedule(std::chrono::milliseconds delay, std::chrono::milliseconds period, Executor executor, Callback callback);
+
+    Id scheduleOnce(std::chrono::milliseconds delay, Executor executor, Callback callback) {
+        return schedule(delay, std::chrono::milliseconds(0), executor, std::move(callback));
+    }
+
+    ///
+    /// @brief Cancels timer, callback is not called after return.
+    /// Waits for callback running on timer thread unless called from it.
+    /// @return false if one shot timer has already been called or id is unknown.
+    ///
+    bool cancel(Id id);
+
+    bool isScheduled(Id id) const;
+
+    // count of timers not cancelled and not called yet
+    size_t size() const;
+
+    // calls skipped because previous call of the same timer was still waiting in CallsQueue
+    uint64_t skippedCalls() const;
+
+private:
+    using Tick = uint64_t;
+
+    static constexpr uint32_t NoIndex = ~uint32_t(0);
+
+    struct Entry {
+        Tick deadline = 0;
+        Tick period = 0;
+        std::shared_ptr<const Callback> callback;
+        Executor executor = Executor::TimerThread;
+        uint32_t generation = 0;
+
+        // list of slot, slot is NoIndex if entry is not linked
+        uint32_t slot = NoIndex;
+        uint32_t prev = NoIndex;
+        uint32_t next = NoIndex;
+
+        bool active = false;
+        // inserted to CallsQueue and not called yet
+        bool posted = false;
+    };
+
+    struct Expired {
+        Id id;
+        std::shared_ptr<const Callback> callback;
+    };
+
+    static Id makeId(uint32_t index, uint32_t generation);
+    static uint32_t indexOf(Id id);
+
+    Tick nowTick() const;
+
+    // returns entry index or NoIndex, the lock must be held
+    uint32_t find(Id id) const;
+
+    void link(uint32_t index);
+    void unlink(uint32_t index);
+
+    // callback is returned to be destroyed out of lock
+    std::shared_ptr<const Callback> release(uint32_t index);
+
+    // moves timers of current slot of wheel to lower wheels
+    void cascade(uint32_t wheel);
+
+    // processes ticks up to now, timer thread callbacks are returned to be called out of lock
+    void advance(Tick now, std::vector<Expired>& expired);
+    void expire(uint32_t index, std::vector<Expired>& expired);
+    void post(uint32_t index);
+
+    void callPosted(Id id, const std::shared_ptr<const Callback>& callback);
+    void callExpired(const std::vector<Expired>& expired);
+
+    Tick nextWakeTick() const;
+
+    void routine();
+    void wait(std::unique_lock<std::mutex>& lock, Tick wakeTick);
+    void notify();
+
+    const Clock::time_point start_;
+
+    mutable std::mutex mutex_;
+    std::condition_variable finished_;
+
+    std::vector<Entry> entries_;
+    std::vector<uint32_t> free_;
+    size_t size_ = 0;
+    uint64_t skippedCalls_ = 0;
+
+    std::array<uint32_t, SlotsCount * WheelsCount> slots_;
+    std::array<std::bitset<SlotsCount>, WheelsCount> occupied_;
+
+    // the next tick to process
+    Tick current_ = 0;
+    Tick wakeTick_ = 0;
+
+    // timer thread callback being called
+    Id running_ = InvalidId;
+
+    bool stop_ = false;
+#ifdef __linux__
+    int timerFd_ = -1;
+    int eventFd_ = -1;
+#else
+    std::condition_variable wakeUp_;
+    bool notified_ = false;
+#endif
+    std::thread thread_;
+};
+}  // namespace cs
+
+#endif  // TIMERSERVICE_HPP
@@ -0,0 +1,255 @@
+#include "lib/system/allocators.hpp"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <mutex>
+#include <vector>
+
+namespace {
+// classes up to this size are cut from pages, bigger ones are allocated by one block
+constexpr std::size_t PageSize = 64 * 1024;
+
+// global free list of a class keeps not more than this count of bytes,
+// pages of a class are limited by it too as paged blocks are never freed
+constexpr std::size_t MaxClassBytes = 32 * 1024 * 1024;
+
+// free blocks kept by thread caches and global free lists
+std::atomic<uint64_t> pooledBytes = {0};
+
+std::size_t batchSize(const uint8_t sizeClass) {
+    return std::max<std::size_t>(1, std::min<std::size_t>(64, PageSize / RegionPool::classSize(sizeClass)));
+}
+
+bool isPaged(const uint8_t sizeClass) {
+    return RegionPool::classSize(sizeClass) < PageSize;
+}
+
+class GlobalPool {
+public:
+    // moves up to count blocks to destination, returns moved count
+    std::size_t take(const uint8_t sizeClass, std::vector<void*>& destination, const std::size_t count) {
+        auto& list = lists_[sizeClass];
+        cs::Lock lock(list.lock);
+
+        const auto moved = std::min(count, list.blocks.size());
+        destination.insert(destination.end(), list.blocks.end() - static_cast<std::ptrdiff_t>(moved), list.blocks.end());
+        list.blocks.resize(list.blocks.size() - moved);
+
+        return moved;
+    }
+
+    // blocks above the free list limit are freed, blocks may be reordered
+    void put(const uint8_t sizeClass, void** blocks, const std::size_t count) {
+        auto& list = lists_[sizeClass];
+        const auto maxCount = MaxClassBytes / RegionPool::classSize(sizeClass);
+
+        std::size_t stored = count;
+
+        {
+            cs::Lock lock(list.lock);
+
+            for (std::size_t i = 0; i < stored;) {
+                // paged blocks can not be freed one by one, so they are always kept
+                if (list.blocks.size() < maxCount || isPageBlock(list, blocks[i])) {
+                    list.blocks.push_back(blocks[i]);
+                    ++i;
+                }
+                else {
+                    std::swap(blocks[i], blocks[--stored]);
+                }
+            }
+        }
+
+        for (auto i = stored; i < count; ++i) {
+            delete [] static_cast<cs::Byte*>(blocks[i]);
+        }
+
+        pooledBytes.fetch_sub((count - stored) * RegionPool::classSize(sizeClass), std::memory_order_relaxed);
+    }
+
+    // returns nullptr if pages of the class reached the limit, its blocks are allocated one by one then
+    cs::Byte* allocatePage(const uint8_t sizeClass) {
+        auto& list = lists_[sizeClass];
+        cs::Lock lock(list.lock);
+
+        if ((list.pages.size() + 1) * PageSize > MaxClassBytes) {
+            return nullptr;
+        }
+
+        auto page = new cs::Byte[PageSize];
+        list.pages.insert(std::upper_bound(list.pages.begin(), list.pages.end(), page), page);
+
+        return page;
+    }
+
+private:
+    struct FreeList {
+        cs::SpinLock lock{ATOMIC_FLAG_INIT};
+        std::vector<void*> blocks;
+        // sorted starts of pages blocks are cut from
+        std::vector<cs::Byte*> pages;
+    };
+
+    static bool isPageBlock(const FreeList& list, void* block) {
+        const auto byte = static_cast<cs::Byte*>(block);
+        const auto it = std::upper_bound(list.pages.begin(), list.pages.end(), byte);
+
+        return it != list.pages.begin() && byte < *std::prev(it) + PageSize;
+    }
+
+    std::array<FreeList, RegionPool::ClassesCount> lists_;
+};
+
+GlobalPool& globalPool() {
+    // never destroyed, regions may be released during static destruction
+    static GlobalPool* pool = new GlobalPool();
+    return *pool;
+}
+
+class LocalCache {
+public:
+    LocalCache();
+    ~LocalCache();
+
+    // hit is false if block was taken from heap
+    void* allocate(const uint8_t sizeClass, bool& hit) {
+        auto& blocks = blocks_[sizeClass];
+        hit = !blocks.empty() || globalPool().take(sizeClass, blocks, batchSize(sizeClass));
+
+        if (!hit) {
+            return create(sizeClass);
+        }
+
+        void* block = blocks.back();
+        blocks.pop_back();
+
+        return block;
+    }
+
+    void free(void* block, const uint8_t sizeClass) {
+        auto& blocks = blocks_[sizeClass];
+        blocks.push_back(block);
+
+        const auto batch = batchSize(sizeClass);
+
+        if (blocks.size() >= batch * 2) {
+            globalPool().put(sizeClass, blocks.data() + blocks.size() - batch, batch);
+            blocks.resize(blocks.size() - batch);
+        }
+    }
+
+private:
+    void* create(const uint8_t sizeClass) {
+        const auto size = RegionPool::classSize(sizeClass);
+
+        if (!isPaged(sizeClass)) {
+            return new cs::Byte[size];
+        }
+
+        auto& page = pages_[sizeClass];
+
+        if (page.current == page.end) {
+            cs::Byte* next = globalPool().allocatePage(sizeClass);
+
+            if (!next) {
+                return new cs::Byte[size];
+            }
+
+            page.current = next;
+            page.end = next + PageSize;
+        }
+
+        void* block = page.current;
+        page.current += size;
+
+        return block;
+    }
+
+    struct Page {
+        cs::Byte* current = nullptr;
+        cs::Byte* end = nullptr;
+    };
+
+    std::array<std::vector<void*>, RegionPool::ClassesCount> blocks_;
+    std::array<Page, RegionPool::ClassesCount> pages_;
+};
+
+enum class CacheState : uint8_t {
+    None,
+    Alive,
+    Destroyed
+};
+
+thread_local CacheState cacheState = CacheState::None;
+
+LocalCache::LocalCache() {
+    cacheState = CacheState::Alive;
+}
+
+LocalCache::~LocalCache() {
+    cacheState = CacheState::Destroyed;
+
+    for (uint8_t i = 0; i < RegionPool::ClassesCount; ++i) {
+        // the rest of thread page is given to others as free blocks
+        for (auto& page = pages_[i]; page.current != page.end; page.current += RegionPool::classSize(i)) {
+            blocks_[i].push_back(page.current);
+            pooledBytes.fetch_add(RegionPool::classSize(i), std::memory_order_relaxed);
+        }
+
+        globalPool().put(i, blocks_[i].data(), blocks_[i].size());
+    }
+}
+
+LocalCache* localCache() {
+    if (cacheState == CacheState::Destroyed) {
+        return nullptr;
+    }
+
+    thread_local LocalCache cache;
+    return &cache;
+}
+}  // namespace
+
+void* RegionPool::allocate(const uint8_t sizeClass) {
+    bool hit = false;
+    void* block = nullptr;
+
+    if (auto cache = localCache()) {
+        block = cache->allocate(sizeClass, hit);
+    }
+    else {
+        std::vector<void*> blocks;
+        hit = globalPool().take(sizeClass, blocks, 1);
+        block = hit ? blocks.front() : new cs::Byte[classSize(sizeClass)];
+    }
+
+    if (hit) {
+        pooledBytes.fetch_sub(classSize(sizeClass), std::memory_order_relaxed);
+    }
+
+    (hit ? hits_ : misses_).fetch_add(1, std::memory_order_relaxed);
+    return block;
+}
+
+void RegionPool::free(void* block, const uint8_t sizeClass) {
+    pooledBytes.fetch_add(classSize(sizeClass), std::memory_order_relaxed);
+
+    if (auto cache = localCache()) {
+        cache->free(block, sizeClass);
+    }
+    else {
+        globalPool().put(sizeClass, &block, 1);
+    }
+}
+
+RegionPool::Stats RegionPool::stats() {
+    Stats result;
+    result.liveRegions = liveRegions_.load(std::memory_order_relaxed);
+    result.liveBytes = liveBytes_.load(std::memory_order_relaxed);
+    result.hits = hits_.load(std::memory_order_relaxed);
+    result.misses = misses_.load(std::memory_order_relaxed);
+    result.pooledBytes = pooledBytes.load(std::memory_order_relaxed);
+
+    return result;
+}
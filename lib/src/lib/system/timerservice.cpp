@@ -0,0 +1,470 @@
+#include "lib/system/timerservice.hpp"
+
+#include <algorithm>
+#include <limits>
+#include <system_error>
+
+#ifdef __linux__
+#include <sys/eventfd.h>
+#include <sys/poll.h>
+#include <sys/timerfd.h>
+#include <unistd.h>
+#endif
+
+#include <lib/system/structures.hpp>
+
+namespace {
+constexpr uint64_t NoWakeTick = std::numeric_limits<uint64_t>::max();
+}  // namespace
+
+cs::TimerService& cs::TimerService::instance() {
+    static TimerService service;
+    return service;
+}
+
+cs::TimerService::TimerService()
+: start_(Clock::now()) {
+    slots_.fill(NoIndex);
+
+#ifdef __linux__
+    timerFd_ = timerfd_create(CLOCK_MONOTONIC, TFD_CLOEXEC);
+    eventFd_ = eventfd(0, EFD_CLOEXEC);
+
+    if (timerFd_ == -1 || eventFd_ == -1) {
+        throw std::system_error(errno, std::generic_category(), "TimerService");
+    }
+#endif
+
+    thread_ = std::thread(&TimerService::routine, this);
+}
+
+cs::TimerService::~TimerService() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_ = true;
+    }
+
+    notify();
+    thread_.join();
+
+#ifdef __linux__
+    close(timerFd_);
+    close(eventFd_);
+#endif
+}
+
+cs::TimerService::Id cs::TimerService::schedule(std::chrono::milliseconds delay, std::chrono::milliseconds period, Executor executor, Callback callback) {
+    std::unique_lock<std::mutex> lock(mutex_);
+
+    uint32_t index;
+
+    if (free_.empty()) {
+        index = static_cast<uint32_t>(entries_.size());
+        entries_.emplace_back();
+    }
+    else {
+        index = free_.back();
+        free_.pop_back();
+    }
+
+    Entry& entry = entries_[index];
+    ++entry.generation;
+
+    // the next tick is added, so timer is never called earlier than delay
+    entry.deadline = std::max(nowTick() + static_cast<Tick>(std::max<int64_t>(delay.count(), 0)) + 1, current_);
+    entry.period = static_cast<Tick>(std::max<int64_t>(period.count(), 0));
+    entry.callback = std::make_shared<const Callback>(std::move(callback));
+    entry.executor = executor;
+    entry.active = true;
+    entry.posted = false;
+
+    link(index);
+    ++size_;
+
+    const Id id = makeId(index, entry.generation);
+    const bool earlier = entry.deadline < wakeTick_;
+
+    lock.unlock();
+
+    if (earlier) {
+        notify();
+    }
+
+    return id;
+}
+
+bool cs::TimerService::cancel(Id id) {
+    std::shared_ptr<const Callback> callback;
+    std::unique_lock<std::mutex> lock(mutex_);
+
+    const uint32_t index = find(id);
+
+    if (index != NoIndex) {
+        callback = release(index);
+    }
+
+    if (running_ == id && std::this_thread::get_id() != thread_.get_id()) {
+        finished_.wait(lock, [this, id] { return running_ != id; });
+    }
+
+    return index != NoIndex;
+}
+
+bool cs::TimerService::isScheduled(Id id) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return find(id) != NoIndex;
+}
+
+size_t cs::TimerService::size() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return size_;
+}
+
+uint64_t cs::TimerService::skippedCalls() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return skippedCalls_;
+}
+
+cs::TimerService::Id cs::TimerService::makeId(uint32_t index, uint32_t generation) {
+    return (static_cast<Id>(generation) << 32) | (static_cast<Id>(index) + 1);
+}
+
+uint32_t cs::TimerService::indexOf(Id id) {
+    return static_cast<uint32_t>(id & 0xFFFFFFFF) - 1;
+}
+
+cs::TimerService::Tick cs::TimerService::nowTick() const {
+    return static_cast<Tick>(std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now() - start_).count());
+}
+
+uint32_t cs::TimerService::find(Id id) const {
+    const uint32_t index = indexOf(id);
+
+    if (id == InvalidId || index >= entries_.size()) {
+        return NoIndex;
+    }
+
+    const Entry& entry = entries_[index];
+
+    if (!entry.active || entry.generation != static_cast<uint32_t>(id >> 32)) {
+        return NoIndex;
+    }
+
+    return index;
+}
+
+void cs::TimerService::link(uint32_t index) {
+    Entry& entry = entries_[index];
+
+    // wheels cover 2^32 ms, longer delays are cut
+    constexpr Tick maxDelta = (Tick(1) << (SlotsBits * WheelsCount)) - 1;
+    entry.deadline = std::clamp(entry.deadline, current_, current_ + maxDelta);
+
+    const Tick delta = entry.deadline - current_;
+    uint32_t wheel = 0;
+
+    while (wheel + 1 < WheelsCount && delta >= (Tick(1) << (SlotsBits * (wheel + 1)))) {
+        ++wheel;
+    }
+
+    const uint32_t position = static_cast<uint32_t>(entry.deadline >> (SlotsBits * wheel)) & (SlotsCount - 1);
+    const uint32_t slot = wheel * SlotsCount + position;
+
+    entry.slot = slot;
+    entry.prev = NoIndex;
+    entry.next = slots_[slot];
+
+    if (entry.next != NoIndex) {
+        entries_[entry.next].prev = index;
+    }
+
+    slots_[slot] = index;
+    occupied_[wheel].set(position);
+}
+
+void cs::TimerService::unlink(uint32_t index) {
+    Entry& entry = entries_[index];
+
+    if (entry.prev != NoIndex) {
+        entries_[entry.prev].next = entry.next;
+    }
+    else {
+        slots_[entry.slot] = entry.next;
+    }
+
+    if (entry.next != NoIndex) {
+        entries_[entry.next].prev = entry.prev;
+    }
+
+    if (slots_[entry.slot] == NoIndex) {
+        occupied_[entry.slot / SlotsCount].reset(entry.slot % SlotsCount);
+    }
+
+    entry.slot = NoIndex;
+    entry.prev = NoIndex;
+    entry.next = NoIndex;
+}
+
+std::shared_ptr<const cs::TimerService::Callback> cs::TimerService::release(uint32_t index) {
+    Entry& entry = entries_[index];
+
+    if (entry.slot != NoIndex) {
+        unlink(index);
+    }
+
+    entry.active = false;
+    entry.posted = false;
+
+    free_.push_back(index);
+    --size_;
+
+    return std::move(entry.callback);
+}
+
+void cs::TimerService::cascade(uint32_t wheel) {
+    const uint32_t position = static_cast<uint32_t>(current_ >> (SlotsBits * wheel)) & (SlotsCount - 1);
+    const uint32_t slot = wheel * SlotsCount + position;
+
+    uint32_t index = slots_[slot];
+
+    slots_[slot] = NoIndex;
+    occupied_[wheel].reset(position);
+
+    while (index != NoIndex) {
+        const uint32_t next = entries_[index].next;
+        link(index);
+        index = next;
+    }
+}
+
+void cs::TimerService::advance(Tick now, std::vector<Expired>& expired) {
+    // nothing is linked, so ticks are not walked one by one
+    if (std::none_of(occupied_.begin(), occupied_.end(), [](const auto& wheel) { return wheel.any(); })) {
+        current_ = std::max(current_, now + 1);
+        return;
+    }
+
+    while (current_ <= now) {
+        const uint32_t position = static_cast<uint32_t>(current_) & (SlotsCount - 1);
+
+        if (position == 0) {
+            for (uint32_t wheel = 1; wheel < WheelsCount; ++wheel) {
+                cascade(wheel);
+
+                if (((current_ >> (SlotsBits * wheel)) & (SlotsCount - 1)) != 0) {
+                    break;
+                }
+            }
+        }
+
+        // periodic timers are linked to later slots, so the loop ends
+        while (slots_[position] != NoIndex) {
+            const uint32_t index = slots_[position];
+            unlink(index);
+            expire(index, expired);
+        }
+
+        ++current_;
+    }
+}
+
+void cs::TimerService::expire(uint32_t index, std::vector<Expired>& expired) {
+    Entry& entry = entries_[index];
+    const Id id = makeId(index, entry.generation);
+
+    if (entry.period != 0) {
+        // phase is kept, missed calls are skipped
+        const Tick missed = (current_ - entry.deadline) / entry.period + 1;
+        entry.deadline += missed * entry.period;
+        link(index);
+    }
+
+    if (entry.executor == Executor::CallsQueue) {
+        post(index);
+    }
+    else {
+        expired.push_back(Expired{id, entry.callback});
+    }
+}
+
+void cs::TimerService::post(uint32_t index) {
+    Entry& entry = entries_[index];
+
+    if (entry.posted) {
+        ++skippedCalls_;
+        return;
+    }
+
+    entry.posted = true;
+
+    CallsQueue::instance().insert([this, id = makeId(index, entry.generation), callback = entry.callback] { callPosted(id, callback); });
+}
+
+void cs::TimerService::callPosted(Id id, const std::shared_ptr<const Callback>& callback) {
+    std::shared_ptr<const Callback> released;
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        const uint32_t index = find(id);
+
+        // cancelled after insertion to CallsQueue
+        if (index == NoIndex || !entries_[index].posted) {
+            return;
+        }
+
+        entries_[index].posted = false;
+
+        if (entries_[index].period == 0) {
+            released = release(index);
+        }
+    }
+
+    (*callback)();
+}
+
+void cs::TimerService::callExpired(const std::vector<Expired>& expired) {
+    for (const auto& element : expired) {
+        std::shared_ptr<const Callback> released;
+
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            const uint32_t index = find(element.id);
+
+            // cancelled by another timer callback
+            if (index == NoIndex) {
+                continue;
+            }
+
+            if (entries_[index].period == 0) {
+                released = release(index);
+            }
+
+            running_ = element.id;
+        }
+
+        (*element.callback)();
+
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            running_ = InvalidId;
+        }
+
+        finished_.notify_all();
+    }
+}
+
+cs::TimerService::Tick cs::TimerService::nextWakeTick() const {
+    Tick result = NoWakeTick;
+    const uint32_t position = static_cast<uint32_t>(current_) & (SlotsCount - 1);
+
+    if (occupied_[0].any()) {
+        for (uint32_t i = 0; i < SlotsCount; ++i) {
+            if (occupied_[0].test((position + i) & (SlotsCount - 1))) {
+                result = current_ + i;
+                break;
+            }
+        }
+    }
+
+    // upper wheels are cascaded at the start of the first wheel turn
+    for (uint32_t wheel = 1; wheel < WheelsCount; ++wheel) {
+        if (occupied_[wheel].any()) {
+            result = std::min(result, (current_ + SlotsCount - 1) & ~Tick(SlotsCount - 1));
+            break;
+        }
+    }
+
+    return result;
+}
+
+void cs::TimerService::routine() {
+    std::vector<Expired> expired;
+    std::unique_lock<std::mutex> lock(mutex_);
+
+    while (!stop_) {
+        advance(nowTick(), expired);
+
+        if (!expired.empty()) {
+            lock.unlock();
+
+            callExpired(expired);
+            expired.clear();
+
+            lock.lock();
+            continue;
+        }
+
+        wakeTick_ = nextWakeTick();
+        wait(lock, wakeTick_);
+        wakeTick_ = 0;
+    }
+}
+
+#ifdef __linux__
+void cs::TimerService::wait(std::unique_lock<std::mutex>& lock, Tick wakeTick) {
+    itimerspec spec{};
+
+    if (wakeTick != NoWakeTick) {
+        // steady clock is CLOCK_MONOTONIC
+        const auto time = start_ + std::chrono::milliseconds(wakeTick);
+        const auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(time.time_since_epoch()).count();
+
+        spec.it_value.tv_sec = static_cast<time_t>(ns / 1000000000);
+        spec.it_value.tv_nsec = static_cast<long>(ns % 1000000000);
+
+        // zero value disarms timer
+        if (spec.it_value.tv_sec == 0 && spec.it_value.tv_nsec == 0) {
+            spec.it_value.tv_nsec = 1;
+        }
+    }
+
+    timerfd_settime(timerFd_, TFD_TIMER_ABSTIME, &spec, nullptr);
+
+    lock.unlock();
+
+    std::array<pollfd, 2> fds{};
+    fds[0].fd = timerFd_;
+    fds[0].events = POLLIN;
+    fds[1].fd = eventFd_;
+    fds[1].events = POLLIN;
+
+    if (poll(fds.data(), fds.size(), -1) > 0) {
+        uint64_t value;
+
+        for (const auto& fd : fds) {
+            if (fd.revents & POLLIN) {
+                [[maybe_unused]] auto res = read(fd.fd, &value, sizeof(value));
+            }
+        }
+    }
+
+    lock.lock();
+}
+
+void cs::TimerService::notify() {
+    static const uint64_t one = 1;
+    [[maybe_unused]] auto res = write(eventFd_, &one, sizeof(one));
+}
+#else
+void cs::TimerService::wait(std::unique_lock<std::mutex>& lock, Tick wakeTick) {
+    auto predicate = [this] { return notified_ || stop_; };
+
+    if (wakeTick == NoWakeTick) {
+        wakeUp_.wait(lock, predicate);
+    }
+    else {
+        wakeUp_.wait_until(lock, start_ + std::chrono::milliseconds(wakeTick), predicate);
+    }
+
+    notified_ = false;
+}
+
+void cs::TimerService::notify() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        notified_ = true;
+    }
+
+    wakeUp_.notify_one();
+}
+#endif
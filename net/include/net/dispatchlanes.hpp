@@ -0,0 +1,105 @@
+#ifndef DISPATCHLANES_HPP
+#define DISPATCHLANES_HPP
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <functional>
+
+#include "packet.hpp"
+
+/* Node messages waiting for transport, grouped by message type, so consensus
+   messages are not queued behind block requests and transaction packets.
+   Messages are pushed and dispatched by the processor thread, stats may be
+   read from any thread */
+class DispatchLanes {
+public:
+    enum Lane : uint8_t {
+        Consensus,
+        RoundTable,
+        Transactions,
+        Sync,
+        Misc,
+        LanesCount
+    };
+
+    // messages of a lane dispatched per call, consensus and round table lanes are drained completely
+    static constexpr std::array<size_t, LanesCount> Budgets = {0, 0, 32, 4, 16};
+
+    // limits of all lanes together, the oldest transactions and misc messages are dropped to fit them,
+    // consensus, round table and sync messages are never dropped
+    static constexpr size_t MaxDepth = 1 << 14;
+    static constexpr size_t MaxBytes = 1 << 26;
+    // queued messages keep packet collector slots, half of them are left for messages being collected
+    static constexpr size_t MaxMessages = PacketCollector::MaxParallelCollections / 2;
+
+    struct Item {
+        // complete fragmented or compressed message, packet is used if it is null
+        MessagePtr message;
+        Packet packet;
+        std::chrono::steady_clock::time_point enqueued;
+        size_t bytes;
+    };
+
+    struct Stats {
+        size_t depth = 0;
+        size_t maxDepth = 0;
+        uint64_t dispatched = 0;
+        uint64_t dropped = 0;
+        size_t bytes = 0;
+        // time from push to dispatch
+        uint64_t waitMicroseconds = 0;
+        uint64_t maxWaitMicroseconds = 0;
+
+        double averageWaitMicroseconds() const {
+            return dispatched != 0 ? static_cast<double>(waitMicroseconds) / static_cast<double>(dispatched) : 0.0;
+        }
+    };
+
+    static Lane laneOf(MsgTypes type);
+    static const char* laneName(Lane lane);
+    static bool isDroppable(Lane lane);
+
+    // returns false if lanes are full and the item is not droppable,
+    // caller should dispatch queued messages and push it again
+    bool push(const Packet& packet);
+    bool push(const MessagePtr& message);
+
+    bool isEmpty() const;
+
+    // drains consensus and round table lanes, then calls handler for budget items of every other lane,
+    // higher lanes are not checked again during the call as only the caller thread pushes messages
+    void dispatch(const std::function<void(const Item&)>& handler);
+
+    Stats stats(Lane lane) const;
+
+private:
+    struct State {
+        std::deque<Item> queue;
+
+        std::atomic<size_t> depth = {0};
+        std::atomic<size_t> maxDepth = {0};
+        std::atomic<uint64_t> dispatched = {0};
+        std::atomic<uint64_t> dropped = {0};
+        std::atomic<size_t> bytes = {0};
+        std::atomic<uint64_t> waitMicroseconds = {0};
+        std::atomic<uint64_t> maxWaitMicroseconds = {0};
+    };
+
+    bool push(Item&& item, MsgTypes type);
+    bool fits(const Item& item) const;
+    void dropOldest(State& state);
+
+    Item popFront(State& state);
+    void dispatchOne(State& state, const std::function<void(const Item&)>& handler);
+
+    std::array<State, LanesCount> lanes_;
+
+    // totals of all lanes, used by the processor thread only
+    size_t depth_ = 0;
+    size_t bytes_ = 0;
+    size_t messages_ = 0;
+};
+
+#endif  // DISPATCHLANES_HPP
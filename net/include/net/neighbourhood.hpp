@@ -62,6 +62,7 @@ struct Connection {
     , in(std::move(rhs.in))
     , specialOut(rhs.specialOut)
     , out(std::move(rhs.out))
+    , packetSize(rhs.packetSize)
     , node(std::move(rhs.node))
     , isSignal(rhs.isSignal)
     , connected(rhs.connected)
@@ -90,6 +91,9 @@ struct Connection {
     bool specialOut = false;
     ip::udp::endpoint out;
 
+    // fragment size accepted by remote node
+    uint32_t packetSize = Packet::MaxSize;
+
     RemoteNodePtr node;
 
     bool isSignal = false;
@@ -103,7 +107,7 @@ struct Connection {
         bool needSend = true;
     };
 
-    FixedHashMap<cs::Hash, MsgRel, uint16_t, MaxMessagesToKeep> msgRels;
+    FixedHashMap<cs::Hash, MsgRel, uint64_t, MaxMessagesToKeep> msgRels;
 
     cs::Sequence syncSeqs[BlocksToSync] = {0};
     cs::Sequence syncSeqsRetries[BlocksToSync] = {0};
@@ -133,7 +137,7 @@ public:
     void addSignalServer(const ip::udp::endpoint& in, const ip::udp::endpoint& out, RemoteNodePtr);
 
     void gotRegistration(Connection&&, RemoteNodePtr);
-    void gotConfirmation(const Connection::Id& my, const Connection::Id& real, const ip::udp::endpoint&, const cs::PublicKey&, RemoteNodePtr);
+    void gotConfirmation(const Connection::Id& my, const Connection::Id& real, const ip::udp::endpoint&, const cs::PublicKey&, const uint32_t packetSize, RemoteNodePtr);
     void gotRefusal(const Connection::Id&);
 
     void resendPackets();
@@ -222,7 +226,7 @@ private:
     FixedVector<ConnectionPtr, MaxNeighbours> neighbours_;
 
     mutable cs::SpinLock mLockFlag_{ATOMIC_FLAG_INIT};
-    FixedHashMap<ip::udp::endpoint, ConnectionPtr, uint16_t, MaxConnections> connections_;
+    FixedHashMap<ip::udp::endpoint, ConnectionPtr, uint64_t, MaxConnections> connections_;
 
     struct SenderInfo {
         uint32_t totalSenders = 0;
@@ -230,9 +234,9 @@ private:
         ConnectionPtr prioritySender;
     };
 
-    FixedHashMap<cs::Hash, SenderInfo, uint16_t, MaxMessagesToKeep> msgSenders_;
-    FixedHashMap<cs::Hash, BroadPackInfo, uint16_t, 10000> msgBroads_;
-    FixedHashMap<cs::Hash, DirectPackInfo, uint16_t, 10000> msgDirects_;
+    FixedHashMap<cs::Hash, SenderInfo, uint64_t, MaxMessagesToKeep> msgSenders_;
+    FixedHashMap<cs::Hash, BroadPackInfo, uint64_t, 10000> msgBroads_;
+    FixedHashMap<cs::Hash, DirectPackInfo, uint64_t, 10000> msgDirects_;
 };
 
 #endif  // NEIGHBOURHOOD_HPP
@@ -7,8 +7,13 @@
 #endif
 #include <boost/asio.hpp>
 
+#include <chrono>
+#include <memory>
+#include <vector>
+
 #include <client/config.hpp>
 #include <lib/system/cache.hpp>
+#include "dispatchlanes.hpp"
 #include "pacmans.hpp"
 
 using io_context = boost::asio::io_context;
@@ -32,6 +37,10 @@ public:
     bool resendFragment(const cs::Hash&, const uint16_t, const ip::udp::endpoint&);
     void registerMessage(Packet*, const uint32_t size);
 
+    const DispatchLanes& lanes() const {
+        return lanes_;
+    }
+
     Network(const Network&) = delete;
     Network(Network&&) = delete;
     Network& operator=(const Network&) = delete;
@@ -44,12 +53,31 @@ public:
     };
 
 private:
-    void readerRoutine(const Config&);
+    // input queue of one reader thread, sender endpoint is bound to one shard by kernel
+    struct ReceiveShard {
+        explicit ReceiveShard(const uint32_t packetSize)
+        : pacman(packetSize) {
+        }
+
+        IPacMan pacman;
+        std::thread thread;
+        __cacheline_aligned std::atomic<ThreadStatus> status = {NonInit};
+#ifdef __linux__
+        int eventfd = -1;
+#endif
+    };
+
+    void readerRoutine(const Config&, ReceiveShard&);
+#ifdef __linux__
+    void readerBatchRoutine(ip::udp::socket&, ReceiveShard&, const size_t batchSize);
+    void readerGroRoutine(ip::udp::socket&, ReceiveShard&, const size_t batchSize);
+#endif
     void writerRoutine(const Config&);
     void processorRoutine();
     inline void processTask(TaskPtr<IPacMan>&);
+    void dispatchQueued();
 
-    ip::udp::socket* getSocketInThread(const bool, const EndpointData&, std::atomic<ThreadStatus>&, const bool useIPv6);
+    ip::udp::socket* getSocketInThread(const bool, const EndpointData&, std::atomic<ThreadStatus>&, const bool useIPv6, const bool reusePort);
 
     bool good_;
     bool stopReaderRoutine = false;
@@ -59,28 +87,36 @@ private:
     io_context context_;
     ip::udp::resolver resolver_;
 
-    IPacMan iPacMan_;
+    std::vector<std::unique_ptr<ReceiveShard>> shards_;
     OPacMan oPacMan_;
 
     Transport* transport_;
 
-    FixedHashMap<cs::Hash, uint32_t, uint16_t, 100000> packetMap_;
+    // times packet was received and its cryptographic hash, which is reused for repeated packets
+    struct ReceivedPacket {
+        uint32_t counter = 0;
+        bool hashed = false;
+        cs::Hash hash;
+    };
+
+    FixedHashMap<cs::Identity, ReceivedPacket, uint64_t, 100000> packetMap_;
 
     // Only needed in a one-socket configuration
     __cacheline_aligned std::atomic<bool> singleSockOpened_ = {false};
     __cacheline_aligned std::atomic<ip::udp::socket*> singleSock_ = {nullptr};
     std::atomic<bool> initFlag_ = {false};
 
-    __cacheline_aligned std::atomic<ThreadStatus> readerStatus_ = {NonInit};
     __cacheline_aligned std::atomic<ThreadStatus> writerStatus_ = {NonInit};
 
-    std::thread readerThread_;
     std::thread writerThread_;
     std::thread processorThread_;
 
     PacketCollector collector_;
+
+    // node messages are handled by priority of their lanes
+    DispatchLanes lanes_;
+    std::chrono::steady_clock::time_point lanesLogTime_;
 #ifdef __linux__
-    int readerEventfd_;
     int writerEventfd_;
 #elif WIN32
     HANDLE readerEvent_ = nullptr;
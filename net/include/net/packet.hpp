@@ -12,15 +12,17 @@
 
 #include <lz4.h>
 
+#include <algorithm>
+#include <bitset>
 #include <iostream>
 #include <memory>
 
 /*
-    Static min memory usage (see types below):
+    Memory usage (see types below):
 
     1 fragment = 1'024 b
-    1 message = 80 b * 4'096 fragments = 327'680 b
-    1 collector = 2'048 messages * 327'680 b = 671'088'640 b
+    1 message = ~600 b + 96 b * fragments count, storage is taken when the first fragment comes
+    1 collector = 1'024 messages * ~600 b = ~600 Kb static
 */
 
 namespace ip = boost::asio::ip;
@@ -84,13 +86,20 @@ enum MsgTypes : uint8_t {
 
 class Packet {
 public:
-    static const uint32_t MaxSize = 1024;
+    // fragment size every node accepts, larger sizes are advertised on registration
+    static constexpr uint32_t MaxSize = 1024;
+    // upper bound of configured fragment size
+    static constexpr uint32_t MaxConfigurableSize = 8192;
     static const uint32_t MaxFragments = 4096;
 
     static const uint32_t SmartRedirectTreshold = 10000;
 
     static const char* messageTypeToString(MsgTypes messageType);
 
+    static uint32_t validSize(const uint32_t size) {
+        return std::clamp(size, MaxSize, MaxConfigurableSize);
+    }
+
     Packet() = default;
     explicit Packet(RegionPtr&& data)
     : region_(std::move(data)) {
@@ -128,6 +137,26 @@ public:
         return hash_;
     }
 
+    bool isHashed() const {
+        return hashed_;
+    }
+
+    // cryptographic hash is known from an equal packet
+    void setHash(const cs::Hash& hash) const {
+        hash_ = hash;
+        hashed_ = true;
+    }
+
+    // fast hash for local dedup, getHash() is used when the hash is sent
+    const cs::Identity& getIdentity() const {
+        if (!identified_) {
+            identity_ = cs::generateIdentity(region_->data(), region_->size());
+            identified_ = true;
+        }
+
+        return identity_;
+    }
+
     bool addressedToMe(const cs::PublicKey& myKey) const {
         return isNetwork() || isNeighbors() || (isBroadcast() && !(getSender() == myKey)) || getAddressee() == myKey;
     }
@@ -204,8 +233,8 @@ public:
             static_assert(sizeof(BaseFlags) == sizeof(char), "BaseFlags should be char sized");
             const size_t headerSize = getHeadersLength();
 
-            // Packet::MaxSize is a part of implementation magic(
-            assert(tempBuffer.size() == Packet::MaxSize);
+            // buffer should hold any encoded packet of this node
+            assert(tempBuffer.size() >= region_->size());
 
             char* source = static_cast<char*>(region_->data());
             char* dest = static_cast<char*>(tempBuffer.data());
@@ -254,15 +283,14 @@ public:
                 return 0;
             }
 
-            // It's a part of implementation magic(
-            // eg. <IPackMan> allocates Packet::MaxSize packet implicitly
-            assert(region_->size() == Packet::MaxSize);
+            // <IPackMan> allocates packets of the size this node accepts, decoded data should fit it
+            assert(region_->size() <= Packet::MaxConfigurableSize);
 
             char* source = static_cast<char*>(region_->data());
-            char dest[Packet::MaxSize];
+            char dest[Packet::MaxConfigurableSize];
 
             int sourceSize = static_cast<int>(packetSize - headerSize);
-            int destSize = static_cast<int>(sizeof(dest) - headerSize);
+            int destSize = static_cast<int>(region_->size() - headerSize);
 
             auto uncompressedSize = LZ4_decompress_safe(source + headerSize, dest, sourceSize, destSize);
 
@@ -316,6 +344,9 @@ private:
     mutable bool headerHashed_ = false;
     mutable cs::Hash headerHash_;
 
+    mutable bool identified_ = false;
+    mutable cs::Identity identity_;
+
     mutable uint32_t headersLength_ = 0;
 
     friend class IPacMan;
@@ -328,8 +359,8 @@ class Message {
 public:
     Message() = default;
 
-    Message(Message&&) = default;
-    Message& operator=(Message&&) = default;
+    Message(Message&&) = delete;
+    Message& operator=(Message&&) = delete;
 
     Message(const Message&) = delete;
     Message& operator=(const Message&) = delete;
@@ -371,20 +402,19 @@ public:
         return result;
     }
 
-    // scans array of future fragments and clears all dirty elements, scans only the first maxFragment elements
-    // return cleared elements count
-    size_t clearFragments() {
-        return clearBuffer(0, maxFragment_);
-    }
-
-    // scans array of future fragments and clears all dirty elements, scans only unused behind the maxFragment elements
-    // return cleared elements count
-    size_t clearUnused() {
-        return clearBuffer(maxFragment_, Packet::MaxFragments);
+    bool hasFragment(const uint32_t id) const {
+        return id < packetsTotal_ && received_.test(id);
     }
 
 private:
-    size_t clearBuffer(size_t from, size_t to);
+    // takes storage for count fragments, all of them are not received
+    void allocateFragments(const uint32_t count);
+
+    // returns false if fragment does not fit the message or has already been received
+    bool storeFragment(const Packet&);
+
+    // copies payload of received fragment to its place in assembly buffer
+    void assembleFragment(const uint32_t id);
 
     static RegionAllocator allocator_;
 
@@ -395,8 +425,15 @@ private:
     uint32_t packetsLeft_;
     uint32_t packetsTotal_ = 0;
 
-    uint16_t maxFragment_ = 0;
-    Packet packets_[Packet::MaxFragments];
+    RegionPtr fragmentsRegion_;
+    Packet* packets_ = nullptr;
+    std::bitset<Packet::MaxFragments> received_;
+
+    // all fragments but the last are of the same size, so payload is assembled as fragments come,
+    // otherwise composeFullData() copies fragments when message is complete
+    mutable RegionPtr assembly_;
+    uint32_t fragmentPayload_ = 0;
+    bool irregular_ = false;
 
     cs::Hash headerHash_;
 
@@ -423,9 +460,8 @@ private:
     TypedAllocator<Message> msgAllocator_;
 
     cs::SpinLock mLock_{ATOMIC_FLAG_INIT};
-    FixedHashMap<cs::Hash, MessagePtr, uint16_t, MaxParallelCollections> map_;
+    FixedHashMap<cs::Hash, MessagePtr, uint64_t, MaxParallelCollections> map_;
 
-    Message lastMessage_;
     friend class Network;
 };
 
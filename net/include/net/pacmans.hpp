@@ -2,11 +2,12 @@
 #ifndef PACMANS_HPP
 #define PACMANS_HPP
 
-#include <list>
-#include <mutex>
 #include <atomic>
+#include <vector>
 #include <boost/asio.hpp>
 
+#include <lib/system/queues.hpp>
+
 #include "packet.hpp"
 
 namespace ip = boost::asio::ip;
@@ -40,10 +41,10 @@ public:
   }
 
   typename Pacman::Task* operator->() {
-    return &(static_cast<typename Pacman::Task&>(*it_));
+    return &(it_->element);
   }
   const typename Pacman::Task* operator->() const {
-    return &(static_cast<typename Pacman::Task&>(*it_));
+    return &(it_->element);
   }
 
 private:
@@ -65,52 +66,89 @@ struct TaskBody {
   char data[sizeof(Task)];
 };
 */
+/* Input packets ring: one reader thread fills slots, one processor
+   thread handles them. Slot regions are reused when nobody else holds
+   the packet after processing */
 class IPacMan {
 public:
-  IPacMan()
+  static constexpr size_t QueueSize = 1 << 14;
+
+  // packetSize is the biggest datagram accepted
+  explicit IPacMan(uint32_t packetSize = Packet::MaxSize)
+  : packetSize_(packetSize)
   {}
 
+  uint32_t packetSize() const {
+    return packetSize_;
+  }
+
   struct Task {
     ip::udp::endpoint sender;
     size_t size;
     Packet pack;
   };
 
+  using Queue = BoundedQueue<Task, QueueSize>;
+
+  // returns the same slot again if the last one was rejected
   Task& allocNext();
   void enQueueLast();
 
+  // locks count slots for writing, slots not enqueued by the previous batch come first
+  void allocBatch(size_t count);
+  Task& batchTask(size_t index);
+
+  // enqueues accepted batch tasks keeping their order, returns enqueued count
+  size_t enQueueBatch(const std::vector<bool>& accepted);
+
   TaskPtr<IPacMan> getNextTask();
 
-  using TaskIterator = std::list<Task>::iterator;
+  using TaskIterator = Queue::Element*;
   void releaseTask(TaskIterator&);
   void rejectLast();
 
 private:
-  std::list<Task> queue_;
-  std::mutex mutex_;
-  std::atomic<size_t> size_ = {0};
+  void prepare(Task& task);
+
+  Queue queue_;
+
+  // slots locked for writing in queue order
+  std::vector<TaskIterator> pending_;
   RegionAllocator allocator_;
+  uint32_t packetSize_;
 };
 
+/* Output packets ring: any thread may enqueue a packet, one writer
+   thread sends them */
 class OPacMan {
 public:
+  static constexpr size_t QueueSize = 1 << 12;
+
   struct Task {
     ip::udp::endpoint endpoint;
     Packet pack;
   };
 
-  Task* allocNext();
-  void enQueueLast();
+  using Queue = BoundedQueue<Task, QueueSize>;
+
+  // single transactions, misc and network datagrams are dropped if the queue is full, so a sending thread
+  // never waits for the network; consensus, round table and sync messages and fragments of any message
+  // wait for a free slot as losing them stalls the round or loses the whole message;
+  // returns false if the packet was dropped and the writer should not be signaled
+  bool enQueue(const Packet& pack, const ip::udp::endpoint& endpoint);
+
+  uint64_t dropped() const {
+    return dropped_.load(std::memory_order_relaxed);
+  }
 
   TaskPtr<OPacMan> getNextTask();
 
-  using TaskIterator = std::list<Task>::iterator;
+  using TaskIterator = Queue::Element*;
   void releaseTask(TaskIterator&);
 
 private:
-  std::list<Task> queue_;
-  std::mutex mutex_;
-  std::atomic<size_t> size_ = {0};
+  Queue queue_;
+  std::atomic<uint64_t> dropped_ = {0};
 };
 
 #endif  // PACMANS_HPP
@@ -67,7 +67,7 @@ enum class SSBootstrapStatus : uint8_t {
 };
 
 template <>
-uint16_t getHashIndex(const ip::udp::endpoint&);
+uint64_t getHashIndex(const ip::udp::endpoint&);
 
 class Transport {
 public:
@@ -110,6 +110,11 @@ public:
         return myPublicKey_;
     }
 
+    // fragment size this node accepts
+    uint32_t getPacketSize() const {
+        return Packet::validSize(config_.getPacketSize());
+    }
+
     bool isGood() const {
         return good_;
     }
@@ -218,7 +223,7 @@ private:
 
     TypedAllocator<RemoteNode> remoteNodes_;
 
-    FixedHashMap<ip::udp::endpoint, RemoteNodePtr, uint16_t, maxRemoteNodes_> remoteNodesMap_;
+    FixedHashMap<ip::udp::endpoint, RemoteNodePtr, uint64_t, maxRemoteNodes_> remoteNodesMap_;
 
     RegionAllocator netPacksAllocator_;
     cs::PublicKey myPublicKey_;
@@ -270,7 +275,7 @@ private:
     Neighbourhood nh_;
 
     static constexpr uint32_t fragmentsFixedMapSize_ = 10000;
-    FixedHashMap<cs::Hash, cs::RoundNumber, uint16_t, fragmentsFixedMapSize_> fragOnRound_;
+    FixedHashMap<cs::Hash, cs::RoundNumber, uint64_t, fragmentsFixedMapSize_> fragOnRound_;
 
 public:
     inline static size_t cntDirtyAllocs = 0;
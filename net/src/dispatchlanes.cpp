@@ -0,0 +1,195 @@
+#include "dispatchlanes.hpp"
+
+DispatchLanes::Lane DispatchLanes::laneOf(MsgTypes type) {
+    switch (type) {
+        case MsgTypes::BlockHash:
+        case MsgTypes::HashReply:
+        case MsgTypes::FirstStage:
+        case MsgTypes::SecondStage:
+        case MsgTypes::ThirdStage:
+        case MsgTypes::FirstStageRequest:
+        case MsgTypes::SecondStageRequest:
+        case MsgTypes::ThirdStageRequest:
+        case MsgTypes::FirstSmartStage:
+        case MsgTypes::SecondSmartStage:
+        case MsgTypes::ThirdSmartStage:
+        case MsgTypes::SmartFirstStageRequest:
+        case MsgTypes::SmartSecondStageRequest:
+        case MsgTypes::SmartThirdStageRequest:
+        case MsgTypes::RejectedContracts:
+            return Consensus;
+
+        // packets of the current round table are needed to build its block
+        case MsgTypes::RoundTable:
+        case MsgTypes::RoundTableSS:
+        case MsgTypes::RoundTableRequest:
+        case MsgTypes::RoundTableReply:
+        case MsgTypes::RoundPackRequest:
+        case MsgTypes::EmptyRoundPack:
+        case MsgTypes::BigBang:
+        case MsgTypes::TransactionsPacketRequest:
+        case MsgTypes::TransactionsPacketReply:
+            return RoundTable;
+
+        case MsgTypes::Transactions:
+        case MsgTypes::FirstTransaction:
+        case MsgTypes::TransactionPacket:
+            return Transactions;
+
+        case MsgTypes::NewBlock:
+        case MsgTypes::BlockRequest:
+        case MsgTypes::RequestedBlock:
+            return Sync;
+
+        default:
+            return Misc;
+    }
+}
+
+const char* DispatchLanes::laneName(Lane lane) {
+    switch (lane) {
+        case Consensus:
+            return "consensus";
+        case RoundTable:
+            return "round table";
+        case Transactions:
+            return "transactions";
+        case Sync:
+            return "sync";
+        default:
+            return "misc";
+    }
+}
+
+bool DispatchLanes::isDroppable(Lane lane) {
+    return lane == Transactions || lane == Misc;
+}
+
+bool DispatchLanes::push(const Packet& packet) {
+    return push(Item{MessagePtr(), packet, std::chrono::steady_clock::now(), packet.size()}, packet.getType());
+}
+
+bool DispatchLanes::push(const MessagePtr& message) {
+    return push(Item{message, Packet(), std::chrono::steady_clock::now(), message->getFullSize()}, message->getFirstPack().getType());
+}
+
+bool DispatchLanes::isEmpty() const {
+    for (const auto& state : lanes_) {
+        if (!state.queue.empty()) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+void DispatchLanes::dispatch(const std::function<void(const Item&)>& handler) {
+    for (size_t lane = 0; lane < LanesCount; ++lane) {
+        State& state = lanes_[lane];
+        const size_t budget = Budgets[lane];
+
+        for (size_t i = 0; !state.queue.empty() && (budget == 0 || i < budget); ++i) {
+            dispatchOne(state, handler);
+        }
+    }
+}
+
+DispatchLanes::Stats DispatchLanes::stats(Lane lane) const {
+    const State& state = lanes_[lane];
+    Stats result;
+
+    result.depth = state.depth.load(std::memory_order_relaxed);
+    result.maxDepth = state.maxDepth.load(std::memory_order_relaxed);
+    result.dispatched = state.dispatched.load(std::memory_order_relaxed);
+    result.dropped = state.dropped.load(std::memory_order_relaxed);
+    result.bytes = state.bytes.load(std::memory_order_relaxed);
+    result.waitMicroseconds = state.waitMicroseconds.load(std::memory_order_relaxed);
+    result.maxWaitMicroseconds = state.maxWaitMicroseconds.load(std::memory_order_relaxed);
+
+    return result;
+}
+
+bool DispatchLanes::push(Item&& item, MsgTypes type) {
+    const Lane lane = laneOf(type);
+    State& state = lanes_[lane];
+
+    // the oldest messages of the lowest lanes are dropped first, droppable item does not push out higher lanes
+    for (size_t victim = LanesCount; victim-- > 0 && !fits(item);) {
+        if (!isDroppable(static_cast<Lane>(victim)) || (isDroppable(lane) && victim < lane)) {
+            continue;
+        }
+
+        while (!lanes_[victim].queue.empty() && !fits(item)) {
+            dropOldest(lanes_[victim]);
+        }
+    }
+
+    if (!fits(item)) {
+        if (!isDroppable(lane)) {
+            return false;
+        }
+
+        state.dropped.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+
+    depth_ += 1;
+    bytes_ += item.bytes;
+    messages_ += item.message ? 1 : 0;
+    state.bytes.fetch_add(item.bytes, std::memory_order_relaxed);
+
+    state.queue.push_back(std::move(item));
+
+    const size_t depth = state.queue.size();
+    state.depth.store(depth, std::memory_order_relaxed);
+
+    if (depth > state.maxDepth.load(std::memory_order_relaxed)) {
+        state.maxDepth.store(depth, std::memory_order_relaxed);
+    }
+
+    return true;
+}
+
+bool DispatchLanes::fits(const Item& item) const {
+    // a single item is accepted by empty lanes whatever its size is
+    if (depth_ == 0) {
+        return true;
+    }
+
+    return depth_ < MaxDepth && bytes_ + item.bytes <= MaxBytes && (!item.message || messages_ < MaxMessages);
+}
+
+void DispatchLanes::dropOldest(State& state) {
+    popFront(state);
+    state.dropped.fetch_add(1, std::memory_order_relaxed);
+}
+
+DispatchLanes::Item DispatchLanes::popFront(State& state) {
+    Item item = std::move(state.queue.front());
+    state.queue.pop_front();
+
+    depth_ -= 1;
+    bytes_ -= item.bytes;
+    messages_ -= item.message ? 1 : 0;
+
+    state.depth.store(state.queue.size(), std::memory_order_relaxed);
+    state.bytes.fetch_sub(item.bytes, std::memory_order_relaxed);
+
+    return item;
+}
+
+void DispatchLanes::dispatchOne(State& state, const std::function<void(const Item&)>& handler) {
+    const Item item = popFront(state);
+
+    const auto wait = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - item.enqueued);
+    const uint64_t waitMicroseconds = static_cast<uint64_t>(wait.count());
+
+    state.dispatched.fetch_add(1, std::memory_order_relaxed);
+    state.waitMicroseconds.fetch_add(waitMicroseconds, std::memory_order_relaxed);
+
+    if (waitMicroseconds > state.maxWaitMicroseconds.load(std::memory_order_relaxed)) {
+        state.maxWaitMicroseconds.store(waitMicroseconds, std::memory_order_relaxed);
+    }
+
+    handler(item);
+}
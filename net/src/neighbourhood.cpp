@@ -394,6 +394,7 @@ void Neighbourhood::gotRegistration(Connection&& conn, RemoteNodePtr node) {
         connPtr->in = conn.in;
         connPtr->specialOut = conn.specialOut;
         connPtr->out = conn.out;
+        connPtr->packetSize = conn.packetSize;
     }
 
     connectNode(node, connPtr);
@@ -407,7 +408,8 @@ void Neighbourhood::gotRegistration(Connection&& conn, RemoteNodePtr node) {
     transport_->sendRegistrationConfirmation(**connPtr, conn.id);
 }
 
-void Neighbourhood::gotConfirmation(const Connection::Id& my, const Connection::Id& real, const ip::udp::endpoint& ep, const cs::PublicKey& pk, RemoteNodePtr node) {
+void Neighbourhood::gotConfirmation(const Connection::Id& my, const Connection::Id& real, const ip::udp::endpoint& ep, const cs::PublicKey& pk, const uint32_t packetSize,
+                                    RemoteNodePtr node) {
     cs::ScopedLock scopedLock(mLockFlag_, nLockFlag_);
     ConnectionPtr* connPtr = findInMap(my, connections_);
 
@@ -423,6 +425,7 @@ void Neighbourhood::gotConfirmation(const Connection::Id& my, const Connection::
     }
 
     (*connPtr)->key = pk;
+    (*connPtr)->packetSize = packetSize;
 
     if (my != real) {
         (*connPtr)->id = real;
@@ -5,12 +5,22 @@
 #include <thread>
 
 #ifdef __linux__
+#include <netinet/udp.h>
 #include <sys/eventfd.h>
 #include <sys/poll.h>
 #include <sys/socket.h>
 #include <unistd.h>
 #include <array>
+#include <cstring>
 #include <vector>
+
+// not defined by old glibc headers
+#ifndef UDP_SEGMENT
+#define UDP_SEGMENT 103
+#endif
+#ifndef UDP_GRO
+#define UDP_GRO 104
+#endif
 #endif
 
 #ifdef __APPLE__
@@ -32,7 +42,7 @@ using boost::asio::buffer;
 
 const ip::udp::socket::message_flags NO_FLAGS = 0;
 
-static ip::udp::socket bindSocket(io_context& context, Network* net, const EndpointData& data, bool ipv6 = true) {
+static ip::udp::socket bindSocket(io_context& context, Network* net, const EndpointData& data, bool ipv6 = true, bool reusePort = false) {
     try {
         ip::udp::socket sock(context, ipv6 ? ip::udp::v6() : ip::udp::v4());
 
@@ -41,6 +51,15 @@ static ip::udp::socket bindSocket(io_context& context, Network* net, const Endpo
         }
 
         sock.set_option(ip::udp::socket::reuse_address(true));
+#ifdef __linux__
+        if (reusePort) {
+            int enable = 1;
+
+            if (setsockopt(sock.native_handle(), SOL_SOCKET, SO_REUSEPORT, &enable, sizeof(enable)) != 0) {
+                cserror() << "Cannot set SO_REUSEPORT, errno = " << errno;
+            }
+        }
+#endif
 #ifndef __APPLE__
         sock.set_option(ip::udp::socket::send_buffer_size(1 << 23));
         sock.set_option(ip::udp::socket::receive_buffer_size(1 << 23));
@@ -73,11 +92,12 @@ ip::udp::endpoint Network::resolve(const EndpointData& data) {
     return ip::udp::endpoint(data.ip, data.port);
 }
 
-ip::udp::socket* Network::getSocketInThread(const bool openOwn, const EndpointData& epd, std::atomic<Network::ThreadStatus>& status, const bool ipv6) {
+ip::udp::socket* Network::getSocketInThread(const bool openOwn, const EndpointData& epd, std::atomic<Network::ThreadStatus>& status, const bool ipv6,
+                                            const bool reusePort) {
     ip::udp::socket* result = nullptr;
 
     if (openOwn) {
-        result = new ip::udp::socket(bindSocket(context_, this, epd, ipv6));
+        result = new ip::udp::socket(bindSocket(context_, this, epd, ipv6, reusePort));
 
         if (!result->is_open()) {
             result = nullptr;
@@ -94,8 +114,183 @@ ip::udp::socket* Network::getSocketInThread(const bool openOwn, const EndpointDa
     return result;
 }  // resolve
 
-void Network::readerRoutine(const Config& config) {
-    ip::udp::socket* sock = getSocketInThread(config.hasTwoSockets(), config.getInputEndpoint(), readerStatus_, config.useIPv6());
+// decodes received packet, returns false if packet should be dropped
+static bool acceptReceived(IPacMan::Task& task, size_t packetSize) {
+    if (!(task.pack.isHeaderValid())) {
+        static constexpr size_t limit = 100;
+        auto size = (task.pack.size() <= limit) ? task.pack.size() : limit;
+
+        cswarning() << "from socket Header is not valid: " << cs::Utils::byteStreamToHex(static_cast<const char*>(task.pack.data()), size);
+    }
+
+    task.size = task.pack.decode(packetSize);  // try to decode first
+
+    if (task.size == 0) {
+        cswarning() << "Ignore incorrect packet fragment, drop";
+        return false;
+    }
+
+    if (!task.pack.hasValidFragmentation()) {
+        cswarning() << "Incorrect fragment identity in message or too many fragments, drop (" << task.pack.getFragmentId() << " from " << task.pack.getFragmentsNum()
+                    << "), sender " << task.sender;
+        return false;
+    }
+
+#ifdef LOG_NET
+    csdebug(logger::Net) << "<-- " << packetSize << " bytes from " << task.sender << " " << task.pack;
+#endif
+
+    return true;
+}
+
+#ifdef __linux__
+void Network::readerBatchRoutine(ip::udp::socket& sock, ReceiveShard& shard, const size_t batchSize) {
+    std::vector<struct mmsghdr> messages(batchSize);
+    std::vector<struct iovec> iovecs(batchSize);
+    std::vector<bool> accepted(batchSize);
+
+    while (stopReaderRoutine == false) {
+        shard.pacman.allocBatch(batchSize);
+
+        for (size_t i = 0; i < batchSize; ++i) {
+            auto& task = shard.pacman.batchTask(i);
+
+            iovecs[i].iov_base = task.pack.data();
+            iovecs[i].iov_len = task.pack.size();
+
+            messages[i] = mmsghdr{};
+            messages[i].msg_hdr.msg_iov = &iovecs[i];
+            messages[i].msg_hdr.msg_iovlen = 1;
+            messages[i].msg_hdr.msg_name = task.sender.data();
+            messages[i].msg_hdr.msg_namelen = static_cast<socklen_t>(task.sender.capacity());
+        }
+
+        // blocks until at least one datagram, then takes the rest available without waiting
+        const int received = recvmmsg(sock.native_handle(), messages.data(), static_cast<unsigned int>(batchSize), MSG_WAITFORONE, nullptr);
+
+        if (stopReaderRoutine) {
+            return;
+        }
+
+        if (received <= 0) {
+            if (errno != EINTR && errno != EAGAIN) {
+                cserror() << "Cannot receive packets. Error " << errno;
+            }
+
+            continue;
+        }
+
+        for (size_t i = 0; i < batchSize; ++i) {
+            accepted[i] = false;
+
+            if (i < static_cast<size_t>(received)) {
+                auto& task = shard.pacman.batchTask(i);
+                task.sender.resize(messages[i].msg_hdr.msg_namelen);
+
+                accepted[i] = acceptReceived(task, messages[i].msg_len);
+            }
+        }
+
+        uint64_t count = shard.pacman.enQueueBatch(accepted);
+
+        if (count) {
+            [[maybe_unused]] auto res = write(shard.eventfd, &count, sizeof(uint64_t));
+        }
+    }
+}
+
+// kernel coalesces datagrams of one flow into a buffer, segments are copied to IPacMan slots
+void Network::readerGroRoutine(ip::udp::socket& sock, ReceiveShard& shard, const size_t batchSize) {
+    constexpr size_t bufferSize = 1 << 16;
+    constexpr size_t controlSize = CMSG_SPACE(sizeof(int));
+
+    std::vector<cs::Byte> buffers(batchSize * bufferSize);
+    std::vector<std::array<char, controlSize>> controls(batchSize);
+    std::vector<ip::udp::endpoint> senders(batchSize);
+    std::vector<struct mmsghdr> messages(batchSize);
+    std::vector<struct iovec> iovecs(batchSize);
+    std::vector<bool> accepted;
+
+    while (stopReaderRoutine == false) {
+        for (size_t i = 0; i < batchSize; ++i) {
+            iovecs[i].iov_base = buffers.data() + i * bufferSize;
+            iovecs[i].iov_len = bufferSize;
+
+            messages[i] = mmsghdr{};
+            messages[i].msg_hdr.msg_iov = &iovecs[i];
+            messages[i].msg_hdr.msg_iovlen = 1;
+            messages[i].msg_hdr.msg_name = senders[i].data();
+            messages[i].msg_hdr.msg_namelen = static_cast<socklen_t>(senders[i].capacity());
+            messages[i].msg_hdr.msg_control = controls[i].data();
+            messages[i].msg_hdr.msg_controllen = controlSize;
+        }
+
+        const int received = recvmmsg(sock.native_handle(), messages.data(), static_cast<unsigned int>(batchSize), MSG_WAITFORONE, nullptr);
+
+        if (stopReaderRoutine) {
+            return;
+        }
+
+        if (received <= 0) {
+            if (errno != EINTR && errno != EAGAIN) {
+                cserror() << "Cannot receive packets. Error " << errno;
+            }
+
+            continue;
+        }
+
+        uint64_t count = 0;
+
+        for (size_t i = 0; i < static_cast<size_t>(received); ++i) {
+            auto& header = messages[i].msg_hdr;
+            const size_t length = messages[i].msg_len;
+            size_t segmentSize = length;
+
+            for (auto cmsg = CMSG_FIRSTHDR(&header); cmsg != nullptr; cmsg = CMSG_NXTHDR(&header, cmsg)) {
+                if (cmsg->cmsg_level == SOL_UDP && cmsg->cmsg_type == UDP_GRO) {
+                    int size = 0;
+                    std::memcpy(&size, CMSG_DATA(cmsg), sizeof(size));
+                    segmentSize = static_cast<size_t>(size);
+                }
+            }
+
+            senders[i].resize(header.msg_namelen);
+
+            if (segmentSize == 0 || segmentSize > shard.pacman.packetSize()) {
+                cswarning() << "Too big datagram " << segmentSize << " from " << senders[i] << ", drop";
+                continue;
+            }
+
+            const size_t segments = (length + segmentSize - 1) / segmentSize;
+            shard.pacman.allocBatch(segments);
+            accepted.resize(segments);
+
+            const cs::Byte* data = buffers.data() + i * bufferSize;
+
+            for (size_t j = 0; j < segments; ++j) {
+                auto& task = shard.pacman.batchTask(j);
+                const size_t size = std::min(segmentSize, length - j * segmentSize);
+
+                std::copy(data + j * segmentSize, data + j * segmentSize + size, static_cast<cs::Byte*>(task.pack.data()));
+                task.sender = senders[i];
+
+                accepted[j] = acceptReceived(task, size);
+            }
+
+            count += shard.pacman.enQueueBatch(accepted);
+        }
+
+        if (count) {
+            [[maybe_unused]] auto res = write(shard.eventfd, &count, sizeof(uint64_t));
+        }
+    }
+}
+#endif
+
+void Network::readerRoutine(const Config& config, ReceiveShard& shard) {
+    const bool reusePort = shards_.size() > 1;
+    const bool openOwn = config.hasTwoSockets() || &shard != shards_.front().get();
+    ip::udp::socket* sock = getSocketInThread(openOwn, config.getInputEndpoint(), shard.status, config.useIPv6(), reusePort);
 
     if (!sock) {
         return;
@@ -106,11 +301,32 @@ void Network::readerRoutine(const Config& config) {
         std::this_thread::sleep_for(1s);
     }
 
+#ifdef __linux__
+    if (config.useUdpOffload()) {
+        int enable = 1;
+
+        if (setsockopt(sock->native_handle(), SOL_UDP, UDP_GRO, &enable, sizeof(enable)) == 0) {
+            // every message takes 64 Kb buffer, so batch is smaller than without offload
+            readerGroRoutine(*sock, shard, std::clamp<size_t>(config.getReceiveBatchSize(), 1, 16));
+            cswarning() << "readerRoutine STOPPED!!!\n";
+            return;
+        }
+
+        cswarning() << "UDP_GRO is not supported, errno = " << errno;
+    }
+
+    if (config.getReceiveBatchSize() > 1) {
+        readerBatchRoutine(*sock, shard, std::min(config.getReceiveBatchSize(), Config::MaxReceiveBatchSize));
+        cswarning() << "readerRoutine STOPPED!!!\n";
+        return;
+    }
+#endif
+
     boost::system::error_code lastError;
     size_t packetSize;
 
     while (stopReaderRoutine == false) {  // changed from true
-        auto& task = iPacMan_.allocNext();
+        auto& task = shard.pacman.allocNext();
 
         if (stopReaderRoutine) {
             return;
@@ -123,46 +339,22 @@ void Network::readerRoutine(const Config& config) {
             continue;
         }
 
-        packetSize = sock->receive_from(buffer(task.pack.data(), Packet::MaxSize), task.sender, NO_FLAGS, lastError);
+        packetSize = sock->receive_from(buffer(task.pack.data(), task.pack.size()), task.sender, NO_FLAGS, lastError);
 
         while (!task.pack.region_.get()) {
             cswarning() << "net: invalid input packet";
         }
 
-        if (!(task.pack.isHeaderValid())) {
-            static constexpr size_t limit = 100;
-            auto size = (task.pack.size() <= limit) ? task.pack.size() : limit;
-
-            cswarning() << "from socket Header is not valid: " << cs::Utils::byteStreamToHex(static_cast<const char*>(task.pack.data()), size);
-        }
-
         if (!lastError) {
-            task.size = task.pack.decode(packetSize);  // try to decode first
-
-            bool reject = false;
-            if (task.size == 0) {
-                cswarning() << "Ignore incorrect packet fragment, drop";
-                reject = true;
-            }
-            else if (!task.pack.hasValidFragmentation()) {
-                cswarning() << "Incorrect fragment identity in message or too many fragments, drop (" << task.pack.getFragmentId() << " from " << task.pack.getFragmentsNum()
-                            << "), sender " << task.sender;
-                reject = true;
-            }
-
-            if (reject) {
-                iPacMan_.rejectLast();
+            if (!acceptReceived(task, packetSize)) {
+                shard.pacman.rejectLast();
+                continue;
             }
-            else {
-                iPacMan_.enQueueLast();
 
-#ifdef LOG_NET
-                csdebug(logger::Net) << "<-- " << packetSize << " bytes from " << task.sender << " " << task.pack;
-#endif
-            }
+            shard.pacman.enQueueLast();
 #ifdef __linux__
             static uint64_t one = 1;
-            [[maybe_unused]] auto res = write(readerEventfd_, &one, sizeof(uint64_t));
+            [[maybe_unused]] auto res = write(shard.eventfd, &one, sizeof(uint64_t));
 #endif
 #if defined(WIN32) || defined(__APPLE__)
             while (readerLock.test_and_set(std::memory_order_acquire))  // acquire lock
@@ -178,7 +370,7 @@ void Network::readerRoutine(const Config& config) {
         }
         else {
             cserror() << "Cannot receive packet. Error " << lastError;
-            iPacMan_.rejectLast();
+            shard.pacman.rejectLast();
         }
     }
 
@@ -193,9 +385,8 @@ static inline void sendPack(ip::udp::socket& sock, TaskPtr<OPacMan>& task, const
 
     uint32_t count = 0;
 
-    // net code was built on this constant (Packet::MaxSize)
-    // and is used it implicitly in a lot of places(
-    char packetBuffer[Packet::MaxSize];
+    // enough for any fragment size
+    char packetBuffer[Packet::MaxConfigurableSize];
     boost::asio::mutable_buffer encodedPacket = task->pack.encode(buffer(packetBuffer, sizeof(packetBuffer)));
     encodedSize = encodedPacket.size();
 
@@ -219,7 +410,7 @@ static inline void sendPack(ip::udp::socket& sock, TaskPtr<OPacMan>& task, const
 }
 
 void Network::writerRoutine(const Config& config) {
-    ip::udp::socket* sock = getSocketInThread(config.hasTwoSockets(), config.getOutputEndpoint(), writerStatus_, config.useIPv6());
+    ip::udp::socket* sock = getSocketInThread(config.hasTwoSockets(), config.getOutputEndpoint(), writerStatus_, config.useIPv6(), false);
 
     if (!sock) {
         return;
@@ -227,9 +418,74 @@ void Network::writerRoutine(const Config& config) {
 #ifdef __linux__
     std::vector<struct mmsghdr> msg;
     std::vector<struct iovec> iovecs;
-    std::vector<std::array<char, Packet::MaxSize>> packets_buffer;
-    std::vector<boost::asio::mutable_buffer> encoded_packets;
+    std::vector<std::array<char, Packet::MaxConfigurableSize>> packets_buffer;
     std::vector<ip::udp::endpoint> endpoints;
+    std::vector<std::array<char, CMSG_SPACE(sizeof(uint16_t))>> controls;
+    std::vector<size_t> msgFirst;
+
+    bool useGso = false;
+
+    if (config.useUdpOffload()) {
+        int segmentSize = 0;
+        socklen_t length = sizeof(segmentSize);
+        useGso = getsockopt(sock->native_handle(), SOL_UDP, UDP_SEGMENT, &segmentSize, &length) == 0;
+
+        if (!useGso) {
+            cswarning() << "UDP_SEGMENT is not supported, errno = " << errno;
+        }
+    }
+
+    // fills msg by datagrams starting from iovec first, returns messages count
+    auto buildMessages = [&](size_t first, const size_t count, const bool gso) {
+        static constexpr size_t maxSegments = 64;
+        static constexpr size_t maxBytes = 60000;
+
+        size_t result = 0;
+
+        while (first < count) {
+            size_t last = first + 1;
+
+            // consecutive datagrams of one size to one endpoint are sent as a single buffer segmented by kernel,
+            // only the last segment may be smaller
+            if (gso) {
+                size_t bytes = iovecs[first].iov_len;
+
+                while (last < count && last - first < maxSegments && endpoints[last] == endpoints[first] && iovecs[last].iov_len <= iovecs[first].iov_len &&
+                       bytes + iovecs[last].iov_len <= maxBytes) {
+                    bytes += iovecs[last].iov_len;
+
+                    if (iovecs[last++].iov_len < iovecs[first].iov_len) {
+                        break;
+                    }
+                }
+            }
+
+            msg[result] = mmsghdr{};
+            auto& header = msg[result].msg_hdr;
+            header.msg_iov = &iovecs[first];
+            header.msg_iovlen = last - first;
+            header.msg_name = endpoints[first].data();
+            header.msg_namelen = endpoints[first].size();
+
+            if (last - first > 1) {
+                header.msg_control = controls[result].data();
+                header.msg_controllen = controls[result].size();
+
+                auto cmsg = CMSG_FIRSTHDR(&header);
+                cmsg->cmsg_level = SOL_UDP;
+                cmsg->cmsg_type = UDP_SEGMENT;
+                cmsg->cmsg_len = CMSG_LEN(sizeof(uint16_t));
+
+                const auto segmentSize = static_cast<uint16_t>(iovecs[first].iov_len);
+                std::memcpy(CMSG_DATA(cmsg), &segmentSize, sizeof(segmentSize));
+            }
+
+            msgFirst[result++] = first;
+            first = last;
+        }
+
+        return result;
+    };
 #endif
     while (stopWriterRoutine == false) {  // changed from true
 #ifdef __linux__
@@ -244,14 +500,14 @@ void Network::writerRoutine(const Config& config) {
         }
 
         msg.resize(tasks);
-        std::fill(msg.begin(), msg.end(), mmsghdr{});
         iovecs.resize(tasks);
         std::fill(iovecs.begin(), iovecs.end(), iovec{});
         packets_buffer.resize(tasks);
         endpoints.resize(tasks);
-        encoded_packets.clear();
+        controls.resize(tasks);
+        msgFirst.resize(tasks);
 
-        int j = 0;
+        size_t j = 0;
         for (uint64_t i = 0; i < tasks; i++) {
             auto task = oPacMan_.getNextTask();
             std::atomic_thread_fence(std::memory_order_acquire);
@@ -266,14 +522,10 @@ void Network::writerRoutine(const Config& config) {
                 cswarning() << "socket Header is not valid: " << cs::Utils::byteStreamToHex(static_cast<const char*>(task->pack.data()), size);
             }
 
-            encoded_packets.emplace_back(task->pack.encode(buffer(packets_buffer[j].data(), Packet::MaxSize)));
+            auto encoded = task->pack.encode(buffer(packets_buffer[j].data(), packets_buffer[j].size()));
             endpoints[j] = task->endpoint;
-            iovecs[j].iov_base = encoded_packets[j].data();
-            iovecs[j].iov_len = encoded_packets[j].size();
-            msg[j].msg_hdr.msg_iov = &iovecs[j];
-            msg[j].msg_hdr.msg_iovlen = 1;
-            msg[j].msg_hdr.msg_name = endpoints[j].data();
-            msg[j].msg_hdr.msg_namelen = endpoints[j].size();
+            iovecs[j].iov_base = encoded.data();
+            iovecs[j].iov_len = encoded.size();
             task.release();
             ++j;
         }
@@ -281,20 +533,34 @@ void Network::writerRoutine(const Config& config) {
             continue;
         }
 
-        tasks = j;
+        size_t count = buildMessages(0, j, useGso);
+        size_t sent = 0;
 
-        int sended = 0;
-        struct mmsghdr* messages = msg.data();
-        do {
-            sended = sendmmsg(sock->native_handle(), messages, tasks, 0);
-            if (sended < 0) {
-                cswarning() << "sendmmsg errno = " << errno;
-                if (errno != EAGAIN)
-                    break;
+        while (sent < count) {
+            const int result = sendmmsg(sock->native_handle(), msg.data() + sent, static_cast<unsigned int>(count - sent), 0);
+
+            if (result >= 0) {
+                sent += static_cast<size_t>(result);
+                continue;
             }
-            messages += sended;
-            tasks -= sended;
-        } while (tasks);
+
+            if (errno == EAGAIN || errno == EINTR) {
+                continue;
+            }
+
+            // segmentation offload may be refused by device or for too big segment, datagrams are sent one by one then
+            if (useGso && (errno == EINVAL || errno == EIO) && msg[sent].msg_hdr.msg_iovlen > 1) {
+                cswarning() << "UDP_SEGMENT send failed, errno = " << errno << ", offload is switched off";
+
+                useGso = false;
+                count = buildMessages(msgFirst[sent], j, useGso);
+                sent = 0;
+                continue;
+            }
+
+            cswarning() << "sendmmsg errno = " << errno;
+            break;
+        }
 #endif
 #if defined(WIN32) || defined(__APPLE__)
 #ifdef WIN32
@@ -328,9 +594,13 @@ void Network::writerRoutine(const Config& config) {
 void Network::processorRoutine() {
     CallsQueue& externals = CallsQueue::instance();
 #ifdef __linux__
-    struct pollfd pfd {};
-    pfd.fd = readerEventfd_;
-    pfd.events = POLLIN;
+    std::vector<struct pollfd> pfds(shards_.size());
+
+    for (size_t i = 0; i < shards_.size(); ++i) {
+        pfds[i].fd = shards_[i]->eventfd;
+        pfds[i].events = POLLIN;
+    }
+
     constexpr int timeout = 50;  // 50ms
 #elif __APPLE__
     struct timespec timeout {
@@ -341,44 +611,70 @@ void Network::processorRoutine() {
     while (stopProcessorRoutine == false) {
         externals.callAll();
 #ifdef __linux__
-        uint64_t tasks;
         while (true) {
-            int ret = poll(&pfd, 1, timeout);
-            if (ret != 0) {
+            // queued messages are dispatched between polls, so new packets are read before every budget
+            const bool queued = !lanes_.isEmpty();
+            int ret = poll(pfds.data(), pfds.size(), queued ? 0 : timeout);
+            if (ret > 0) {
                 break;
             }
+            if (queued) {
+                dispatchQueued();
+            }
             externals.callAll();
         }
-        int s = read(readerEventfd_, &tasks, sizeof(uint64_t));
-        if (s != sizeof(uint64_t)) {
-            continue;
-        }
 
-        for (uint64_t i = 0; i < tasks; i++) {
-            auto task = iPacMan_.getNextTask();
-            if (!task->pack.region_.get()) {
-                cswarning() << "net: invalid packet processor!!!!!!!!!";
+        // shards are merged here, so transport is still called by this thread only
+        for (size_t j = 0; j < pfds.size(); ++j) {
+            if (!(pfds[j].revents & POLLIN)) {
                 continue;
             }
-            processTask(task);
-            task.release();
+
+            uint64_t tasks;
+            int s = read(pfds[j].fd, &tasks, sizeof(uint64_t));
+            if (s != sizeof(uint64_t)) {
+                continue;
+            }
+
+            auto& pacman = shards_[j]->pacman;
+
+            for (uint64_t i = 0; i < tasks; i++) {
+                auto task = pacman.getNextTask();
+                if (!task->pack.region_.get()) {
+                    cswarning() << "net: invalid packet processor!!!!!!!!!";
+                    continue;
+                }
+                processTask(task);
+                task.release();
+            }
         }
 #endif
 #if defined(WIN32) || defined(__APPLE__)
 #ifdef WIN32
         while (true) {
-            auto ret = WaitForSingleObject(readerEvent_, 50);  // timeout 50ms
+            const bool queued = !lanes_.isEmpty();
+            auto ret = WaitForSingleObject(readerEvent_, queued ? 0 : 50);  // timeout 50ms
             if (ret != WAIT_TIMEOUT) {
                 break;
             }
+            if (queued) {
+                dispatchQueued();
+            }
             externals.callAll();
         };
 #else
         while (true) {
+            const bool queued = !lanes_.isEmpty();
+            const struct timespec noTimeout {
+                0, 0
+            };
             struct kevent event;
-            int ret = kevent(readerKq_, NULL, 0, &event, 1, &timeout);
+            int ret = kevent(readerKq_, NULL, 0, &event, 1, queued ? &noTimeout : &timeout);
             if (ret)
                 break;
+            if (queued) {
+                dispatchQueued();
+            }
             externals.callAll();
         }
 #endif
@@ -389,15 +685,44 @@ void Network::processorRoutine() {
         readerLock.clear(std::memory_order_release);  // release lock
 
         for (int i = 0; i < tasks; i++) {
-            auto task = iPacMan_.getNextTask();
+            auto task = shards_.front()->pacman.getNextTask();
             processTask(task);
             task.release();
         }
 #endif
+        dispatchQueued();
     }
     cswarning() << "processorRoutine STOPPED!!!\n";
 }
 
+void Network::dispatchQueued() {
+    lanes_.dispatch([this](const DispatchLanes::Item& item) {
+        if (item.message) {
+            transport_->processNodeMessage(**item.message);
+        }
+        else {
+            transport_->processNodeMessage(item.packet);
+        }
+    });
+
+    constexpr std::chrono::minutes logPeriod(1);
+    const auto now = std::chrono::steady_clock::now();
+
+    if (now - lanesLogTime_ < logPeriod) {
+        return;
+    }
+
+    lanesLogTime_ = now;
+
+    for (uint8_t lane = 0; lane < DispatchLanes::LanesCount; ++lane) {
+        const auto id = static_cast<DispatchLanes::Lane>(lane);
+        const auto stats = lanes_.stats(id);
+
+        csdebug(logger::Net) << "Lane " << DispatchLanes::laneName(id) << ": depth " << stats.depth << ", max depth " << stats.maxDepth << ", dispatched " << stats.dispatched
+                             << ", dropped " << stats.dropped << ", bytes " << stats.bytes << ", average wait " << stats.averageWaitMicroseconds() << " us, max wait " << stats.maxWaitMicroseconds << " us";
+    }
+}
+
 inline void Network::processTask(TaskPtr<IPacMan>& task) {
     auto remoteSender = transport_->getPackSenderEntry(task->sender);
 
@@ -425,8 +750,13 @@ inline void Network::processTask(TaskPtr<IPacMan>& task) {
     }
 
     // Non-network data
-    uint32_t& recCounter = packetMap_.tryStore(task->pack.getHash());
-    if (!recCounter && task->pack.addressedToMe(transport_->getMyPublicKey())) {
+    ReceivedPacket& received = packetMap_.tryStore(task->pack.getIdentity());
+
+    if (received.hashed) {
+        task->pack.setHash(received.hash);
+    }
+
+    if (!received.counter && task->pack.addressedToMe(transport_->getMyPublicKey())) {
         if (task->pack.isFragmented() || task->pack.isCompressed()) {
             bool newFragmentedMsg = false;
             MessagePtr msg = collector_.getMessage(task->pack, newFragmentedMsg);
@@ -437,25 +767,34 @@ inline void Network::processTask(TaskPtr<IPacMan>& task) {
             }
 
             if (msg && msg->isComplete()) {
+                // lanes never drop consensus, round table and sync messages, input waits until they are dispatched
                 if (cs::PacketValidator::instance().validate(**msg)) {
-                    transport_->processNodeMessage(**msg);
+                    while (!lanes_.push(msg)) {
+                        dispatchQueued();
+                    }
                 }
             }
         }
         else {
             if (cs::PacketValidator::instance().validate(task->pack)) {
-                transport_->processNodeMessage(task->pack);
+                while (!lanes_.push(task->pack)) {
+                    dispatchQueued();
+                }
             }
         }
     }
 
     transport_->redirectPacket(task->pack, remoteSender);
-    ++recCounter;
+
+    if (!received.hashed && task->pack.isHashed()) {
+        received.hash = task->pack.getHash();
+        received.hashed = true;
+    }
+
+    ++received.counter;
 }
 
 void Network::sendDirect(const Packet& p, const ip::udp::endpoint& ep) {
-    auto qePtr = oPacMan_.allocNext();
-
     if (ep.size() > 16) {
         cswarning() << "endpoint address too big " << ep.size();
         const uint8_t* ptr = reinterpret_cast<const uint8_t*>(ep.data());
@@ -466,10 +805,9 @@ void Network::sendDirect(const Packet& p, const ip::udp::endpoint& ep) {
     while (!p.region_.get()) {
         cswarning() << "net: invalid packet for sendDirect!!!!!!!!! ";
     }
-    qePtr->endpoint = ep;
-    qePtr->pack = p;
-
-    oPacMan_.enQueueLast();
+    if (!oPacMan_.enQueue(p, ep)) {
+        return;
+    }
 #ifdef __linux__
     static uint64_t one = 1;
     [[maybe_unused]] auto res = write(writerEventfd_, &one, sizeof(uint64_t));
@@ -491,12 +829,23 @@ Network::Network(const Config& config, Transport* transport)
 : resolver_(context_)
 , transport_(transport) {
 #ifdef __linux__
-    readerEventfd_ = eventfd(0, 0);
-    if (readerEventfd_ == -1) {
-        good_ = false;
-        return;
+    const size_t shardsCount = std::clamp<size_t>(config.getReceiveShards(), 1, Config::MaxReceiveShards);
+#else
+    const size_t shardsCount = 1;
+#endif
+
+    for (size_t i = 0; i < shardsCount; ++i) {
+        shards_.push_back(std::make_unique<ReceiveShard>(Packet::validSize(config.getPacketSize())));
+#ifdef __linux__
+        shards_.back()->eventfd = eventfd(0, 0);
+        if (shards_.back()->eventfd == -1) {
+            good_ = false;
+            return;
+        }
+#endif
     }
 
+#ifdef __linux__
     writerEventfd_ = eventfd(0, 0);
     if (writerEventfd_ == -1) {
         good_ = false;
@@ -558,7 +907,7 @@ Network::Network(const Config& config, Transport* transport)
     EV_SET(&writerEvent_, 0, EVFILT_USER, EV_DISPATCH | EV_ENABLE, NOTE_FFCOPY | NOTE_TRIGGER, 0, NULL);
 #endif
     if (!config.hasTwoSockets()) {
-        auto sockPtr = new ip::udp::socket(bindSocket(context_, this, config.getInputEndpoint(), config.useIPv6()));
+        auto sockPtr = new ip::udp::socket(bindSocket(context_, this, config.getInputEndpoint(), config.useIPv6(), shardsCount > 1));
 
         if (!sockPtr->is_open()) {
             good_ = false;
@@ -569,16 +918,25 @@ Network::Network(const Config& config, Transport* transport)
         singleSockOpened_.store(true);
     }
 
-    readerThread_ = std::thread(&Network::readerRoutine, this, config);
+    for (auto& shard : shards_) {
+        shard->thread = std::thread(&Network::readerRoutine, this, config, std::ref(*shard));
+    }
+
     writerThread_ = std::thread(&Network::writerRoutine, this, config);
     processorThread_ = std::thread(&Network::processorRoutine, this);
 
-    while (readerStatus_.load() == ThreadStatus::NonInit)
-        ;
+    good_ = true;
+
+    for (auto& shard : shards_) {
+        while (shard->status.load() == ThreadStatus::NonInit)
+            ;
+        good_ = good_ && shard->status.load() == ThreadStatus::Success;
+    }
+
     while (writerStatus_.load() == ThreadStatus::NonInit)
         ;
 
-    good_ = (readerStatus_.load() == ThreadStatus::Success && writerStatus_.load() == ThreadStatus::Success);
+    good_ = good_ && writerStatus_.load() == ThreadStatus::Success;
 
     if (!good_) {
         cserror() << "Cannot start the network: error binding sockets";
@@ -599,7 +957,7 @@ bool Network::resendFragment(const cs::Hash& hash, const uint16_t id, const ip::
 
     {
         cs::Lock l(msg->pLock_);
-        if (id < msg->packetsTotal_ && *(msg->packets_ + id)) {
+        if (msg->hasFragment(id)) {
             sendDirect(*(msg->packets_ + id), ep);
             return true;
         }
@@ -626,13 +984,13 @@ void Network::registerMessage(Packet* pack, const uint32_t size) {
     }
 
     msg->packetsLeft_ = 0;
-    msg->packetsTotal_ = size;
     msg->headerHash_ = pack->getHeaderHash();
+    msg->allocateFragments(size);
 
-    auto packEnd = msg->packets_ + size;
-    auto rPtr = pack;
-    for (auto wPtr = msg->packets_; wPtr != packEnd; ++wPtr, ++rPtr) {
-        *wPtr = *rPtr;
+    // own fragments are kept for resend only, so they are not assembled
+    for (uint32_t i = 0; i < size; ++i) {
+        msg->packets_[i] = pack[i];
+        msg->received_.set(i);
     }
 
     {
@@ -644,8 +1002,10 @@ void Network::registerMessage(Packet* pack, const uint32_t size) {
 Network::~Network() {
     stopReaderRoutine = true;
 
-    if (readerThread_.joinable()) {
-        readerThread_.join();
+    for (auto& shard : shards_) {
+        if (shard->thread.joinable()) {
+            shard->thread.join();
+        }
     }
 
     stopWriterRoutine = true;
@@ -163,12 +163,11 @@ MessagePtr PacketCollector::getMessage(const Packet& pack, bool& newFragmentedMs
     }
 
     if (!*msgPtr) {  // First time
-        *msgPtr = msg = msgAllocator_.emplace();
+        msg = msgAllocator_.emplace();
         msg->packetsLeft_ = pack.getFragmentsNum();
-        msg->packetsTotal_ = pack.getFragmentsNum();
         msg->headerHash_ = pack.getHeaderHash();
-        // to ensure not to contain dirty fragments in buffer (prevent goodPlace below from to be incorrect):
-        msg->clearFragments();
+        msg->allocateFragments(pack.getFragmentsNum());
+        *msgPtr = msg;
         newFragmentedMsg = true;
     }
     else {
@@ -177,13 +176,7 @@ MessagePtr PacketCollector::getMessage(const Packet& pack, bool& newFragmentedMs
 
     {
         cs::Lock lock(msg->pLock_);
-        auto goodPlace = msg->packets_ + pack.getFragmentId(); // valid fragmentation has already been tested
-
-        if (!*goodPlace) {
-            msg->maxFragment_ = std::max(pack.getFragmentsNum(), msg->maxFragment_);
-            --msg->packetsLeft_;
-            *goodPlace = pack;
-        }
+        msg->storeFragment(pack);
 
         if (msg->packetsTotal_ >= 20) {
             if (msg->packetsLeft_ != 0) {
@@ -203,11 +196,100 @@ MessagePtr PacketCollector::getMessage(const Packet& pack, bool& newFragmentedMs
     return msg;
 }
 
+void Message::allocateFragments(const uint32_t count) {
+    assert(packets_ == nullptr);
+
+    fragmentsRegion_ = allocator_.allocateNext(static_cast<uint32_t>(sizeof(Packet) * count));
+    packets_ = static_cast<Packet*>(fragmentsRegion_->data());
+    std::uninitialized_default_construct_n(packets_, count);
+
+    packetsTotal_ = count;
+    received_.reset();
+}
+
+bool Message::storeFragment(const Packet& pack) {
+    const uint32_t id = pack.getFragmentId();
+
+    if (id >= packetsTotal_ || received_.test(id)) {
+        return false;
+    }
+
+    packets_[id] = pack;
+    received_.set(id);
+    --packetsLeft_;
+
+    assembleFragment(id);
+    return true;
+}
+
+void Message::assembleFragment(const uint32_t id) {
+    if (irregular_) {
+        return;
+    }
+
+    const uint32_t lastId = packetsTotal_ - 1;
+
+    auto place = [this, lastId](const uint32_t fragmentId) {
+        const Packet& pack = packets_[fragmentId];
+        const uint32_t headersLength = pack.getHeadersLength();
+        const uint32_t payload = static_cast<uint32_t>(pack.size()) - headersLength;
+        // headers length the assembly buffer was sized for
+        const uint32_t assembledHeaders = assembly_->size() - fragmentPayload_ * packetsTotal_;
+
+        if (headersLength != assembledHeaders || payload > fragmentPayload_ || (fragmentId != lastId && payload != fragmentPayload_)) {
+            irregular_ = true;
+            assembly_.reset();
+            return;
+        }
+
+        auto source = static_cast<const cs::Byte*>(pack.data());
+        auto data = static_cast<cs::Byte*>(assembly_->data());
+
+        if (fragmentId == 0) {
+            std::copy(source, source + headersLength + payload, data);
+        }
+        else {
+            std::copy(source + headersLength, source + headersLength + payload, data + headersLength + fragmentId * fragmentPayload_);
+        }
+    };
+
+    if (!assembly_) {
+        // payload size of the others is unknown by the last fragment
+        if (id == lastId) {
+            return;
+        }
+
+        const uint32_t headersLength = packets_[id].getHeadersLength();
+        fragmentPayload_ = static_cast<uint32_t>(packets_[id].size()) - headersLength;
+        assembly_ = allocator_.allocateNext(headersLength + fragmentPayload_ * packetsTotal_);
+
+        if (received_.test(lastId)) {
+            place(lastId);
+        }
+
+        if (!assembly_) {
+            return;
+        }
+    }
+
+    place(id);
+}
+
 /* WARN: All the cases except FRAG + COMPRESSED have bugs in them */
 void Message::composeFullData() const {
     if (getFirstPack().isFragmented()) {
         const Packet* pack = packets_;
         uint32_t headersLength = pack->getHeadersLength();
+
+        if (assembly_ && packetsLeft_ == 0) {
+            const Packet& last = packets_[packetsTotal_ - 1];
+            const uint32_t lastPayload = static_cast<uint32_t>(last.size()) - headersLength;
+
+            fullData_ = std::move(assembly_);
+            fullData_->setSize(headersLength + fragmentPayload_ * (packetsTotal_ - 1) + lastPayload);
+            return;
+        }
+
         uint32_t totalSize = headersLength;
 
         for (uint32_t i = 0; i < packetsTotal_; ++i, ++pack) {
@@ -231,32 +313,9 @@ void Message::composeFullData() const {
     }
 }
 
-// scans array of future fragments and clears all dirty elements, scans all elements
-size_t Message::clearBuffer(size_t from, size_t to) {
-    if (to <= from || to >= Packet::MaxFragments) {
-        return 0;
-    }
-    size_t cnt = 0;
-    for (size_t i = from; i < to; i++) {
-        // Packet's operator bool redirects call to Packet::data_::operator bool
-        if (packets_[i]) {
-            csdebug() << "Net: potential heap corruption prevented in message.packets_[" << i << "]";
-            packets_[i] = Packet{};
-            ++cnt;
-        }
-    }
-    return cnt;
-}
-
 Message::~Message() {
-    //DEBUG: prevent corruption after heap is damaged,
-    // assume maxFragment "points" behind the last fragment,
-    // idea is to avoid call to MemPtr<> destructor on incorrect object
-    size_t count = clearUnused();
-
-    if (count > 0) {
-        csdebug() << "Net: memory corruption prevented, invalid fragments (" << count << ") is behind the max of " << maxFragment_ << " and cannot been destructed";
-        Transport::cntCorruptedFragments += count;
+    if (packets_) {
+        std::destroy_n(packets_, packetsTotal_);
     }
 }
 
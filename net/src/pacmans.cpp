@@ -1,69 +1,137 @@
 /* Send blaming letters to @yrtimd */
 #include "pacmans.hpp"
+#include "dispatchlanes.hpp"
+
+namespace {
+// the type of compressed data is not known, so such packets are kept as fragments are
+bool isDroppable(const Packet& pack) {
+    if (pack.isFragmented() || pack.isCompressed()) {
+        return false;
+    }
+
+    return pack.isNetwork() || DispatchLanes::isDroppable(DispatchLanes::laneOf(pack.getType()));
+}
+}  // namespace
+
+void IPacMan::prepare(Task& task) {
+    // region is kept by the slot only if processed packet was not shared
+    if (task.pack.region_.get()) {
+        task.pack.region_->setSize(packetSize_);
+        task.pack = Packet(std::move(task.pack.region_));
+    }
+    else {
+        task.pack = Packet(allocator_.allocateNext(packetSize_));
+    }
+}
 
 IPacMan::Task& IPacMan::allocNext() {
-    std::lock_guard<std::mutex> lock(mutex_);
-    queue_.emplace_back();
-    auto end = queue_.end();
-    Task& task = *(--end);
-    task.pack.region_ = allocator_.allocateNext(Packet::MaxSize);
-    return task;
+    allocBatch(1);
+    return pending_.front()->element;
 }
 
 void IPacMan::enQueueLast() {
-    Task& task = queue_.back();
+    Task& task = pending_.front()->element;
     task.pack.setSize(static_cast<uint32_t>(task.size));
 
-    size_.fetch_add(1, std::memory_order_acq_rel);
+    queue_.unlockWrite(pending_.front());
+    pending_.erase(pending_.begin());
+}
+
+void IPacMan::allocBatch(size_t count) {
+    while (pending_.size() < count) {
+        pending_.push_back(queue_.lockWrite());
+    }
+
+    for (size_t i = 0; i < count; ++i) {
+        prepare(pending_[i]->element);
+    }
+}
+
+IPacMan::Task& IPacMan::batchTask(size_t index) {
+    return pending_[index]->element;
+}
+
+size_t IPacMan::enQueueBatch(const std::vector<bool>& accepted) {
+    size_t count = 0;
+
+    // slots are published in queue order, so accepted tasks are moved to the first slots
+    for (size_t i = 0; i < accepted.size(); ++i) {
+        if (!accepted[i]) {
+            continue;
+        }
+
+        if (i != count) {
+            Task& from = pending_[i]->element;
+            Task& to = pending_[count]->element;
+
+            std::swap(from.sender, to.sender);
+            std::swap(from.size, to.size);
+            std::swap(from.pack, to.pack);
+        }
+
+        ++count;
+    }
+
+    for (size_t i = 0; i < count; ++i) {
+        Task& task = pending_[i]->element;
+        task.pack.setSize(static_cast<uint32_t>(task.size));
+
+        queue_.unlockWrite(pending_[i]);
+    }
+
+    pending_.erase(pending_.begin(), pending_.begin() + static_cast<std::ptrdiff_t>(count));
+    return count;
 }
 
 void IPacMan::rejectLast() {
-    std::lock_guard<std::mutex> lock(mutex_);
-    queue_.pop_back();
+    // slot stays locked for writing and is reused by the next allocNext
 }
 
 TaskPtr<IPacMan> IPacMan::getNextTask() {
-    while (!size_.load(std::memory_order_acquire)) {
-        std::this_thread::yield();
-    }
-    std::lock_guard<std::mutex> lock(mutex_);
     TaskPtr<IPacMan> result;
     result.owner_ = this;
-    result.it_ = queue_.begin();
+    result.it_ = queue_.lockRead();
     return result;
 }
 
 void IPacMan::releaseTask(TaskIterator& it) {
-    std::lock_guard<std::mutex> lock(mutex_);
-    queue_.erase(it);
-    size_.fetch_sub(1, std::memory_order_acq_rel);
-}
+    Packet& pack = it->element.pack;
+
+    if (pack.region_.use_count() > 1) {
+        pack.region_.reset();
+    }
 
-OPacMan::Task* OPacMan::allocNext() {
-    std::lock_guard<std::mutex> lock(mutex_);
-    queue_.emplace_back();
-    auto end = queue_.end();
-    Task& task = *(--end);
-    return &task;
+    queue_.unlockRead(it);
 }
 
-void OPacMan::enQueueLast() {
-    size_.fetch_add(1, std::memory_order_acq_rel);
+bool OPacMan::enQueue(const Packet& pack, const ip::udp::endpoint& endpoint) {
+    auto element = isDroppable(pack) ? queue_.tryLockWrite() : queue_.lockWrite();
+
+    // transactions may be lost by network as well, so they are dropped instead of stalling the sender
+    if (!element) {
+        const auto dropped = dropped_.fetch_add(1, std::memory_order_relaxed) + 1;
+
+        if ((dropped & (dropped - 1)) == 0) {
+            cswarning() << "net: output queue is full, dropped packets: " << dropped;
+        }
+
+        return false;
+    }
+    element->element.endpoint = endpoint;
+    element->element.pack = pack;
+    queue_.unlockWrite(element);
+    return true;
 }
 
 TaskPtr<OPacMan> OPacMan::getNextTask() {
-    while (!size_.load(std::memory_order_acquire)) {
-        std::this_thread::yield();
-    }
-    std::lock_guard<std::mutex> lock(mutex_);
     TaskPtr<OPacMan> result;
     result.owner_ = this;
-    result.it_ = queue_.begin();
+    result.it_ = queue_.lockRead();
     return result;
 }
 
 void OPacMan::releaseTask(TaskIterator& it) {
-    std::lock_guard<std::mutex> lock(mutex_);
-    queue_.erase(it);
-    size_.fetch_sub(1, std::memory_order_acq_rel);
+    // packet region belongs to the sender, do not keep it alive
+    it->element.pack = Packet();
+    queue_.unlockRead(it);
 }
@@ -34,9 +34,23 @@ extern void pollSignalFlag();
 enum RegFlags : uint8_t {
     UsingIPv6 = 1,
     RedirectIP = 1 << 1,
-    RedirectPort = 1 << 2
+    RedirectPort = 1 << 2,
+    // fragment size in units of Packet::MaxSize minus one, old nodes ignore these bits
+    PacketSizeMask = 0x7 << 3
 };
 
+constexpr uint8_t kPacketSizeShift = 3;
+
+static_assert(Packet::MaxConfigurableSize / Packet::MaxSize - 1 <= (RegFlags::PacketSizeMask >> kPacketSizeShift), "fragment size doesn't fit registration flags");
+
+uint8_t packetSizeToFlags(const uint32_t packetSize) {
+    return static_cast<uint8_t>(((Packet::validSize(packetSize) / Packet::MaxSize - 1) << kPacketSizeShift) & RegFlags::PacketSizeMask);
+}
+
+uint32_t packetSizeFromFlags(const uint8_t flags) {
+    return (static_cast<uint32_t>((flags & RegFlags::PacketSizeMask) >> kPacketSizeShift) + 1) * Packet::MaxSize;
+}
+
 enum Platform : uint8_t {
     Linux,
     MacOS,
@@ -89,7 +103,8 @@ void formRegPack(const Config& config, cs::OPackStream& stream, uint64_t** regPa
     stream.init(BaseFlags::NetworkMsg);
     stream << NetworkCommand::Registration << NODE_VERSION << uuid;
 
-    addMyOut(config, stream);
+    // registration layout is unchanged for old nodes, fragment size is put to the flags they don't check
+    addMyOut(config, stream, packetSizeToFlags(config.getPacketSize()));
     *regPackConnId = reinterpret_cast<uint64_t*>(stream.getCurrentPtr());
 
     stream << static_cast<ConnectionId>(0) << pk;
@@ -221,28 +236,17 @@ const char* Transport::networkCommandToString(NetworkCommand command) {
 }
 
 template <>
-uint16_t getHashIndex(const ip::udp::endpoint& ep) {
-    uint16_t result = ep.port();
+uint64_t getHashIndex(const ip::udp::endpoint& ep) {
+    uint64_t result = ep.port();
 
     if (ep.protocol() == ip::udp::v4()) {
-        uint32_t address = ep.address().to_v4().to_uint();
-        uint16_t lowBits = static_cast<uint16_t>(address);
-        uint16_t highBits = address >> (sizeof(uint16_t) * CHAR_BIT);
-        result ^= lowBits ^ highBits;
+        result |= static_cast<uint64_t>(ep.address().to_v4().to_uint()) << 16;
     }
     else {
         auto bytes = ep.address().to_v6().to_bytes();
-        auto ptr = reinterpret_cast<uint8_t*>(&result);
-        auto bytesPtr = bytes.data();
-        for (size_t i = 0; i < 8; ++i) {
-            *ptr ^= *(bytesPtr++);
-        }
-
-        ++ptr;
-
-        for (size_t i = 8; i < 16; ++i) {
-            *ptr ^= *(bytesPtr++);
-        }
+        uint64_t words[2];
+        std::memcpy(words, bytes.data(), sizeof(words));
+        result ^= words[0] ^ words[1];
     }
 
     return result;
@@ -769,6 +773,11 @@ void Transport::sendRegistrationConfirmation(const Connection& conn, const Conne
     oPackStream_.init(BaseFlags::NetworkMsg);
     oPackStream_ << NetworkCommand::RegistrationConfirmed << requestedId << conn.id << myPublicKey_;
 
+    // only a node announced non default fragment size knows the field, old nodes reject extra data
+    if (conn.packetSize != Packet::MaxSize && getPacketSize() != Packet::MaxSize) {
+        oPackStream_ << getPacketSize();
+    }
+
     sendDirect(oPackStream_.getPackets(), conn);
     oPackStream_.clear();
 }
@@ -799,6 +808,7 @@ bool Transport::gotRegistrationRequest(const TaskPtr<IPacMan>& task, RemoteNodeP
     Connection conn;
     conn.in = task->sender;
     auto& flags = iPackStream_.peek<uint8_t>();
+    conn.packetSize = packetSizeFromFlags(flags);
 
     if (flags & RegFlags::RedirectIP) {
         boost::asio::ip::address addr;
@@ -865,7 +875,14 @@ bool Transport::gotRegistrationConfirmation(const TaskPtr<IPacMan>& task, Remote
         return false;
     }
 
-    nh_.gotConfirmation(myCId, realCId, task->sender, key, sender);
+    uint32_t packetSize = Packet::MaxSize;
+
+    if (!iPackStream_.end()) {
+        iPackStream_ >> packetSize;
+        packetSize = iPackStream_.good() ? Packet::validSize(packetSize) : Packet::MaxSize;
+    }
+
+    nh_.gotConfirmation(myCId, realCId, task->sender, key, packetSize, sender);
     return true;
 }
 
@@ -1115,28 +1132,21 @@ void Transport::askForMissingPackages() {
 
         {
             cs::Lock messageLock(msg->pLock_);
-            const auto end = msg->packets_ + msg->packetsTotal_;
-
             uint16_t start = 0;
             uint64_t mask = 0;
             uint64_t req = 0;
 
-            for (auto s = msg->packets_; s != end; ++s) {
-                if (!*s) {
+            for (uint32_t id = 0; id < msg->packetsTotal_; ++id) {
+                if (!msg->received_.test(id)) {
                     if (!mask) {
                         mask = 1;
-                        start = cs::numeric_cast<uint16_t>(s - msg->packets_);
+                        start = cs::numeric_cast<uint16_t>(id);
                     }
                     req |= mask;
                 }
 
                 if (mask == maxMask) {
                     requestMissing(msg->headerHash_, start, req);
-
-                    if (s > (msg->packets_ + msg->maxFragment_) && (end - s) > 128) {
-                        break;
-                    }
-
                     mask = 0;
                 }
                 else {
@@ -1171,14 +1181,7 @@ void Transport::requestMissing(const cs::Hash& hash, const uint16_t start, const
 
 void Transport::registerMessage(MessagePtr msg) {
     cs::Lock lock(uLock_);
-    auto& ptr = uncollected_.emplace(msg);
-    //DEBUG:
-    Message& message = *ptr.get();
-    size_t cnt = message.clearUnused();
-    if (cnt > 0) {
-        csdebug() << "Net: potential heap corruption detected in uncollected message fragments (" << cnt << ")";
-        Transport::cntDirtyAllocs += cnt;
-    }
+    uncollected_.emplace(msg);
 }
 
 bool Transport::gotPackRequest(const TaskPtr<IPacMan>&, RemoteNodePtr& sender) {
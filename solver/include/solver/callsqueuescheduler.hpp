@@ -1,13 +1,13 @@
 #pragma once
 
-#include <atomic>
 #include <chrono>
-#include <condition_variable>
 #include <cstdint>
 #include <functional>
 #include <map>
-#include <set>
-#include <thread>
+#include <mutex>
+#include <vector>
+
+#include <lib/system/timerservice.hpp>
 
 // template<typename TResol = std::chrono::milliseconds>
 class CallsQueueScheduler {
@@ -37,8 +37,10 @@ public:
      * @date    17.09.2018
      */
 
-    CallsQueueScheduler()
-    : _queue(compare) {
+    CallsQueueScheduler() = default;
+
+    ~CallsQueueScheduler() {
+        Clear();
     }
 
     CallsQueueScheduler(const CallsQueueScheduler&) = delete;
@@ -47,8 +49,7 @@ public:
     /**
      * @fn  void CallsQueueScheduler::Run();
      *
-     * @brief   Runs scheduler in separate thread, is optional for call. Would be automatically called by the first
-     * Insert() operation
+     * @brief   Does nothing, calls are driven by cs::TimerService thread. Is kept for compatibility
      *
      * @author  aae
      * @date    17.09.2018
@@ -59,7 +60,7 @@ public:
     /**
      * @fn  void CallsQueueScheduler::Stop();
      *
-     * @brief   Stops this object by clearing the queue and waits for worker thread to stop
+     * @brief   Stops this object by clearing the queue
      *
      * @author  aae
      * @date    17.09.2018
@@ -220,55 +221,18 @@ public:
     }
 
 private:
-    /**
-     * @struct  Context
-     *
-     * @brief   Stores all info to call, re-schedule and cancel further calls in queue.
-     *
-     * @author  aae
-     * @date    17.09.2018
-     */
-
-    struct Context {
-        /** @brief   The identifier: lets find item in queue (e.g. for remove) */
-        CallTag id;
-
-        /** @brief   The time point for scheduled execution */
-        ClockType::time_point tp;
-
-        /** @brief   The delta - time period for periodic calls */
-        long long dt;
-
-        /** @brief   The procedure to call*/
-        ProcType proc;
-
-        // support for std::find() by id
-        bool operator==(const CallTag rhs) const {
-            return id == rhs;
-        }
+    // timer of scheduled call, seq distinguishes calls replaced with the same tag
+    struct Scheduled {
+        cs::TimerService::Id timer;
+        uint64_t seq;
     };
 
-    // used for sort items in _queue by time to call
-    std::function<bool(const Context& lhs, const Context& rhs)> compare = [](const Context& lhs, const Context& rhs) { return lhs.tp < rhs.tp; };
-
-    // container requirements: auto sort by tp, search by id
-    std::multiset<Context, decltype(compare)> _queue;
+    // scheduled calls by tag
+    std::map<CallTag, Scheduled> _queue;
     // sync access to _queue
     std::mutex _mtx_queue;
 
-    // process _queue and puts on time calls into CallsQueue::instance() object
-    std::thread _worker;
-
-    // signals to _worker thread that _queue was updated
-    std::condition_variable _signal;
-    // need by _signal
-    std::mutex _mtx_signal;
-
-    // avoids "false" signals
-    bool _flag = {false};
-
-    // flag to stop _worker thread
-    std::atomic_bool _stop = {false};
+    uint64_t _seq{0};
 
     // statistics
     uint32_t _cnt_total{0};
@@ -284,8 +248,11 @@ private:
 
     std::map<CallTag, ExeSync> _exe_sync;
 
-    // thread procedure
-    void SchedulerProc();
+    // called by timer service thread, puts call into CallsQueue::instance() object
+    void OnTimer(CallTag id, uint64_t seq, bool periodic, const ProcType& proc);
+
+    // cancels timers out of _mtx_queue lock, as cancel waits for running OnTimer()
+    static void CancelTimers(const std::vector<cs::TimerService::Id>& timers);
 
     // methods below are NOT thread-safe, they must be synced at point of call!
 
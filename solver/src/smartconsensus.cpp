@@ -427,7 +427,7 @@ void SmartConsensus::processStages() {
     startTimer(3);
     createFinalTransactionSet(finalFees);
     st3.packageSignature =
-        cscrypto::generateSignature(pnode_->getSolver()->getPrivateKey(), finalSmartTransactionPack_.hash().toBinary().data(), finalSmartTransactionPack_.hash().toBinary().size());
+        cscrypto::generateSignature(pnode_->getSolver()->getPrivateKey(), finalSmartTransactionPack_.hash().data(), finalSmartTransactionPack_.hash().size());
     csmeta(cslog) << "done";
     st3.id = id();
     st3.sender = ownSmartsConfNum_;
@@ -105,12 +105,15 @@ Result TrustedStage1State::onSyncTransactions(SolverContext& context, cs::RoundN
 
             if (std::find(hashes.cbegin(), hashes.cend(), element.first) == hashes.cend()) {
                 stage.hashesCandidates.push_back(element.first);
-
-                if (stage.hashesCandidates.size() > Consensus::MaxStageOneHashes) {
-                    break;
-                }
             }
         }
+
+        // hash table is not ordered, so candidates are sorted to take the same ones on every node
+        std::sort(stage.hashesCandidates.begin(), stage.hashesCandidates.end());
+
+        if (stage.hashesCandidates.size() > Consensus::MaxStageOneHashes + 1) {
+            stage.hashesCandidates.resize(Consensus::MaxStageOneHashes + 1);
+        }
     }
 
     transactions_checked = true;
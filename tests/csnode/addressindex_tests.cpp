@@ -0,0 +1,167 @@
+#include <gtest/gtest.h>
+
+#include <map>
+
+#include <csdb/address.hpp>
+#include <csdb/database.hpp>
+#include <csdb/storage.hpp>
+
+#ifdef TRANSACTIONS_INDEX
+namespace {
+// in-memory database with the address index only
+class AddressIndexDatabase : public csdb::Database {
+public:
+    bool is_open() const override {
+        return true;
+    }
+
+    bool put(const cs::Bytes&, uint32_t, const cs::Bytes&) override {
+        return false;
+    }
+
+    bool get(const cs::Bytes&, cs::Bytes*) override {
+        return false;
+    }
+
+    bool get(const uint32_t, cs::Bytes*) override {
+        return false;
+    }
+
+    bool remove(const cs::Bytes&) override {
+        return false;
+    }
+
+    bool write_batch(const ItemList&) override {
+        return false;
+    }
+
+    bool write_batch(const SeqItemList&) override {
+        return false;
+    }
+
+    bool putToTransIndex(const cs::Bytes&, const cs::Bytes&) override {
+        return false;
+    }
+
+    bool getFromTransIndex(const cs::Bytes&, cs::Bytes*) override {
+        return false;
+    }
+
+    bool putToAddressIndex(const cs::Bytes& key, const cs::Bytes& value) override {
+        index[key] = value;
+        return true;
+    }
+
+    bool getFromAddressIndex(const cs::Bytes& key, cs::Bytes* value) override {
+        const auto it = index.find(key);
+
+        if (it == index.end()) {
+            return false;
+        }
+
+        *value = it->second;
+        return true;
+    }
+
+    bool removeFromAddressIndex(const cs::Bytes& key) override {
+        index.erase(key);
+        return true;
+    }
+
+    IteratorPtr new_iterator() override {
+        return std::make_shared<EmptyIterator>();
+    }
+
+    std::map<cs::Bytes, cs::Bytes> index;
+
+private:
+    class EmptyIterator : public Iterator {
+    public:
+        bool is_valid() const override {
+            return false;
+        }
+
+        void seek_to_first() override {
+        }
+
+        void seek_to_last() override {
+        }
+
+        void seek(const cs::Bytes&) override {
+        }
+
+        void next() override {
+        }
+
+        void prev() override {
+        }
+
+        cs::Bytes key() const override {
+            return {};
+        }
+
+        cs::Bytes value() const override {
+            return {};
+        }
+    };
+};
+
+csdb::Storage openStorage(std::shared_ptr<AddressIndexDatabase> db) {
+    csdb::Storage storage;
+    storage.open(csdb::Storage::OpenOptions{db});
+    return storage;
+}
+}  // namespace
+
+TEST(AddressIndex, PagesFromNewest) {
+    auto db = std::make_shared<AddressIndexDatabase>();
+    auto storage = openStorage(db);
+
+    const auto address = csdb::Address::from_wallet_id(1);
+    const auto other = csdb::Address::from_wallet_id(2);
+
+    cs::Sequence sequence = 0;
+    ASSERT_FALSE(storage.get_address_index_sequence(sequence));
+
+    ASSERT_TRUE(storage.add_address_transactions(address, 1, {0, 3}));
+    ASSERT_TRUE(storage.add_address_transactions(other, 1, {1}));
+    ASSERT_TRUE(storage.add_address_transactions(address, 2, {5}));
+    ASSERT_TRUE(storage.set_address_index_sequence(2));
+
+    ASSERT_TRUE(storage.get_address_index_sequence(sequence));
+    ASSERT_EQ(sequence, 2u);
+
+    ASSERT_EQ(storage.address_transactions_count(address), 3u);
+    ASSERT_EQ(storage.address_transactions_count(other), 1u);
+
+    using Positions = std::vector<csdb::Storage::TransactionPosition>;
+    ASSERT_EQ(storage.address_transactions(address, 0, 10), (Positions{{2, 5}, {1, 3}, {1, 0}}));
+    ASSERT_EQ(storage.address_transactions(address, 1, 1), (Positions{{1, 3}}));
+    ASSERT_TRUE(storage.address_transactions(address, 3, 10).empty());
+
+    // postings of block 2 are skipped before offset and limit are applied
+    ASSERT_EQ(storage.address_transactions(address, 0, 1, 2), (Positions{{1, 3}}));
+    ASSERT_EQ(storage.address_transactions(address, 1, 10, 2), (Positions{{1, 0}}));
+    ASSERT_TRUE(storage.address_transactions(address, 0, 10, 1).empty());
+}
+
+TEST(AddressIndex, ReplacesAndRemovesLastBlocks) {
+    auto db = std::make_shared<AddressIndexDatabase>();
+    auto storage = openStorage(db);
+
+    const auto address = csdb::Address::from_wallet_id(1);
+
+    ASSERT_TRUE(storage.add_address_transactions(address, 1, {0}));
+    ASSERT_TRUE(storage.add_address_transactions(address, 2, {1, 2}));
+
+    // the same block is indexed again after restart
+    ASSERT_TRUE(storage.add_address_transactions(address, 2, {4}));
+    ASSERT_EQ(storage.address_transactions_count(address), 2u);
+
+    ASSERT_TRUE(storage.remove_address_transactions(address, 2));
+    ASSERT_EQ(storage.address_transactions(address, 0, 10), (std::vector<csdb::Storage::TransactionPosition>{{1, 0}}));
+
+    // count and one position are left
+    ASSERT_EQ(db->index.size(), 2u);
+}
+#endif
@@ -0,0 +1,81 @@
+#include <gtest/gtest.h>
+
+#include <vector>
+
+#include <csnode/blockhashes.hpp>
+
+#include <csdb/pool.hpp>
+
+static std::vector<csdb::Pool> makeChain(cs::Sequence count) {
+    std::vector<csdb::Pool> chain;
+    csdb::PoolHash previous;
+
+    for (cs::Sequence seq = 0; seq < count; ++seq) {
+        csdb::Pool pool(previous, seq);
+        pool.compose();
+
+        previous = pool.hash();
+        chain.push_back(pool);
+    }
+
+    return chain;
+}
+
+TEST(BlockHashes, findBySequenceAndHash) {
+    const auto chain = makeChain(1000);
+
+    cs::BlockHashes hashes;
+
+    for (const auto& pool : chain) {
+        ASSERT_TRUE(hashes.loadNextBlock(pool));
+    }
+
+    for (const auto& pool : chain) {
+        ASSERT_EQ(hashes.find(pool.sequence()), pool.hash());
+        ASSERT_EQ(hashes.find(pool.hash()), pool.sequence());
+    }
+
+    ASSERT_EQ(hashes.find(csdb::PoolHash{}), 0);
+}
+
+TEST(BlockHashes, initFromPrevBlockBuildsIndex) {
+    const auto chain = makeChain(100);
+
+    cs::BlockHashes hashes;
+    hashes.initStart();
+
+    for (const auto& pool : chain) {
+        ASSERT_TRUE(hashes.initFromPrevBlock(pool));
+    }
+
+    for (const auto& pool : chain) {
+        ASSERT_EQ(hashes.find(pool.hash()), pool.sequence());
+    }
+}
+
+TEST(BlockHashes, removeLastKeepsIndexConsistent) {
+    const auto chain = makeChain(300);
+
+    cs::BlockHashes hashes;
+
+    for (const auto& pool : chain) {
+        ASSERT_TRUE(hashes.loadNextBlock(pool));
+    }
+
+    for (size_t i = 0; i < 100; ++i) {
+        const auto& pool = chain[chain.size() - 1 - i];
+
+        ASSERT_EQ(hashes.removeLast(), pool.hash());
+        ASSERT_EQ(hashes.find(pool.hash()), 0);
+    }
+
+    for (size_t i = 0; i < chain.size() - 100; ++i) {
+        ASSERT_EQ(hashes.find(chain[i].hash()), chain[i].sequence());
+    }
+
+    // chain can grow again after rollback
+    for (size_t i = chain.size() - 100; i < chain.size(); ++i) {
+        ASSERT_TRUE(hashes.loadNextBlock(chain[i]));
+        ASSERT_EQ(hashes.find(chain[i].hash()), chain[i].sequence());
+    }
+}
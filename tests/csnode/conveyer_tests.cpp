@@ -159,9 +159,13 @@ TEST(Conveyer, AddTransaction) {
     conveyer.addTransaction(transaction);
     auto& transactions_block = conveyer.packetQueue();
     ASSERT_EQ(1, conveyer.packetQueue().size());
-    auto packet{cs::TransactionsPacket{}};
-    packet.addTransaction(transaction);
-    ASSERT_EQ(packet.toBinary(), transactions_block.back().toBinary());
+    std::vector<csdb::Transaction> transactions;
+    transactions_block.forEachTransaction([&](const csdb::Transaction& queued) {
+        transactions.push_back(queued);
+        return true;
+    });
+    ASSERT_EQ(1, transactions.size());
+    ASSERT_EQ(transaction, transactions.front());
 }
 
 TEST(Conveyer, TransactionPacketTableIsEmptyAtCreation) {
@@ -187,9 +191,14 @@ TEST(Conveyer, CanAddTransactionToLastBlock) {
     conveyer.addTransaction(transaction1);
     conveyer.addTransaction(transaction2);
     ASSERT_EQ(1, table.size());
-    ASSERT_EQ(2, table.back().transactionsCount());
-    ASSERT_EQ(transaction1, table.back().transactions().at(0));
-    ASSERT_EQ(transaction2, table.back().transactions().at(1));
+    ASSERT_EQ(2, table.transactionsCount());
+    std::vector<csdb::Transaction> transactions;
+    table.forEachTransaction([&](const csdb::Transaction& queued) {
+        transactions.push_back(queued);
+        return true;
+    });
+    ASSERT_EQ(transaction1, transactions.at(0));
+    ASSERT_EQ(transaction2, transactions.at(1));
 }
 
 TEST(Conveyer, MainLogic) {
@@ -207,3 +207,33 @@ TEST(DataStream, CorrectAmountSerialization) {
 
     ASSERT_TRUE(amount == expectedAmount);
 }
+
+TEST(DataStream, CorrectAddressAndTransactionIdSerialization) {
+    cs::PublicKey key{};
+    key.fill(0x5a);
+
+    const auto keyAddress = csdb::Address::from_public_key(key);
+    const auto idAddress = csdb::Address::from_wallet_id(42);
+    const csdb::TransactionID id(csdb::PoolHash::calc_from_data(cs::Bytes{1, 2, 3}), 7);
+
+    cs::Bytes bytes;
+    cs::DataStream stream(bytes);
+
+    stream << keyAddress << idAddress << std::vector<csdb::TransactionID>{id, id};
+
+    cs::DataStream readStream(bytes.data(), bytes.size());
+    csdb::Address expectedKeyAddress;
+    csdb::Address expectedIdAddress;
+    std::vector<csdb::TransactionID> expectedIds;
+
+    readStream >> expectedKeyAddress >> expectedIdAddress >> expectedIds;
+
+    ASSERT_TRUE(readStream.isValid());
+    ASSERT_EQ(readStream.size(), 0);
+    ASSERT_TRUE(expectedKeyAddress.is_public_key());
+    ASSERT_TRUE(keyAddress == expectedKeyAddress);
+    ASSERT_TRUE(expectedIdAddress.is_wallet_id());
+    ASSERT_EQ(expectedIdAddress.wallet_id(), 42u);
+    ASSERT_EQ(expectedIds.size(), 2u);
+    ASSERT_TRUE(expectedIds[1] == id);
+}
@@ -0,0 +1,191 @@
+#include <gtest/gtest.h>
+
+#include <csdb/amount_commission.hpp>
+#include <csdb/currency.hpp>
+#include <csnode/mempool.hpp>
+
+namespace {
+csdb::Address makeAddress(uint8_t source) {
+    cs::PublicKey key{};
+    key.back() = source;
+    return csdb::Address::from_public_key(key);
+}
+
+csdb::Transaction makeTransaction(const csdb::Address& source, int64_t innerId, double fee) {
+    cs::Signature signature{};
+    signature.front() = static_cast<uint8_t>(innerId);
+    signature.back() = static_cast<uint8_t>(fee);
+
+    return csdb::Transaction(innerId, source, csdb::Address::from_wallet_id(1), csdb::Currency(1), csdb::Amount(1), csdb::AmountCommission(fee),
+                             csdb::AmountCommission(0.), signature);
+}
+
+csdb::Transaction makeTransaction(uint8_t source, int64_t innerId, double fee) {
+    return makeTransaction(makeAddress(source), innerId, fee);
+}
+
+std::vector<std::pair<uint8_t, int64_t>> ids(const std::vector<csdb::Transaction>& transactions) {
+    std::vector<std::pair<uint8_t, int64_t>> result;
+
+    for (const auto& transaction : transactions) {
+        result.emplace_back(transaction.source().public_key().back(), transaction.innerID());
+    }
+
+    return result;
+}
+}  // namespace
+
+TEST(Mempool, DropsDuplicates) {
+    cs::Mempool mempool(10);
+
+    ASSERT_EQ(mempool.add(makeTransaction(1, 1, 1.0)), cs::Mempool::Admission::Admitted);
+    ASSERT_EQ(mempool.add(makeTransaction(1, 1, 1.0)), cs::Mempool::Admission::Duplicate);
+    ASSERT_EQ(mempool.add(makeTransaction(1, 1, 2.0)), cs::Mempool::Admission::Conflict);
+
+    ASSERT_EQ(mempool.size(), 1u);
+    ASSERT_EQ(mempool.stats().attempts(), 3u);
+    ASSERT_EQ(mempool.stats().duplicates, 1u);
+}
+
+TEST(Mempool, DropsTakenAndConfirmedInnerIds) {
+    cs::Mempool mempool(10);
+
+    mempool.add(makeTransaction(1, 2, 1.0));
+    ASSERT_EQ(mempool.take(10).size(), 1u);
+
+    // taken transaction and the ones before it are not added again
+    ASSERT_EQ(mempool.add(makeTransaction(1, 2, 1.0)), cs::Mempool::Admission::Duplicate);
+    ASSERT_EQ(mempool.add(makeTransaction(1, 1, 2.0)), cs::Mempool::Admission::Duplicate);
+
+    mempool.add(makeTransaction(1, 3, 1.0));
+    mempool.add(makeTransaction(1, 5, 1.0));
+
+    // confirmed inner id drops pending transaction and is not added again
+    mempool.confirm(makeAddress(1), 4);
+    ASSERT_EQ(mempool.add(makeTransaction(1, 3, 1.0)), cs::Mempool::Admission::Duplicate);
+    ASSERT_EQ(mempool.add(makeTransaction(1, 4, 1.0)), cs::Mempool::Admission::Duplicate);
+
+    using Ids = std::vector<std::pair<uint8_t, int64_t>>;
+    ASSERT_EQ(ids(mempool.take(10)), (Ids{{1, 5}}));
+    ASSERT_EQ(mempool.stats().duplicates, 4u);
+}
+
+TEST(Mempool, TakesByFeeWithNonceOrder) {
+    cs::Mempool mempool(10);
+
+    // source 1 pays more for the later transaction, it is still taken after the first one
+    mempool.add(makeTransaction(1, 2, 8.0));
+    mempool.add(makeTransaction(1, 1, 1.0));
+    mempool.add(makeTransaction(2, 1, 4.0));
+    mempool.add(makeTransaction(2, 3, 16.0));
+
+    using Ids = std::vector<std::pair<uint8_t, int64_t>>;
+    ASSERT_EQ(ids(mempool.take(10)), (Ids{{2, 1}, {1, 1}, {1, 2}}));
+
+    // gap in inner ids holds transaction until missing one arrives
+    ASSERT_EQ(mempool.size(), 1u);
+    ASSERT_TRUE(mempool.take(10).empty());
+
+    mempool.add(makeTransaction(2, 2, 1.0));
+    ASSERT_EQ(ids(mempool.take(10)), (Ids{{2, 2}, {2, 3}}));
+    ASSERT_TRUE(mempool.isEmpty());
+}
+
+TEST(Mempool, ConfirmedInnerIdFillsGap) {
+    cs::Mempool mempool(10);
+
+    mempool.add(makeTransaction(1, 5, 1.0));
+    mempool.add(makeTransaction(1, 7, 1.0));
+    mempool.add(makeTransaction(1, 3, 1.0));
+
+    using Ids = std::vector<std::pair<uint8_t, int64_t>>;
+    ASSERT_EQ(ids(mempool.take(10)), (Ids{{1, 3}}));
+
+    // transaction 4 came to chain bypassing mempool
+    mempool.confirm(makeAddress(1), 4);
+    ASSERT_EQ(ids(mempool.take(10)), (Ids{{1, 5}}));
+
+    // confirmed transactions are dropped from mempool
+    mempool.confirm(makeAddress(1), 7);
+    ASSERT_TRUE(mempool.isEmpty());
+    ASSERT_TRUE(mempool.take(10).empty());
+}
+
+TEST(Mempool, ResolvesSourceToSingleChain) {
+    cs::Mempool mempool(10);
+    const auto walletId = csdb::Address::from_wallet_id(7);
+
+    mempool.setSourceResolver([&walletId](const csdb::Address& address) { return address == walletId ? makeAddress(1) : address; });
+
+    mempool.add(makeTransaction(1, 1, 1.0));
+    ASSERT_EQ(mempool.add(makeTransaction(walletId, 1, 1.0)), cs::Mempool::Admission::Duplicate);
+
+    // both forms of source make one chain, so order of inner ids is kept
+    mempool.add(makeTransaction(walletId, 2, 8.0));
+    mempool.add(makeTransaction(walletId, 3, 8.0));
+    mempool.add(makeTransaction(2, 1, 4.0));
+
+    const auto taken = mempool.take(10);
+    ASSERT_EQ(taken.size(), 4u);
+    ASSERT_EQ(taken[0].source(), makeAddress(2));
+    ASSERT_EQ(taken[1].innerID(), 1);
+    ASSERT_EQ(taken[2].innerID(), 2);
+    ASSERT_EQ(taken[3].innerID(), 3);
+}
+
+TEST(Mempool, EvictsCheapest) {
+    cs::Mempool mempool(3);
+
+    mempool.add(makeTransaction(1, 1, 1.0));
+    mempool.add(makeTransaction(1, 2, 10.0));
+    mempool.add(makeTransaction(2, 1, 5.0));
+
+    ASSERT_EQ(mempool.add(makeTransaction(3, 1, 0.5)), cs::Mempool::Admission::Rejected);
+
+    // following transaction of evicted source is evicted too
+    ASSERT_EQ(mempool.add(makeTransaction(3, 1, 2.0)), cs::Mempool::Admission::Admitted);
+    ASSERT_EQ(mempool.size(), 2u);
+    ASSERT_EQ(mempool.stats().evicted, 2u);
+
+    using Ids = std::vector<std::pair<uint8_t, int64_t>>;
+    ASSERT_EQ(ids(mempool.take(10)), (Ids{{2, 1}, {3, 1}}));
+}
+
+TEST(Mempool, ForgetsChainsOfUnconfirmedTransactions) {
+    cs::Mempool mempool(10);
+
+    mempool.add(makeTransaction(1, 1, 1.0));
+    mempool.add(makeTransaction(2, 1, 1.0));
+    ASSERT_EQ(mempool.take(10).size(), 2u);
+
+    // chains wait for confirmation of taken transactions
+    ASSERT_EQ(mempool.chainsCount(), 2u);
+    mempool.confirm(makeAddress(2), 1);
+    ASSERT_EQ(mempool.chainsCount(), 1u);
+
+    // transaction 3 waits for the missing one
+    mempool.add(makeTransaction(1, 3, 1.0));
+    ASSERT_TRUE(mempool.take(10).empty());
+
+    for (uint64_t i = 0; i < cs::Mempool::ExpireRounds; ++i) {
+        mempool.nextRound();
+    }
+
+    // chain with pending transaction is kept
+    ASSERT_EQ(mempool.chainsCount(), 1u);
+    mempool.add(makeTransaction(1, 2, 1.0));
+
+    using Ids = std::vector<std::pair<uint8_t, int64_t>>;
+    ASSERT_EQ(ids(mempool.take(10)), (Ids{{1, 2}, {1, 3}}));
+
+    for (uint64_t i = 0; i + 1 < cs::Mempool::ExpireRounds; ++i) {
+        mempool.nextRound();
+    }
+
+    ASSERT_EQ(mempool.chainsCount(), 1u);
+
+    // taken transaction never came to chain
+    mempool.nextRound();
+    ASSERT_EQ(mempool.chainsCount(), 0u);
+    ASSERT_TRUE(mempool.isEmpty());
+}
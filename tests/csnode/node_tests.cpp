@@ -7,6 +7,7 @@
 #include <mutex>
 #include <thread>
 
+#include <csnode/blockreplycache.hpp>
 #include <csnode/node.hpp>
 #include "clientconfigmock.hpp"
 #include "gtest/gtest.h"
@@ -20,3 +21,76 @@ TEST(NodeTest, connection) {
 
     ASSERT_EQ(true, true);
 }
+
+namespace {
+cs::BlockReplyCache::Reply makeReply(RegionAllocator& allocator, const cs::PoolsRequestedSequences& sequences) {
+    cs::BlockReplyCache::Reply reply;
+    reply.sequences = sequences;
+    reply.compressed = allocator.allocateNext(16);
+    reply.realBinSize = 32;
+
+    return reply;
+}
+}  // namespace
+
+TEST(BlockReplyCache, FindsReplyToTheSameSequences) {
+    RegionAllocator allocator;
+    cs::BlockReplyCache cache(4);
+
+    const auto reply = makeReply(allocator, {10, 11, 12});
+    cache.insert(reply);
+
+    const auto cached = cache.find({10, 11, 12});
+    ASSERT_NE(cached, nullptr);
+
+    // region is shared, not copied
+    ASSERT_EQ(cached->compressed, reply.compressed);
+    ASSERT_EQ(cached->realBinSize, reply.realBinSize);
+
+    ASSERT_EQ(cache.find({10, 11}), nullptr);
+    ASSERT_EQ(cache.find({11, 12}), nullptr);
+    ASSERT_EQ(cache.find({}), nullptr);
+}
+
+TEST(BlockReplyCache, DropsOldestReplies) {
+    RegionAllocator allocator;
+    cs::BlockReplyCache cache(2);
+
+    cache.insert(makeReply(allocator, {1}));
+    cache.insert(makeReply(allocator, {2}));
+    cache.insert(makeReply(allocator, {3}));
+
+    ASSERT_EQ(cache.size(), 2u);
+    ASSERT_EQ(cache.find({1}), nullptr);
+    ASSERT_NE(cache.find({2}), nullptr);
+    ASSERT_NE(cache.find({3}), nullptr);
+
+    // newer reply to the same first sequence replaces the old one keeping its place
+    cache.insert(makeReply(allocator, {2, 3}));
+    cache.insert(makeReply(allocator, {4}));
+
+    ASSERT_EQ(cache.size(), 2u);
+    ASSERT_EQ(cache.find({2, 3}), nullptr);
+    ASSERT_NE(cache.find({3}), nullptr);
+    ASSERT_NE(cache.find({4}), nullptr);
+}
+
+TEST(BlockReplyCache, RemovedBlockInvalidatesReplies) {
+    RegionAllocator allocator;
+    cs::BlockReplyCache cache(8);
+
+    cache.insert(makeReply(allocator, {1, 2, 3}));
+    cache.insert(makeReply(allocator, {4, 5}));
+    cache.insert(makeReply(allocator, {6}));
+
+    cache.remove(5);
+
+    ASSERT_EQ(cache.size(), 1u);
+    ASSERT_NE(cache.find({1, 2, 3}), nullptr);
+    ASSERT_EQ(cache.find({4, 5}), nullptr);
+    ASSERT_EQ(cache.find({6}), nullptr);
+
+    // the order of dropped replies is forgotten too
+    cache.insert(makeReply(allocator, {4}));
+    ASSERT_EQ(cache.size(), 2u);
+}
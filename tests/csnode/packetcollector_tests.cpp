@@ -0,0 +1,91 @@
+#include <gtest/gtest.h>
+
+#include "packstream.hpp"
+
+#include <algorithm>
+#include <vector>
+
+namespace {
+struct Fragmented {
+    std::vector<Packet> fragments;
+    cs::Bytes payload;
+};
+
+// broadcast message of several fragments, payload follows its size in full data
+Fragmented makeFragmented(RegionAllocator& allocator, const size_t size) {
+    Fragmented result;
+    result.payload.resize(size);
+
+    for (size_t i = 0; i < size; ++i) {
+        result.payload[i] = static_cast<cs::Byte>(i * 7);
+    }
+
+    cs::OPackStream stream(&allocator, cs::PublicKey{});
+    stream.init(BaseFlags::Fragmented | BaseFlags::Broadcast);
+    stream << cs::BytesView(result.payload.data(), result.payload.size());
+
+    auto packets = stream.getPackets();
+    result.fragments.assign(packets, packets + stream.getPacketsCount());
+
+    return result;
+}
+
+void checkFullData(const MessagePtr& msg, const cs::Bytes& payload) {
+    ASSERT_EQ(msg->getFullSize(), sizeof(size_t) + payload.size());
+
+    auto data = msg->getFullData();
+    size_t size = 0;
+    std::copy(data, data + sizeof(size), reinterpret_cast<uint8_t*>(&size));
+
+    ASSERT_EQ(size, payload.size());
+    ASSERT_TRUE(std::equal(payload.begin(), payload.end(), data + sizeof(size_t)));
+}
+}  // namespace
+
+TEST(PacketCollector, FragmentsAssembledInAnyOrder) {
+    RegionAllocator allocator;
+    PacketCollector collector;
+
+    auto message = makeFragmented(allocator, 5000);
+    ASSERT_GT(message.fragments.size(), 2u);
+
+    // the last fragment comes first, so assembly starts with the next one
+    std::reverse(message.fragments.begin(), message.fragments.end());
+
+    MessagePtr msg;
+
+    for (size_t i = 0; i < message.fragments.size(); ++i) {
+        bool newMessage = false;
+        msg = collector.getMessage(message.fragments[i], newMessage);
+
+        ASSERT_TRUE(msg);
+        ASSERT_EQ(newMessage, i == 0);
+        ASSERT_EQ(msg->isComplete(), i + 1 == message.fragments.size());
+    }
+
+    checkFullData(msg, message.payload);
+}
+
+TEST(PacketCollector, DuplicateFragmentIsIgnored) {
+    RegionAllocator allocator;
+    PacketCollector collector;
+
+    auto message = makeFragmented(allocator, 3000);
+    const auto count = static_cast<uint32_t>(message.fragments.size());
+
+    bool newMessage = false;
+    auto msg = collector.getMessage(message.fragments.front(), newMessage);
+    collector.getMessage(message.fragments.front(), newMessage);
+
+    ASSERT_TRUE(msg->hasFragment(0));
+    ASSERT_FALSE(msg->hasFragment(1));
+    ASSERT_FALSE(msg->hasFragment(count));
+
+    for (uint32_t i = 1; i < count; ++i) {
+        ASSERT_FALSE(msg->isComplete());
+        collector.getMessage(message.fragments[i], newMessage);
+    }
+
+    ASSERT_TRUE(msg->isComplete());
+    checkFullData(msg, message.payload);
+}
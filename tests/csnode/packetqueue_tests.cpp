@@ -36,8 +36,11 @@ TEST(PacketQueue, EmptyState) {
 }
 
 void addTransactions(cs::PacketQueue& queue) {
+    // the same transactions are dropped, so inner ids differ
     for (size_t i = 0; i < (kMaxPacketTransactions * 2) + 1; ++i) {
-        queue.push(csdb::Transaction{});
+        csdb::Transaction transaction;
+        transaction.set_innerID(static_cast<int64_t>(i));
+        queue.push(transaction);
     }
 }
 
@@ -46,6 +49,8 @@ TEST(PacketQueue, pushTransaction) {
     addTransactions(queue);
 
     ASSERT_EQ(queue.size(), 3);
+    ASSERT_EQ(queue.transactionsCount(), kMaxPacketTransactions * 2 + 1);
+    ASSERT_FALSE(queue.push(csdb::Transaction{}));
 }
 
 TEST(PacketQueue, popTransactionsBlocks) {
@@ -0,0 +1,125 @@
+#include <gtest/gtest.h>
+
+#include <cstring>
+
+#include <cscrypto/cscrypto.hpp>
+#include <csdb/address.hpp>
+#include <csdb/amount_commission.hpp>
+#include <csdb/currency.hpp>
+#include <csnode/signaturecache.hpp>
+#include <csnode/transactionspacket.hpp>
+
+namespace {
+const auto& keys() {
+    static const auto keys = [] {
+        cscrypto::mnemonic::WordList words;
+        words.fill(cscrypto::mnemonic::langs::en[0]);
+        return cscrypto::keys_derivation::deriveKeyPair(cscrypto::mnemonic::wordsToMasterSeed(words), 0);
+    }();
+
+    return keys;
+}
+
+cs::Bytes makeMessage(uint64_t value) {
+    cs::Bytes message(sizeof(value));
+    std::memcpy(message.data(), &value, sizeof(value));
+    return message;
+}
+
+cs::Signature sign(const cs::Bytes& message) {
+    return cscrypto::generateSignature(keys().second, message.data(), message.size());
+}
+
+csdb::Transaction makeTransaction(int64_t innerId, const csdb::Address& source) {
+    csdb::Transaction transaction(innerId, source, csdb::Address::from_wallet_id(1), csdb::Currency(1), csdb::Amount(1), csdb::AmountCommission(1.),
+                                  csdb::AmountCommission(0.), cs::Signature{});
+    transaction.set_signature(sign(transaction.to_byte_stream_for_sig()));
+    return transaction;
+}
+
+// stores records without signing and verifying, so the cache is filled fast
+class FilledSignatureCache : public cs::SignatureCache {
+public:
+    void fill(uint64_t count) {
+        for (uint64_t i = 0; i < count; ++i) {
+            cs::Hash key{};
+            std::memcpy(key.data(), &i, sizeof(i));
+            store(key);
+        }
+    }
+};
+}  // namespace
+
+TEST(SignatureCache, CachesValidSignature) {
+    cs::SignatureCache cache;
+    const auto message = makeMessage(1);
+    const auto signature = sign(message);
+
+    ASSERT_TRUE(cache.verify(signature, keys().first, message));
+    ASSERT_EQ(cache.hits(), 0u);
+    ASSERT_EQ(cache.misses(), 1u);
+
+    ASSERT_TRUE(cache.verify(signature, keys().first, message));
+    ASSERT_EQ(cache.hits(), 1u);
+    ASSERT_EQ(cache.misses(), 1u);
+}
+
+TEST(SignatureCache, DoesNotCacheInvalidSignature) {
+    cs::SignatureCache cache;
+    const auto message = makeMessage(1);
+    auto signature = sign(message);
+    signature.front() ^= 0xff;
+
+    ASSERT_FALSE(cache.verify(signature, keys().first, message));
+    ASSERT_FALSE(cache.verify(signature, keys().first, message));
+
+    // the same signature does not confirm other message
+    ASSERT_TRUE(cache.verify(sign(message), keys().first, message));
+    ASSERT_FALSE(cache.verify(sign(message), keys().first, makeMessage(2)));
+
+    ASSERT_EQ(cache.hits(), 0u);
+    ASSERT_EQ(cache.misses(), 4u);
+}
+
+TEST(SignatureCache, EvictsOldest) {
+    FilledSignatureCache cache;
+
+    const auto oldest = sign(makeMessage(0));
+    const auto latest = sign(makeMessage(1));
+
+    ASSERT_TRUE(cache.verify(oldest, keys().first, makeMessage(0)));
+    ASSERT_TRUE(cache.verify(latest, keys().first, makeMessage(1)));
+    ASSERT_EQ(cache.misses(), 2u);
+
+    // one record more than the cache holds pushes the oldest one out
+    cache.fill(cs::SignatureCache::MaxSize - 1);
+
+    ASSERT_TRUE(cache.verify(latest, keys().first, makeMessage(1)));
+    ASSERT_EQ(cache.hits(), 1u);
+
+    ASSERT_TRUE(cache.verify(oldest, keys().first, makeMessage(0)));
+    ASSERT_EQ(cache.hits(), 1u);
+    ASSERT_EQ(cache.misses(), 3u);
+}
+
+TEST(SignatureCache, VerifiedPacketTransactionsAreHits) {
+    cs::SignatureCache cache;
+    const auto byKey = makeTransaction(1, csdb::Address::from_public_key(keys().first));
+    const auto byId = makeTransaction(2, csdb::Address::from_wallet_id(7));
+
+    cs::TransactionsPacket packet;
+    packet.addTransaction(byKey);
+    packet.addTransaction(byId);
+
+    cache.verify(packet);
+    ASSERT_EQ(cache.hits(), 0u);
+    ASSERT_EQ(cache.misses(), 0u);
+
+    ASSERT_TRUE(cache.verify(byKey, keys().first));
+    ASSERT_EQ(cache.hits(), 1u);
+
+    // key of wallet id source is not known to packet verification
+    ASSERT_TRUE(cache.verify(byId, keys().first));
+    ASSERT_EQ(cache.hits(), 1u);
+    ASSERT_EQ(cache.misses(), 1u);
+}
@@ -0,0 +1,276 @@
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <boost/filesystem.hpp>
+
+#include <csdb/database.hpp>
+#include <csdb/database_berkeleydb.hpp>
+#include <csdb/pool.hpp>
+#include <csdb/storage.hpp>
+
+namespace {
+// in-memory database, records batches written by storage write thread
+class BatchDatabase : public csdb::Database {
+public:
+    bool is_open() const override {
+        return true;
+    }
+
+    bool put(const cs::Bytes& key, uint32_t seq_no, const cs::Bytes& value) override {
+        std::lock_guard lock(mutex);
+        pools[key] = value;
+        sequences[seq_no] = key;
+        return true;
+    }
+
+    bool get(const cs::Bytes& key, cs::Bytes* value) override {
+        std::lock_guard lock(mutex);
+        const auto it = pools.find(key);
+
+        if (it == pools.end()) {
+            return false;
+        }
+
+        if (value) {
+            *value = it->second;
+        }
+
+        return true;
+    }
+
+    bool get(const uint32_t seq_no, cs::Bytes* value) override {
+        std::lock_guard lock(mutex);
+        const auto it = sequences.find(seq_no);
+
+        if (it == sequences.end()) {
+            return false;
+        }
+
+        if (value) {
+            *value = pools[it->second];
+        }
+
+        return true;
+    }
+
+    bool remove(const cs::Bytes&) override {
+        return false;
+    }
+
+    bool write_batch(const ItemList&) override {
+        return false;
+    }
+
+    bool write_batch(const SeqItemList& items) override {
+        std::lock_guard lock(mutex);
+
+        if (failures > 0) {
+            --failures;
+            return false;
+        }
+
+        for (const auto& item : items) {
+            pools[item.key] = item.value;
+            sequences[item.seq_no] = item.key;
+        }
+
+        batches.push_back(items.size());
+        return true;
+    }
+
+#ifdef TRANSACTIONS_INDEX
+    bool putToTransIndex(const cs::Bytes&, const cs::Bytes&) override {
+        return false;
+    }
+
+    bool getFromTransIndex(const cs::Bytes&, cs::Bytes*) override {
+        return false;
+    }
+
+    bool putToAddressIndex(const cs::Bytes&, const cs::Bytes&) override {
+        return false;
+    }
+
+    bool getFromAddressIndex(const cs::Bytes&, cs::Bytes*) override {
+        return false;
+    }
+
+    bool removeFromAddressIndex(const cs::Bytes&) override {
+        return false;
+    }
+#endif
+
+    IteratorPtr new_iterator() override {
+        return std::make_shared<EmptyIterator>();
+    }
+
+    std::mutex mutex;
+    std::map<cs::Bytes, cs::Bytes> pools;
+    std::map<uint32_t, cs::Bytes> sequences;
+    std::vector<size_t> batches;
+    size_t failures = 0;
+
+private:
+    class EmptyIterator : public Iterator {
+    public:
+        bool is_valid() const override {
+            return false;
+        }
+
+        void seek_to_first() override {
+        }
+
+        void seek_to_last() override {
+        }
+
+        void seek(const cs::Bytes&) override {
+        }
+
+        void next() override {
+        }
+
+        void prev() override {
+        }
+
+        cs::Bytes key() const override {
+            return {};
+        }
+
+        cs::Bytes value() const override {
+            return {};
+        }
+    };
+};
+
+std::vector<csdb::Pool> makeChain(cs::Sequence count) {
+    std::vector<csdb::Pool> chain;
+    csdb::PoolHash previous;
+
+    for (cs::Sequence seq = 0; seq < count; ++seq) {
+        csdb::Pool pool(previous, seq);
+        pool.compose();
+
+        previous = pool.hash();
+        chain.push_back(pool);
+    }
+
+    return chain;
+}
+}  // namespace
+
+TEST(StorageGroupCommit, WritesQueuedPoolsInBatches) {
+    auto db = std::make_shared<BatchDatabase>();
+    csdb::Storage storage;
+    ASSERT_TRUE(storage.open(csdb::Storage::OpenOptions{db}));
+
+    storage.set_group_commit(4);
+    const auto chain = makeChain(20);
+
+    for (const auto& pool : chain) {
+        ASSERT_TRUE(storage.pool_save(pool));
+    }
+
+    // queued pools are found before they are written
+    ASSERT_TRUE(storage.pool_load(chain.back().hash()).is_valid());
+
+    storage.close();
+
+    ASSERT_EQ(db->pools.size(), chain.size());
+    for (const auto& pool : chain) {
+        ASSERT_EQ(db->sequences[static_cast<uint32_t>(pool.sequence())], pool.hash().to_binary());
+    }
+
+    for (size_t size : db->batches) {
+        ASSERT_LE(size, 4u);
+    }
+
+    const auto stats = storage.write_stats();
+    ASSERT_EQ(stats.pools_written, chain.size());
+    ASSERT_EQ(stats.batches, db->batches.size());
+    ASSERT_EQ(stats.queue_depth, 0u);
+    ASSERT_EQ(stats.failed_batches, 0u);
+}
+
+TEST(StorageGroupCommit, BytesLimitCutsBatch) {
+    auto db = std::make_shared<BatchDatabase>();
+    csdb::Storage storage;
+    ASSERT_TRUE(storage.open(csdb::Storage::OpenOptions{db}));
+
+    // every pool exceeds the limit, so each one is written by its own transaction
+    storage.set_group_commit(8, 1);
+    const auto chain = makeChain(10);
+
+    for (const auto& pool : chain) {
+        ASSERT_TRUE(storage.pool_save(pool));
+    }
+
+    storage.close();
+
+    ASSERT_EQ(db->pools.size(), chain.size());
+    ASSERT_EQ(db->batches, std::vector<size_t>(chain.size(), 1));
+}
+
+TEST(StorageGroupCommit, FailedBatchIsRetried) {
+    auto db = std::make_shared<BatchDatabase>();
+    db->failures = 1;
+
+    csdb::Storage storage;
+    ASSERT_TRUE(storage.open(csdb::Storage::OpenOptions{db}));
+
+    bool writeFailed = false;
+    auto onWriteFailed = [&writeFailed](cs::Sequence, size_t) { writeFailed = true; };
+    cs::Connector::connect(&storage.writeFailedEvent(), onWriteFailed);
+
+    storage.set_group_commit(4);
+    const auto chain = makeChain(3);
+
+    for (const auto& pool : chain) {
+        ASSERT_TRUE(storage.pool_save(pool));
+    }
+
+    // failed group stays queued and is written by the next attempt
+    while (storage.write_stats().pools_written != chain.size()) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+
+    storage.close();
+
+    ASSERT_EQ(db->pools.size(), chain.size());
+    ASSERT_EQ(storage.write_stats().failed_batches, 1u);
+    ASSERT_FALSE(writeFailed);
+}
+
+TEST(DatabaseBerkeleyDB, WriteBatchStoresPoolsBySequence) {
+    const auto path = boost::filesystem::temp_directory_path() / boost::filesystem::unique_path();
+
+    {
+        csdb::DatabaseBerkeleyDB berkeley;
+        ASSERT_TRUE(berkeley.open(path.string()));
+
+        csdb::Database& db = berkeley;
+        const csdb::Database::SeqItemList items{
+            {cs::Bytes{1}, 1, cs::Bytes{10, 11}},
+            {cs::Bytes{2}, 2, cs::Bytes{20}},
+            {cs::Bytes{3}, 3, cs::Bytes{30, 31, 32}},
+        };
+
+        ASSERT_TRUE(db.write_batch(items));
+
+        for (const auto& item : items) {
+            cs::Bytes value;
+            ASSERT_TRUE(db.get(item.key, &value));
+            ASSERT_EQ(value, item.value);
+
+            value.clear();
+            ASSERT_TRUE(db.get(item.seq_no, &value));
+            ASSERT_EQ(value, item.value);
+        }
+    }
+
+    boost::filesystem::remove_all(path);
+}
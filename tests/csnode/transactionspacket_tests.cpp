@@ -194,3 +194,27 @@ TEST(TransactionPacketHash, fromBinary) {
 
     ASSERT_EQ(hash, testPacket.hash());
 }
+
+TEST(TransactionPacketHash, keepsBytesOrder) {
+    cs::Bytes lowBytes(cscrypto::kHashSize, 0x01);
+    cs::Bytes highBytes = lowBytes;
+    highBytes.back() = 0x02;
+
+    auto low = cs::TransactionsPacketHash::fromBinary(lowBytes);
+    auto high = cs::TransactionsPacketHash::fromBinary(highBytes);
+    cs::TransactionsPacketHash empty;
+
+    ASSERT_TRUE(empty.isEmpty());
+    ASSERT_TRUE(cs::TransactionsPacketHash::fromBinary(cs::Bytes(3, 0x01)).isEmpty());
+
+    ASSERT_TRUE(empty < low);
+    ASSERT_FALSE(low < empty);
+    ASSERT_TRUE(low < high);
+    ASSERT_FALSE(high < low);
+    ASSERT_NE(low, high);
+
+    // hash table index is taken from the first bytes
+    ASSERT_EQ(low.calcHash(), high.calcHash());
+    ASSERT_EQ(low.toBinary(), lowBytes);
+    ASSERT_EQ(cs::Bytes(high.data(), high.data() + high.size()), highBytes);
+}
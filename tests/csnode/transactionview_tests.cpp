@@ -0,0 +1,114 @@
+#include <gtest/gtest.h>
+
+#include <csdb/address.hpp>
+#include <csdb/currency.hpp>
+#include <csdb/pool.hpp>
+#include <csdb/transaction.hpp>
+#include <csdb/transaction_view.hpp>
+
+namespace {
+csdb::Transaction makeTransaction(int64_t innerId, bool withUserFields) {
+    cs::PublicKey target;
+    target.fill(static_cast<cs::Byte>(innerId));
+
+    csdb::Transaction transaction(innerId, csdb::Address::from_wallet_id(static_cast<csdb::internal::WalletId>(innerId + 100)), csdb::Address::from_public_key(target),
+                                  csdb::Currency(1), csdb::Amount(10, 5, 100), csdb::AmountCommission(0.5), csdb::AmountCommission(0.25), cs::Signature{});
+
+    if (withUserFields) {
+        transaction.add_user_field(-2, std::string("standard"));
+        transaction.add_user_field(1, std::string("comment"));
+        transaction.add_user_field(2, uint64_t(42));
+        transaction.add_user_field(3, csdb::Amount(1, 2, 10));
+    }
+
+    return transaction;
+}
+
+void checkView(const csdb::TransactionView& view, const csdb::Transaction& transaction) {
+    ASSERT_TRUE(view.is_valid());
+    ASSERT_EQ(view.innerID(), transaction.innerID());
+    ASSERT_EQ(view.source().to_address(), transaction.source());
+    ASSERT_EQ(view.target().to_address(), transaction.target());
+    ASSERT_EQ(view.amount(), transaction.amount());
+    ASSERT_EQ(view.max_fee().to_double(), transaction.max_fee().to_double());
+    ASSERT_EQ(view.counted_fee().to_double(), transaction.counted_fee().to_double());
+    ASSERT_EQ(view.user_fields_count(), transaction.user_field_ids().size());
+    ASSERT_EQ(view.to_byte_stream_for_sig(), transaction.to_byte_stream_for_sig());
+
+    for (auto id : transaction.user_field_ids()) {
+        ASSERT_EQ(view.user_field(id), transaction.user_field(id));
+    }
+
+    ASSERT_FALSE(view.user_field(100).is_valid());
+    ASSERT_EQ(view.to_transaction().to_binary(), const_cast<csdb::Transaction&>(transaction).to_binary());
+}
+}  // namespace
+
+TEST(TransactionView, MatchesTransaction) {
+    for (bool withUserFields : {false, true}) {
+        auto transaction = makeTransaction(7, withUserFields);
+        const auto binary = transaction.to_binary();
+
+        csdb::TransactionView view;
+        ASSERT_EQ(view.read(binary.data(), binary.size()), binary.size());
+        checkView(view, transaction);
+
+        ASSERT_EQ(view.read(binary.data(), binary.size() - 1), 0u);
+    }
+}
+
+TEST(TransactionView, PoolViews) {
+    csdb::Pool pool(csdb::PoolHash{}, 1);
+
+    for (int64_t i = 1; i <= 10; ++i) {
+        ASSERT_TRUE(pool.add_transaction(makeTransaction(i, i % 2 == 0)));
+    }
+
+    ASSERT_TRUE(pool.transaction_views().empty());
+    ASSERT_TRUE(pool.compose());
+
+    const auto views = pool.transaction_views();
+    ASSERT_EQ(views.size(), pool.transactions_count());
+
+    for (size_t i = 0; i < views.size(); ++i) {
+        checkView(views[i], pool.transaction(i));
+    }
+
+    auto restored = csdb::Pool::from_binary(pool.to_binary());
+    ASSERT_EQ(restored.transaction_views().size(), views.size());
+}
+
+TEST(TransactionView, LazyPoolDecoding) {
+    csdb::Pool pool(csdb::PoolHash{}, 1);
+
+    for (int64_t i = 1; i <= 10; ++i) {
+        ASSERT_TRUE(pool.add_transaction(makeTransaction(i, i % 3 == 0)));
+    }
+
+    ASSERT_TRUE(pool.compose());
+
+    auto restored = csdb::Pool::from_binary(pool.to_binary());
+    ASSERT_TRUE(restored.is_valid());
+    ASSERT_EQ(restored.transactions_count(), pool.transactions_count());
+    ASSERT_EQ(restored.hash(), pool.hash());
+
+    // lookups by address and single transactions don't need the whole pool decoded
+    const auto last = restored.get_last_by_target(makeTransaction(4, false).target());
+    ASSERT_EQ(last.innerID(), 4);
+    ASSERT_EQ(last.id(), pool.transaction(3).id());
+    ASSERT_FALSE(restored.get_last_by_source(csdb::Address::from_wallet_id(1)).id().is_valid());
+
+    const auto views = restored.transaction_views();
+    ASSERT_EQ(restored.transaction(views[5], 5).id(), pool.transaction(5).id());
+
+    // copy shares undecoded data with the original
+    const auto copy = restored;
+
+    ASSERT_EQ(restored.transactions().size(), pool.transactions_count());
+    for (size_t i = 0; i < pool.transactions_count(); ++i) {
+        ASSERT_EQ(copy.transaction(i).id(), pool.transaction(i).id());
+        checkView(views[i], copy.transaction(i));
+    }
+
+    ASSERT_EQ(restored.clone().transactions_count(), pool.transactions_count());
+}
@@ -0,0 +1,91 @@
+#include <gtest/gtest.h>
+
+#include <csdb/amount_commission.hpp>
+#include <csdb/currency.hpp>
+#include <csnode/walletscache.hpp>
+#include <csnode/walletsids.hpp>
+
+namespace {
+constexpr size_t WalletsCount = 600;
+
+csdb::Address makeAddress(size_t value) {
+    cs::PublicKey key{};
+    key[0] = static_cast<uint8_t>(value);
+    key[1] = static_cast<uint8_t>(value >> 8);
+    key.back() = 1;
+    return csdb::Address::from_public_key(key);
+}
+
+// moves amount out of target wallet, source wallet is touched with zero fee
+csdb::Transaction makeReplenish(size_t target) {
+    return csdb::Transaction(1, makeAddress(0), makeAddress(target), csdb::Currency(1), csdb::Amount(1), csdb::AmountCommission(0.), csdb::AmountCommission(0.),
+                             cs::Signature{});
+}
+
+class WalletsCacheTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        cs::WalletsIds::WalletId id = 0;
+
+        for (size_t i = 0; i < WalletsCount; ++i) {
+            ASSERT_TRUE(ids.normal().get(makeAddress(i), id));
+        }
+
+        for (size_t i = 1; i < WalletsCount; ++i) {
+            updater->invokeReplenishPayableContract(makeReplenish(i));
+        }
+
+        cache.publishSnapshot(1);
+    }
+
+    cs::WalletsIds ids;
+    cs::WalletsCache cache{cs::WalletsCache::Config{16}, makeAddress(0xfff0), makeAddress(0xfff1), ids};
+    std::unique_ptr<cs::WalletsCache::Updater> updater = cache.createUpdater();
+};
+}  // namespace
+
+TEST_F(WalletsCacheTest, publishedSnapshotIsNotChangedByWriter) {
+    const auto first = cache.snapshot();
+    ASSERT_EQ(first->sequence(), 1u);
+    ASSERT_EQ(first->size(), WalletsCount);
+
+    updater->invokeReplenishPayableContract(makeReplenish(520));
+    ASSERT_EQ(cache.snapshot(), first);
+
+    cache.publishSnapshot(2);
+    const auto second = cache.snapshot();
+    ASSERT_EQ(second->sequence(), 2u);
+
+    ASSERT_EQ(first->findWallet(520)->balance_, csdb::Amount(-1));
+    ASSERT_EQ(second->findWallet(520)->balance_, csdb::Amount(-2));
+}
+
+TEST_F(WalletsCacheTest, unmodifiedWalletsAreShared) {
+    const auto first = cache.snapshot();
+
+    updater->invokeReplenishPayableContract(makeReplenish(520));
+    cache.publishSnapshot(2);
+    const auto second = cache.snapshot();
+
+    // source wallet 0 and target 520 are copied, the rest is shared with previous snapshot
+    ASSERT_NE(first->findWallet(0), second->findWallet(0));
+    ASSERT_NE(first->findWallet(520), second->findWallet(520));
+    ASSERT_EQ(first->findWallet(1), second->findWallet(1));
+    ASSERT_EQ(first->findWallet(300), second->findWallet(300));
+    ASSERT_EQ(first->findWallet(521), second->findWallet(521));
+}
+
+TEST_F(WalletsCacheTest, newWalletsAreSeenByNextSnapshotOnly) {
+    const auto first = cache.snapshot();
+
+    cs::WalletsIds::WalletId id = 0;
+    ASSERT_TRUE(ids.normal().get(makeAddress(WalletsCount), id));
+    updater->invokeReplenishPayableContract(makeReplenish(WalletsCount));
+    cache.publishSnapshot(2);
+    const auto second = cache.snapshot();
+
+    ASSERT_EQ(first->findWallet(id), nullptr);
+    ASSERT_NE(second->findWallet(id), nullptr);
+    ASSERT_EQ(second->size(), WalletsCount + 1);
+    ASSERT_EQ(first->findWallet(300), second->findWallet(300));
+}
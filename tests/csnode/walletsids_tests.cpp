@@ -0,0 +1,50 @@
+#include <gtest/gtest.h>
+
+#include <csnode/walletsids.hpp>
+
+#include <atomic>
+#include <thread>
+
+namespace {
+csdb::Address makeAddress(uint8_t value) {
+    cs::PublicKey key{};
+    key.fill(value);
+    return csdb::Address::from_public_key(key);
+}
+}  // namespace
+
+TEST(WalletsIds, lookupsRunConcurrentlyWithInserts) {
+    cs::WalletsIds ids;
+    cs::WalletsIds::WalletId id = 0;
+    ASSERT_TRUE(ids.normal().get(makeAddress(1), id));
+
+    std::atomic<bool> done = false;
+    std::thread reader([&] {
+        while (!done) {
+            cs::WalletsIds::WalletId found = 0;
+            csdb::Address address;
+
+            ASSERT_TRUE(ids.normal().find(makeAddress(1), found));
+            ASSERT_TRUE(ids.normal().findaddr(found, address));
+            ASSERT_EQ(address, makeAddress(1));
+        }
+    });
+
+    for (size_t i = 0; i < 10000; ++i) {
+        cs::PublicKey key{};
+        std::copy(reinterpret_cast<const uint8_t*>(&i), reinterpret_cast<const uint8_t*>(&i) + sizeof(i), key.begin());
+        key.back() = 2;
+        ids.normal().get(csdb::Address::from_public_key(key), id);
+    }
+
+    done = true;
+    reader.join();
+
+    // every address got the next id
+    ASSERT_TRUE(ids.normal().find(makeAddress(1), id));
+    ASSERT_EQ(id, 0u);
+
+    csdb::Address address;
+    ASSERT_TRUE(ids.normal().findaddr(10000, address));
+    ASSERT_FALSE(ids.normal().findaddr(10001, address));
+}
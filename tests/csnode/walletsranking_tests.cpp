@@ -0,0 +1,93 @@
+#include <gtest/gtest.h>
+
+#include <random>
+#include <set>
+
+#include <csnode/walletsranking.hpp>
+
+namespace {
+std::vector<int> page(const cs::OrderedIndex<int>& index, size_t offset, size_t limit, bool desc) {
+    std::vector<int> result;
+
+    index.forEach(offset, desc, [&](int value) {
+        if (result.size() == limit) {
+            return false;
+        }
+
+        result.push_back(value);
+        return true;
+    });
+
+    return result;
+}
+
+std::vector<int> page(const std::set<int>& values, size_t offset, size_t limit, bool desc) {
+    std::vector<int> sorted(values.begin(), values.end());
+
+    if (desc) {
+        std::reverse(sorted.begin(), sorted.end());
+    }
+
+    const size_t begin = std::min(offset, sorted.size());
+    const size_t end = std::min(begin + limit, sorted.size());
+
+    return std::vector<int>(sorted.begin() + static_cast<std::ptrdiff_t>(begin), sorted.begin() + static_cast<std::ptrdiff_t>(end));
+}
+
+cs::WalletsRanking::Values makeValues(int32_t balance) {
+    cs::WalletsRanking::Values values;
+    values.balance = csdb::Amount(balance);
+    return values;
+}
+}  // namespace
+
+TEST(OrderedIndex, MatchesSortedSet) {
+    std::mt19937 random(42);
+    std::uniform_int_distribution<int> values(0, 20000);
+
+    cs::OrderedIndex<int> index;
+    std::set<int> expected;
+
+    for (int i = 0; i < 20000; ++i) {
+        const int value = values(random);
+
+        if (i % 3 == 2) {
+            ASSERT_EQ(index.erase(value), expected.erase(value) == 1);
+        }
+        else if (expected.insert(value).second) {
+            index.insert(value);
+        }
+    }
+
+    ASSERT_EQ(index.size(), expected.size());
+
+    for (size_t offset : {size_t(0), size_t(1), size_t(511), size_t(1024), expected.size() - 5, expected.size()}) {
+        for (bool desc : {false, true}) {
+            ASSERT_EQ(page(index, offset, 20, desc), page(expected, offset, 20, desc));
+        }
+    }
+
+    ASSERT_GT(index.memoryUsage(), index.size() * sizeof(int));
+
+    index.assign(std::vector<int>(expected.rbegin(), expected.rend()));
+    ASSERT_EQ(page(index, 100, 1000, false), page(expected, 100, 1000, false));
+}
+
+TEST(WalletsRanking, UpdatesOrder) {
+    cs::WalletsRanking ranking;
+    ranking.reset({{0, makeValues(5)}, {1, makeValues(10)}, {2, makeValues(-1)}});
+
+    // negative balance is not ranked
+    using Ids = std::vector<cs::WalletsRanking::WalletId>;
+    ASSERT_EQ(ranking.size(), 2u);
+    ASSERT_EQ(ranking.get(cs::WalletsRanking::Order::Balance, true, 0, 10), (Ids{1, 0}));
+
+    const auto values = makeValues(7);
+    ranking.update(2, &values);
+    ranking.update(3, &values);
+    ranking.update(1, nullptr);
+
+    ASSERT_EQ(ranking.get(cs::WalletsRanking::Order::Balance, false, 0, 10), (Ids{0, 2, 3}));
+    ASSERT_EQ(ranking.get(cs::WalletsRanking::Order::Balance, true, 1, 1), (Ids{2}));
+    ASSERT_TRUE(ranking.get(cs::WalletsRanking::Order::Balance, true, 3, 1).empty());
+}
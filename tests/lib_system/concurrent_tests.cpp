@@ -7,6 +7,7 @@
 #include <atomic>
 #include <iostream>
 #include <string>
+#include <vector>
 
 using ThreadId = std::thread::id;
 
@@ -411,3 +412,22 @@ TEST(Concurrent, FutureWatcherHighMultithreading) {
 
     ASSERT_EQ(currentThreadPoolSum, expectedSum);
 }
+
+TEST(Concurrent, ForEachVisitsEveryIndexOnce) {
+    constexpr size_t count = 10007;
+    std::vector<std::atomic<int>> visits(count);
+
+    for (auto& visit : visits) {
+        visit.store(0);
+    }
+
+    cs::Concurrent::forEach(count, 16, [&](size_t i) { visits[i].fetch_add(1); });
+
+    for (size_t i = 0; i < count; ++i) {
+        ASSERT_EQ(visits[i].load(), 1);
+    }
+
+    size_t calls = 0;
+    cs::Concurrent::forEach(0, 16, [&](size_t) { ++calls; });
+    ASSERT_EQ(calls, 0);
+}
@@ -0,0 +1,116 @@
+#include <algorithm>
+#include <vector>
+
+#include <net/dispatchlanes.hpp>
+
+#include "gtest/gtest.h"
+
+namespace {
+Packet makePacket(RegionAllocator& allocator, MsgTypes type) {
+    // broadcast packet: flags, sender key and id, then message type and round
+    constexpr uint32_t headers = sizeof(BaseFlags) + cscrypto::kPublicKeySize + sizeof(uint64_t);
+    constexpr uint32_t size = headers + sizeof(MsgTypes) + sizeof(cs::RoundNumber);
+
+    RegionPtr region = allocator.allocateNext(size);
+    auto data = static_cast<uint8_t*>(region->data());
+
+    std::fill(data, data + size, 0);
+    data[0] = BaseFlags::Broadcast;
+    data[headers] = type;
+
+    return Packet(std::move(region));
+}
+}  // namespace
+
+TEST(DispatchLanes, MessageTypesAreClassified) {
+    ASSERT_EQ(DispatchLanes::laneOf(MsgTypes::FirstStage), DispatchLanes::Consensus);
+    ASSERT_EQ(DispatchLanes::laneOf(MsgTypes::ThirdSmartStage), DispatchLanes::Consensus);
+    ASSERT_EQ(DispatchLanes::laneOf(MsgTypes::RoundTable), DispatchLanes::RoundTable);
+    ASSERT_EQ(DispatchLanes::laneOf(MsgTypes::TransactionsPacketReply), DispatchLanes::RoundTable);
+    ASSERT_EQ(DispatchLanes::laneOf(MsgTypes::TransactionPacket), DispatchLanes::Transactions);
+    ASSERT_EQ(DispatchLanes::laneOf(MsgTypes::BlockRequest), DispatchLanes::Sync);
+    ASSERT_EQ(DispatchLanes::laneOf(MsgTypes::NodeStopRequest), DispatchLanes::Misc);
+}
+
+TEST(DispatchLanes, ConsensusGoesFirstAndLowerLanesAreBudgeted) {
+    RegionAllocator allocator;
+    DispatchLanes lanes;
+
+    const size_t syncBudget = DispatchLanes::Budgets[DispatchLanes::Sync];
+
+    for (size_t i = 0; i < syncBudget + 2; ++i) {
+        ASSERT_TRUE(lanes.push(makePacket(allocator, MsgTypes::BlockRequest)));
+    }
+
+    ASSERT_TRUE(lanes.push(makePacket(allocator, MsgTypes::TransactionPacket)));
+    ASSERT_TRUE(lanes.push(makePacket(allocator, MsgTypes::RoundTable)));
+    ASSERT_TRUE(lanes.push(makePacket(allocator, MsgTypes::FirstStage)));
+
+    ASSERT_EQ(lanes.stats(DispatchLanes::Sync).depth, syncBudget + 2);
+
+    std::vector<MsgTypes> dispatched;
+    auto handler = [&dispatched](const DispatchLanes::Item& item) { dispatched.push_back(item.packet.getType()); };
+
+    lanes.dispatch(handler);
+
+    ASSERT_EQ(dispatched.size(), syncBudget + 3);
+    ASSERT_EQ(dispatched[0], MsgTypes::FirstStage);
+    ASSERT_EQ(dispatched[1], MsgTypes::RoundTable);
+    ASSERT_EQ(dispatched[2], MsgTypes::TransactionPacket);
+    ASSERT_FALSE(lanes.isEmpty());
+
+    // consensus message pushed later still goes before the rest of sync lane
+    ASSERT_TRUE(lanes.push(makePacket(allocator, MsgTypes::SecondStage)));
+    dispatched.clear();
+    lanes.dispatch(handler);
+
+    ASSERT_EQ(dispatched.size(), 3u);
+    ASSERT_EQ(dispatched[0], MsgTypes::SecondStage);
+    ASSERT_TRUE(lanes.isEmpty());
+
+    const auto stats = lanes.stats(DispatchLanes::Sync);
+    ASSERT_EQ(stats.depth, 0u);
+    ASSERT_EQ(stats.bytes, 0u);
+    ASSERT_EQ(stats.maxDepth, syncBudget + 2);
+    ASSERT_EQ(stats.dispatched, syncBudget + 2);
+}
+
+TEST(DispatchLanes, FullLanesDropTransactionsForConsensus) {
+    RegionAllocator allocator;
+    DispatchLanes lanes;
+
+    for (size_t i = 0; i < DispatchLanes::MaxDepth; ++i) {
+        ASSERT_TRUE(lanes.push(makePacket(allocator, MsgTypes::TransactionPacket)));
+    }
+
+    // the oldest transaction packet gives its place away
+    ASSERT_TRUE(lanes.push(makePacket(allocator, MsgTypes::FirstStage)));
+    ASSERT_EQ(lanes.stats(DispatchLanes::Transactions).dropped, 1u);
+    ASSERT_EQ(lanes.stats(DispatchLanes::Transactions).depth, DispatchLanes::MaxDepth - 1);
+    ASSERT_EQ(lanes.stats(DispatchLanes::Consensus).depth, 1u);
+
+    // misc message does not push out transactions, it is dropped itself
+    ASSERT_TRUE(lanes.push(makePacket(allocator, MsgTypes::NodeStopRequest)));
+    ASSERT_EQ(lanes.stats(DispatchLanes::Misc).dropped, 1u);
+    ASSERT_EQ(lanes.stats(DispatchLanes::Misc).depth, 0u);
+}
+
+TEST(DispatchLanes, ConsensusIsNeverDropped) {
+    RegionAllocator allocator;
+    DispatchLanes lanes;
+
+    for (size_t i = 0; i < DispatchLanes::MaxDepth; ++i) {
+        ASSERT_TRUE(lanes.push(makePacket(allocator, MsgTypes::FirstStage)));
+    }
+
+    // nothing may be dropped, caller has to dispatch first
+    ASSERT_FALSE(lanes.push(makePacket(allocator, MsgTypes::SecondStage)));
+    ASSERT_FALSE(lanes.push(makePacket(allocator, MsgTypes::RoundTable)));
+    ASSERT_EQ(lanes.stats(DispatchLanes::Consensus).dropped, 0u);
+
+    size_t dispatched = 0;
+    lanes.dispatch([&dispatched](const DispatchLanes::Item&) { ++dispatched; });
+
+    ASSERT_EQ(dispatched, DispatchLanes::MaxDepth);
+    ASSERT_TRUE(lanes.push(makePacket(allocator, MsgTypes::SecondStage)));
+}
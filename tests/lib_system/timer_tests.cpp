@@ -2,9 +2,14 @@
 
 #include <string>
 #include <atomic>
+#include <mutex>
+#include <thread>
+#include <vector>
 
 #include <lib/system/timer.hpp>
+#include <lib/system/timerservice.hpp>
 #include <lib/system/console.hpp>
+#include <lib/system/structures.hpp>
 
 TEST(Timer, BaseTimerUsage) {
     static std::atomic<bool> isCalled = false;
@@ -119,3 +124,69 @@ TEST(Timer, HighPreciseTimerUsage) {
     ASSERT_EQ(expectedCalls, counter);
     ASSERT_EQ(isFailed, false);
 }
+
+TEST(TimerService, CallsInDeadlineOrder) {
+    cs::TimerService service;
+    std::mutex mutex;
+    std::vector<int> calls;
+    std::atomic<size_t> count = 0;
+
+    const auto start = std::chrono::steady_clock::now();
+    std::vector<std::chrono::milliseconds> elapsed(4);
+
+    // the last ones are placed to the second wheel
+    const std::vector<int> delays = {700, 5, 300, 60};
+
+    for (size_t i = 0; i < delays.size(); ++i) {
+        service.scheduleOnce(std::chrono::milliseconds(delays[i]), cs::TimerService::Executor::TimerThread, [&, i] {
+            std::lock_guard<std::mutex> lock(mutex);
+            elapsed[i] = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+            calls.push_back(delays[i]);
+            ++count;
+        });
+    }
+
+    const auto cancelled = service.scheduleOnce(std::chrono::milliseconds(100), cs::TimerService::Executor::TimerThread, [&] { ++count; });
+    ASSERT_TRUE(service.cancel(cancelled));
+    ASSERT_FALSE(service.cancel(cancelled));
+
+    while (count != delays.size()) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+    ASSERT_EQ(calls, (std::vector<int>{5, 60, 300, 700}));
+
+    for (size_t i = 0; i < delays.size(); ++i) {
+        ASSERT_GE(elapsed[i].count(), delays[i]);
+    }
+
+    ASSERT_EQ(service.size(), 0u);
+}
+
+TEST(TimerService, PeriodicCallsGoToCallsQueue) {
+    cs::TimerService service;
+    size_t count = 0;
+
+    const auto id = service.schedule(std::chrono::milliseconds(10), std::chrono::milliseconds(10), cs::TimerService::Executor::CallsQueue, [&] { ++count; });
+
+    // previous call is not taken from CallsQueue yet, so the next ones are skipped
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    ASSERT_GT(service.skippedCalls(), 0u);
+
+    CallsQueue::instance().callAll();
+    ASSERT_EQ(count, 1u);
+
+    while (count < 5) {
+        CallsQueue::instance().callAll();
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    ASSERT_TRUE(service.isScheduled(id));
+    ASSERT_TRUE(service.cancel(id));
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(30));
+    CallsQueue::instance().callAll();
+
+    ASSERT_EQ(count, 5u);
+}
@@ -0,0 +1,213 @@
+#ifdef __linux__
+
+#include <atomic>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+#include <sys/socket.h>
+#include <time.h>
+
+#include <boost/asio.hpp>
+
+#include <net/pacmans.hpp>
+
+#include "gtest/gtest.h"
+
+namespace {
+constexpr size_t kDatagrams = 500000;
+constexpr size_t kDatagramSize = 512;
+constexpr size_t kBatchSize = 32;
+
+struct Flood {
+    boost::asio::io_context context;
+    ip::udp::socket receiver{context, ip::udp::endpoint(ip::address_v4::loopback(), 0)};
+    ip::udp::socket sender{context, ip::udp::endpoint(ip::address_v4::loopback(), 0)};
+
+    Flood() {
+        receiver.set_option(ip::udp::socket::receive_buffer_size(1 << 23));
+
+        // reader finishes when flood is over
+        timeval timeout{0, 200000};
+        setsockopt(receiver.native_handle(), SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+    }
+
+    void send() {
+        std::vector<char> data(kDatagramSize, 'x');
+        auto target = receiver.local_endpoint();
+
+        iovec iov{data.data(), data.size()};
+        std::vector<mmsghdr> messages(kBatchSize);
+
+        for (auto& message : messages) {
+            message.msg_hdr.msg_iov = &iov;
+            message.msg_hdr.msg_iovlen = 1;
+            message.msg_hdr.msg_name = target.data();
+            message.msg_hdr.msg_namelen = static_cast<socklen_t>(target.size());
+        }
+
+        for (size_t sent = 0; sent < kDatagrams;) {
+            const int count = sendmmsg(sender.native_handle(), messages.data(), kBatchSize, 0);
+            sent += count > 0 ? static_cast<size_t>(count) : 0;
+        }
+    }
+};
+
+double threadCpuSeconds() {
+    timespec time{};
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &time);
+    return static_cast<double>(time.tv_sec) + static_cast<double>(time.tv_nsec) / 1e9;
+}
+
+// drains IPacMan like network processor does, returns received count
+template <typename Reader>
+size_t measure(const char* name, Reader&& reader) {
+    Flood flood;
+    IPacMan pacman;
+
+    std::atomic<size_t> enqueued = {0};
+    std::atomic<bool> stop = {false};
+
+    std::thread processor([&] {
+        size_t processed = 0;
+
+        while (!stop.load() || processed < enqueued.load()) {
+            if (processed == enqueued.load()) {
+                std::this_thread::yield();
+                continue;
+            }
+
+            auto task = pacman.getNextTask();
+            task.release();
+            ++processed;
+        }
+    });
+
+    std::thread sender([&] { flood.send(); });
+
+    // flood sender is slower than reader, so reader cpu time is measured instead of wall time
+    const auto start = threadCpuSeconds();
+    reader(flood.receiver, pacman, enqueued);
+    const auto seconds = threadCpuSeconds() - start;
+
+    sender.join();
+    stop.store(true);
+    processor.join();
+
+    const auto received = enqueued.load();
+
+    std::cout << name << ": " << received << " datagrams, " << static_cast<size_t>(static_cast<double>(received) / seconds) << " packets/s per reader core" << std::endl;
+    return received;
+}
+}  // namespace
+
+// packets per second of one reader core, receive_from per datagram against recvmmsg batches
+TEST(udp_receive, DISABLED_loopback_flood) {
+    auto single = measure("receive_from", [](ip::udp::socket& sock, IPacMan& pacman, std::atomic<size_t>& enqueued) {
+        while (true) {
+            auto& task = pacman.allocNext();
+
+            // asio waits forever on receive timeout, so plain recvfrom is used like recvmmsg below
+            socklen_t length = static_cast<socklen_t>(task.sender.capacity());
+            const auto received = recvfrom(sock.native_handle(), task.pack.data(), Packet::MaxSize, 0, task.sender.data(), &length);
+
+            if (received <= 0) {
+                pacman.rejectLast();
+                break;
+            }
+
+            task.sender.resize(length);
+            task.size = static_cast<size_t>(received);
+
+            pacman.enQueueLast();
+            enqueued.fetch_add(1);
+        }
+    });
+
+    auto batched = measure("recvmmsg", [](ip::udp::socket& sock, IPacMan& pacman, std::atomic<size_t>& enqueued) {
+        std::vector<mmsghdr> messages(kBatchSize);
+        std::vector<iovec> iovecs(kBatchSize);
+        std::vector<bool> accepted(kBatchSize);
+
+        while (true) {
+            pacman.allocBatch(kBatchSize);
+
+            for (size_t i = 0; i < kBatchSize; ++i) {
+                auto& task = pacman.batchTask(i);
+
+                iovecs[i].iov_base = task.pack.data();
+                iovecs[i].iov_len = Packet::MaxSize;
+
+                messages[i] = mmsghdr{};
+                messages[i].msg_hdr.msg_iov = &iovecs[i];
+                messages[i].msg_hdr.msg_iovlen = 1;
+                messages[i].msg_hdr.msg_name = task.sender.data();
+                messages[i].msg_hdr.msg_namelen = static_cast<socklen_t>(task.sender.capacity());
+            }
+
+            const int received = recvmmsg(sock.native_handle(), messages.data(), kBatchSize, MSG_WAITFORONE, nullptr);
+
+            if (received <= 0) {
+                break;
+            }
+
+            for (size_t i = 0; i < kBatchSize; ++i) {
+                accepted[i] = i < static_cast<size_t>(received);
+
+                if (accepted[i]) {
+                    pacman.batchTask(i).size = messages[i].msg_len;
+                }
+            }
+
+            enqueued.fetch_add(pacman.enQueueBatch(accepted));
+        }
+    });
+
+    ASSERT_GT(single, 0);
+    ASSERT_GT(batched, 0);
+}
+
+TEST(udp_receive, batch_keeps_order_of_accepted) {
+    IPacMan pacman;
+    std::vector<bool> accepted = {true, false, true, false};
+
+    pacman.allocBatch(accepted.size());
+
+    for (size_t i = 0; i < accepted.size(); ++i) {
+        auto& task = pacman.batchTask(i);
+        task.size = i + 1;
+        *static_cast<char*>(task.pack.data()) = static_cast<char>(i);
+    }
+
+    ASSERT_EQ(pacman.enQueueBatch(accepted), 2);
+
+    for (char expected : {0, 2}) {
+        auto task = pacman.getNextTask();
+        ASSERT_EQ(*static_cast<const char*>(task->pack.data()), expected);
+        ASSERT_EQ(task->size, static_cast<size_t>(expected + 1));
+        task.release();
+    }
+
+    // rejected slots are the first slots of the next batch
+    pacman.allocBatch(1);
+    pacman.batchTask(0).size = 10;
+    ASSERT_EQ(pacman.enQueueBatch({true}), 1);
+
+    auto task = pacman.getNextTask();
+    ASSERT_EQ(task->size, 10);
+    task.release();
+}
+
+TEST(udp_receive, slots_have_configured_packet_size) {
+    IPacMan pacman(Packet::MaxConfigurableSize);
+    ASSERT_EQ(pacman.packetSize(), Packet::MaxConfigurableSize);
+
+    auto& task = pacman.allocNext();
+    ASSERT_EQ(task.pack.size(), Packet::MaxConfigurableSize);
+    pacman.rejectLast();
+
+    ASSERT_EQ(Packet::validSize(0), Packet::MaxSize);
+    ASSERT_EQ(Packet::validSize(1 << 20), Packet::MaxConfigurableSize);
+}
+
+#endif